@@ -0,0 +1,69 @@
+#include "bench_fixtures.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+double bench_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+int bench_compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+void bench_report(const char *name, double *samples, int count, const char *unit) {
+    if (count == 0) {
+        printf("%-26s no samples\n", name);
+        return;
+    }
+    double total = 0;
+    for (int i = 0; i < count; i++) total += samples[i];
+    qsort(samples, count, sizeof(double), bench_compare_double);
+    printf("%-26s n=%-5d avg=%8.3f %s  min=%8.3f %s  p50=%8.3f %s  p95=%8.3f %s  worst=%8.3f %s\n", name, count,
+           total / count, unit, samples[0], unit, samples[count / 2], unit, samples[(count * 95) / 100], unit,
+           samples[count - 1], unit);
+}
+
+char *bench_read_file(const char *path, size_t *size) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    long len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *data = len > 0 ? malloc(len + 1) : NULL;
+    if (data && fread(data, 1, len, fp) != (size_t)len) {
+        free(data);
+        data = NULL;
+    }
+    fclose(fp);
+    if (data) data[len] = '\0';
+    *size = data ? (size_t)len : 0;
+    return data;
+}
+
+// Builds a response shaped like the real /project-summaries output.
+char *bench_generate_project_list(int projects, size_t *size) {
+    size_t cap = (size_t)projects * 1024 + 16;
+    char *json = malloc(cap);
+    if (!json) return NULL;
+    size_t len = 0;
+    json[len++] = '[';
+    for (int i = 0; i < projects; i++) {
+        len += snprintf(json + len, cap - len,
+            "%s{\"name\":\"Project %d\",\"slug\":\"project_%d\","
+            "\"description\":\"A synthetic project used to benchmark parsing, number %d, with some \\\"escaped\\\" text\","
+            "\"project_url\":\"https://github.com/example/project_%d\",\"revision\":%d,"
+            "\"categories\":[\"Games\",\"Utility\"],\"badges\":[\"why2025\"],"
+            "\"published_at\":\"2025-07-%02dT12:00:00.000Z\",\"installs\":%d,"
+            "\"icon_map\":{\"16x16\":{\"url\":\"https://badgehub.p1m.nl/files/%d/icon16.png\"},"
+            "\"64x64\":{\"url\":\"https://badgehub.p1m.nl/files/%d/icon64.png\",\"size\":4096}}}",
+            i ? "," : "", i, i, i, i, i % 17, i % 28 + 1, i * 3, i, i);
+    }
+    json[len++] = ']';
+    json[len] = '\0';
+    *size = len;
+    return json;
+}
@@ -0,0 +1,36 @@
+#ifndef BENCH_FIXTURES_H
+#define BENCH_FIXTURES_H
+
+#include <stddef.h>
+
+/**
+ * @brief Returns a monotonic timestamp in milliseconds.
+ */
+double bench_now_ms(void);
+
+/**
+ * @brief qsort() comparator for doubles, in ascending order.
+ */
+int bench_compare_double(const void *a, const void *b);
+
+/**
+ * @brief Prints the count, average, minimum, median, 95th percentile and worst of
+ * a set of samples.
+ * Sorts samples in place.
+ *
+ * @param unit Printed after each value, e.g. "ms".
+ */
+void bench_report(const char *name, double *samples, int count, const char *unit);
+
+/**
+ * @brief Reads a whole file into a NUL terminated buffer. Free with free().
+ */
+char *bench_read_file(const char *path, size_t *size);
+
+/**
+ * @brief Builds a /project-summaries response with the given number of projects,
+ * shaped like the real BadgeHub output. Free with free().
+ */
+char *bench_generate_project_list(int projects, size_t *size);
+
+#endif // BENCH_FIXTURES_H
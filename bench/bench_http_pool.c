@@ -0,0 +1,74 @@
+// Measures per-request latency of the old "fresh handle per call" pattern
+// against the pooled, shared-cache handles from http_pool.c.
+//
+// Usage: bench_http_pool <url> [iterations]
+// Point it at a local mock server, e.g. http://127.0.0.1:8000/project-summaries
+#include "bench_fixtures.h"
+#include "http_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DEFAULT_ITERATIONS 50
+
+static size_t discard_cb(void *ptr, size_t size, size_t nmemb, void *userp) {
+    (void)ptr;
+    (void)userp;
+    return size * nmemb;
+}
+
+// The request pattern badgehub_client.c used before the pool existed.
+static bool request_cold(const char *url) {
+    curl_global_init(CURL_GLOBAL_ALL);
+    CURL *handle = curl_easy_init();
+    if (!handle) return false;
+    curl_easy_setopt(handle, CURLOPT_URL, url);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, discard_cb);
+    CURLcode res = curl_easy_perform(handle);
+    curl_easy_cleanup(handle);
+    curl_global_cleanup();
+    return res == CURLE_OK;
+}
+
+static bool request_pooled(const char *url) {
+    CURL *handle = http_pool_acquire();
+    if (!handle) return false;
+    curl_easy_setopt(handle, CURLOPT_URL, url);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, discard_cb);
+    CURLcode res = curl_easy_perform(handle);
+    http_pool_release(handle);
+    return res == CURLE_OK;
+}
+
+static bool run(const char *name, bool (*request)(const char *), const char *url, int iterations) {
+    double *samples = calloc(iterations, sizeof(double));
+    if (!samples) return false;
+    for (int i = 0; i < iterations; i++) {
+        double start = bench_now_ms();
+        if (!request(url)) {
+            fprintf(stderr, "%s: request %d to %s failed\n", name, i, url);
+            free(samples);
+            return false;
+        }
+        samples[i] = bench_now_ms() - start;
+    }
+    bench_report(name, samples, iterations, "ms");
+    free(samples);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <url> [iterations]\n", argv[0]);
+        return 1;
+    }
+    const char *url = argv[1];
+    int iterations = argc > 2 ? atoi(argv[2]) : DEFAULT_ITERATIONS;
+    if (iterations < 1) iterations = DEFAULT_ITERATIONS;
+
+    if (!run("cold", request_cold, url, iterations)) return 1;
+
+    if (!http_pool_init(HTTP_POOL_DEFAULT_SIZE)) return 1;
+    bool ok = run("pooled", request_pooled, url, iterations);
+    http_pool_cleanup();
+    return ok ? 0 : 1;
+}
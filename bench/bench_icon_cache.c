@@ -0,0 +1,114 @@
+// Measures frame time while scrolling a list of iconed cards, once with the
+// icons as raw PNG sources (decoded on every draw, as LV_CACHE_DEF_SIZE is 0)
+// and once with icons decoded once by icon_cache.c.
+//
+// Usage: bench_icon_cache <icon.png> [cards] [frames]
+#include "bench_fixtures.h"
+#include "icon_cache.h"
+#include "lvgl/lvgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DISPLAY_WIDTH 720
+#define DISPLAY_HEIGHT 720
+#define DEFAULT_CARDS 50
+#define DEFAULT_FRAMES 300
+#define SCROLL_STEP 12
+
+static uint8_t s_frame_buffer[DISPLAY_WIDTH * DISPLAY_HEIGHT * 4];
+
+static uint32_t tick_get_cb(void) {
+    return (uint32_t)bench_now_ms();
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    lv_display_flush_ready(disp);
+}
+
+static uint8_t *read_file(const char *path, size_t *size) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    long len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *data = len > 0 ? malloc(len) : NULL;
+    if (data && fread(data, 1, len, fp) != (size_t)len) {
+        free(data);
+        data = NULL;
+    }
+    fclose(fp);
+    *size = data ? (size_t)len : 0;
+    return data;
+}
+
+static void run(const char *name, const void *icon_src, lv_display_t *disp, int cards, int frames) {
+    lv_obj_t *list = lv_obj_create(lv_screen_active());
+    lv_obj_set_size(list, lv_pct(100), lv_pct(100));
+    lv_obj_set_flex_flow(list, LV_FLEX_FLOW_COLUMN);
+    for (int i = 0; i < cards; i++) {
+        lv_obj_t *card = lv_obj_create(list);
+        lv_obj_set_size(card, lv_pct(95), 80);
+        lv_obj_set_flex_flow(card, LV_FLEX_FLOW_ROW);
+        lv_obj_t *icon = lv_image_create(card);
+        lv_image_set_src(icon, icon_src);
+        lv_obj_set_size(icon, 64, 64);
+        lv_obj_t *label = lv_label_create(card);
+        lv_label_set_text_fmt(label, "Card %d", i);
+    }
+    lv_refr_now(disp);
+
+    double total = 0, worst = 0;
+    for (int frame = 0; frame < frames; frame++) {
+        double start = bench_now_ms();
+        lv_obj_scroll_by(list, 0, (frame / 100) % 2 ? SCROLL_STEP : -SCROLL_STEP, LV_ANIM_OFF);
+        lv_refr_now(disp);
+        double elapsed = bench_now_ms() - start;
+        total += elapsed;
+        if (elapsed > worst) worst = elapsed;
+    }
+    printf("%-10s cards=%d frames=%d avg=%7.3f ms/frame  worst=%7.3f ms\n", name, cards, frames, total / frames, worst);
+    lv_obj_del(list);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <icon.png> [cards] [frames]\n", argv[0]);
+        return 1;
+    }
+    int cards = argc > 2 ? atoi(argv[2]) : DEFAULT_CARDS;
+    int frames = argc > 3 ? atoi(argv[3]) : DEFAULT_FRAMES;
+    if (cards < 1) cards = DEFAULT_CARDS;
+    if (frames < 1) frames = DEFAULT_FRAMES;
+
+    size_t png_size = 0;
+    uint8_t *png = read_file(argv[1], &png_size);
+    if (!png) {
+        fprintf(stderr, "Could not read %s\n", argv[1]);
+        return 1;
+    }
+
+    lv_init();
+    lv_tick_set_cb(tick_get_cb);
+    lv_display_t *disp = lv_display_create(DISPLAY_WIDTH, DISPLAY_HEIGHT);
+    lv_display_set_buffers(disp, s_frame_buffer, NULL, sizeof(s_frame_buffer), LV_DISPLAY_RENDER_MODE_FULL);
+    lv_display_set_flush_cb(disp, flush_cb);
+
+    lv_image_dsc_t raw_dsc = {0};
+    raw_dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    raw_dsc.header.cf = LV_COLOR_FORMAT_RAW;
+    raw_dsc.data = png;
+    raw_dsc.data_size = png_size;
+    run("raw png", &raw_dsc, disp, cards, frames);
+
+    icon_cache_init(ICON_CACHE_DEFAULT_BUDGET);
+    const lv_draw_buf_t *decoded = icon_cache_insert(argv[1], png, png_size);
+    if (!decoded) {
+        fprintf(stderr, "Could not decode %s\n", argv[1]);
+        return 1;
+    }
+    run("cached", decoded, disp, cards, frames);
+    icon_cache_release(decoded);
+    icon_cache_deinit();
+    free(png);
+    return 0;
+}
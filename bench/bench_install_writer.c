@@ -0,0 +1,191 @@
+// Compares how an install's files reach the filesystem: the old path (the
+// parent directories of every file created component by component, then stdio
+// writes of each chunk curl delivers) with file_writer.c (one directory cache
+// per install, 128 KiB aligned buffers and files preallocated from
+// Content-Length). Reports the write and mkdir system calls and the bytes
+// written per install.
+//
+// The install is synthetic: a project tree of nested directories holding many
+// small source files and a few large assets, fed in curl-sized chunks. Runs in a
+// fresh temporary directory. Write calls and bytes are read from /proc/self/io
+// where available, so both paths are measured the same way.
+//
+// Usage: bench_install_writer [files] [installs] [chunk_size]
+#include "bench_fixtures.h"
+#include "file_writer.h"
+#include "utils.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DEFAULT_FILES 200
+#define DEFAULT_INSTALLS 5
+#define DEFAULT_CHUNK_SIZE 16384 // CURL_MAX_WRITE_SIZE
+#define LARGE_FILE_EVERY 25      // One asset of LARGE_FILE_SIZE per this many files
+#define LARGE_FILE_SIZE (768 * 1024)
+
+typedef struct {
+    char path[128];
+    size_t size;
+} bench_file_t;
+
+typedef struct {
+    uint64_t write_calls;
+    uint64_t bytes_written;
+    uint64_t mkdir_calls;
+    double ms;
+} bench_result_t;
+
+// Reads the process's write syscall and byte counters; false where /proc/self/io is missing.
+static bool read_io_counters(uint64_t *syscw, uint64_t *wchar) {
+    FILE *fp = fopen("/proc/self/io", "r");
+    if (!fp) return false;
+    char line[128];
+    int found = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (sscanf(line, "syscw: %" SCNu64, syscw) == 1 || sscanf(line, "wchar: %" SCNu64, wchar) == 1) found++;
+    }
+    fclose(fp);
+    return found == 2;
+}
+
+static void make_files(bench_file_t *files, int count) {
+    for (int i = 0; i < count; i++) {
+        if (i % LARGE_FILE_EVERY == LARGE_FILE_EVERY - 1) {
+            snprintf(files[i].path, sizeof(files[i].path), "assets/sprites/sheet_%03d.bin", i);
+            files[i].size = LARGE_FILE_SIZE;
+        } else {
+            snprintf(files[i].path, sizeof(files[i].path), "lib/pkg_%02d/sub_%d/module_%03d.py", i / 16, i % 3, i);
+            files[i].size = 512 + (size_t)(i * 7919) % (12 * 1024);
+        }
+    }
+}
+
+static int count_slashes(const char *path) {
+    int count = 0;
+    for (; *path; path++) count += *path == '/';
+    return count;
+}
+
+// The old path: ensure_dir_exists() and a stdio stream per file.
+static bool install_legacy(const char *root, const bench_file_t *files, int count, const uint8_t *data,
+                           size_t chunk_size, uint64_t *mkdir_calls) {
+    char path[512];
+    for (int i = 0; i < count; i++) {
+        snprintf(path, sizeof(path), "%s/%s", root, files[i].path);
+        ensure_dir_exists(path);
+        *mkdir_calls += count_slashes(path); // One mkdir per path component
+        FILE *fp = fopen(path, "wb");
+        if (!fp) return false;
+        for (size_t done = 0; done < files[i].size; done += chunk_size) {
+            size_t n = files[i].size - done < chunk_size ? files[i].size - done : chunk_size;
+            fwrite(data, 1, n, fp);
+        }
+        if (fclose(fp) != 0) return false;
+    }
+    return true;
+}
+
+static bool install_writer(const char *root, const bench_file_t *files, int count, const uint8_t *data,
+                           size_t chunk_size, file_writer_stats_t *stats) {
+    dir_cache_t *dirs = dir_cache_create(stats);
+    if (!dirs) return false;
+    char path[512];
+    bool ok = true;
+    for (int i = 0; ok && i < count; i++) {
+        snprintf(path, sizeof(path), "%s/%s", root, files[i].path);
+        file_writer_t writer;
+        ok = dir_cache_ensure_parent(dirs, path) && file_writer_open(&writer, path, 0, stats);
+        if (!ok) break;
+        file_writer_preallocate(&writer, files[i].size);
+        for (size_t done = 0; ok && done < files[i].size; done += chunk_size) {
+            size_t n = files[i].size - done < chunk_size ? files[i].size - done : chunk_size;
+            ok = file_writer_write(&writer, data, n);
+        }
+        ok = file_writer_close(&writer) && ok;
+    }
+    dir_cache_destroy(dirs);
+    return ok;
+}
+
+static void print_result(const char *name, const bench_result_t *result, int installs, bool have_proc) {
+    printf("  %-12s %10.1f write calls %12.0f bytes %8.1f mkdir calls %8.2f ms%s\n", name,
+           (double)result->write_calls / installs, (double)result->bytes_written / installs,
+           (double)result->mkdir_calls / installs, result->ms / installs,
+           have_proc ? "" : "  (write calls counted by file_writer only)");
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : DEFAULT_FILES;
+    int installs = argc > 2 ? atoi(argv[2]) : DEFAULT_INSTALLS;
+    size_t chunk_size = argc > 3 ? (size_t)atol(argv[3]) : DEFAULT_CHUNK_SIZE;
+    if (count < 1) count = DEFAULT_FILES;
+    if (installs < 1) installs = DEFAULT_INSTALLS;
+    if (chunk_size == 0) chunk_size = DEFAULT_CHUNK_SIZE;
+
+    char work_dir[] = "/tmp/bench_install_writer.XXXXXX";
+    bench_file_t *files = calloc(count, sizeof(bench_file_t));
+    uint8_t *data = malloc(chunk_size);
+    // Paths stay relative to the work directory, like INSTALLATION_DIR's.
+    if (!files || !data || !mkdtemp(work_dir) || chdir(work_dir) != 0) {
+        fprintf(stderr, "Setup failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < chunk_size; i++) data[i] = (uint8_t)(i * 31 + 7);
+    make_files(files, count);
+    uint64_t total = 0;
+    for (int i = 0; i < count; i++) total += files[i].size;
+    printf("%d installs of %d files, %" PRIu64 " bytes each, in %zu byte chunks\n", installs, count, total, chunk_size);
+
+    bench_result_t legacy = { 0 };
+    bench_result_t writer = { 0 };
+    file_writer_stats_t stats = { 0 };
+    uint64_t syscw_before = 0, wchar_before = 0, syscw_after = 0, wchar_after = 0;
+    bool have_proc = read_io_counters(&syscw_before, &wchar_before);
+    bool ok = true;
+    char root[32];
+
+    for (int run = 0; ok && run < installs; run++) {
+        snprintf(root, sizeof(root), "legacy-%d", run);
+        read_io_counters(&syscw_before, &wchar_before);
+        double start = bench_now_ms();
+        ok = install_legacy(root, files, count, data, chunk_size, &legacy.mkdir_calls);
+        legacy.ms += bench_now_ms() - start;
+        read_io_counters(&syscw_after, &wchar_after);
+        legacy.write_calls += syscw_after - syscw_before;
+        legacy.bytes_written += wchar_after - wchar_before;
+        remove_tree(root);
+    }
+    for (int run = 0; ok && run < installs; run++) {
+        snprintf(root, sizeof(root), "writer-%d", run);
+        read_io_counters(&syscw_before, &wchar_before);
+        double start = bench_now_ms();
+        ok = install_writer(root, files, count, data, chunk_size, &stats);
+        writer.ms += bench_now_ms() - start;
+        read_io_counters(&syscw_after, &wchar_after);
+        writer.write_calls += have_proc ? syscw_after - syscw_before : 0;
+        writer.bytes_written += have_proc ? wchar_after - wchar_before : 0;
+        remove_tree(root);
+    }
+    if (!have_proc) {
+        writer.write_calls = stats.write_calls;
+        writer.bytes_written = stats.bytes_written;
+    }
+    writer.mkdir_calls = stats.mkdir_calls;
+    if (chdir("/") == 0) remove_tree(work_dir);
+    file_writer_pool_clear();
+    if (!ok) {
+        fprintf(stderr, "Install failed\n");
+        return 1;
+    }
+
+    printf("per install:\n");
+    if (have_proc) print_result("stdio", &legacy, installs, have_proc);
+    print_result("file_writer", &writer, installs, have_proc);
+    printf("  preallocated %.0f bytes per install\n", (double)stats.preallocated_bytes / installs);
+    free(files);
+    free(data);
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Compares the old way of handling a /project-summaries response (buffer the
+// whole body, cJSON_Parse, copy every field) with the streaming parser from
+// project_parser.c. Each mode runs in its own process so peak RSS is measured
+// independently.
+//
+// Usage: bench_json_stream [response.json] [iterations]
+// Without a file, a synthetic response with 1000 projects is generated.
+#include "badgehub_client.h"
+#include "bench_fixtures.h"
+#include "project_parser.h"
+#include "response_buffer.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define DEFAULT_ITERATIONS 20
+#define SYNTHETIC_PROJECTS 1000
+#define CHUNK_SIZE CURL_MAX_WRITE_SIZE // What curl hands the write callback at most
+
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+static void free_cjson_projects(project_t *projects, int count) {
+    for (int i = 0; i < count; i++) {
+        free(projects[i].name);
+        free(projects[i].slug);
+        free(projects[i].description);
+        free(projects[i].project_url);
+        free(projects[i].icon_url);
+    }
+    free(projects);
+}
+
+static size_t run_cjson(const char *json, size_t size) {
+    response_buffer_t *body = response_buffer_acquire(0);
+    for (size_t off = 0; off < size; off += CHUNK_SIZE) {
+        size_t n = size - off < CHUNK_SIZE ? size - off : CHUNK_SIZE;
+        response_buffer_write_cb((void *)(json + off), 1, n, body);
+    }
+    int count = 0;
+    cJSON *root = cJSON_Parse(body->data);
+    project_t *projects = NULL;
+    if (cJSON_IsArray(root)) {
+        count = cJSON_GetArraySize(root);
+        projects = calloc(count, sizeof(project_t));
+        cJSON *proj_json = NULL;
+        int i = 0;
+        cJSON_ArrayForEach(proj_json, root) {
+            projects[i].name = get_json_string(proj_json, "name");
+            projects[i].slug = get_json_string(proj_json, "slug");
+            projects[i].description = get_json_string(proj_json, "description");
+            projects[i].project_url = get_json_string(proj_json, "project_url");
+            cJSON *icon_map = cJSON_GetObjectItemCaseSensitive(proj_json, "icon_map");
+            cJSON *icon_64_obj = cJSON_GetObjectItemCaseSensitive(icon_map, "64x64");
+            projects[i].icon_url = get_json_string(icon_64_obj, "url");
+            cJSON *revision_item = cJSON_GetObjectItemCaseSensitive(proj_json, "revision");
+            projects[i].revision = cJSON_IsNumber(revision_item) ? revision_item->valueint : 0;
+            i++;
+        }
+    }
+    cJSON_Delete(root);
+    response_buffer_release(body);
+    free_cjson_projects(projects, count);
+    return count;
+}
+
+static size_t run_stream(const char *json, size_t size) {
+    project_list_parser_t *parser = project_list_parser_create();
+    for (size_t off = 0; off < size; off += CHUNK_SIZE) {
+        size_t n = size - off < CHUNK_SIZE ? size - off : CHUNK_SIZE;
+        project_list_parser_write_cb((void *)(json + off), 1, n, parser);
+    }
+    int count = 0;
+    project_t *projects = project_list_parser_finish(parser, &count);
+    free_applications(projects, count);
+    return count;
+}
+
+static void run(const char *name, size_t (*parse)(const char *, size_t), const char *json, size_t size, int iterations) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) return;
+    if (pid > 0) {
+        waitpid(pid, NULL, 0);
+        return;
+    }
+    long baseline = peak_rss_kb();
+    size_t count = 0;
+    double start = bench_now_ms();
+    for (int i = 0; i < iterations; i++) count = parse(json, size);
+    double elapsed = bench_now_ms() - start;
+    printf("%-7s projects=%zu avg=%8.3f ms  throughput=%7.1f MB/s  peak RSS +%ld KiB\n",
+           name, count, elapsed / iterations, (double)size * iterations / (elapsed / 1000.0) / (1024 * 1024),
+           peak_rss_kb() - baseline);
+    fflush(stdout);
+    _exit(0);
+}
+
+int main(int argc, char **argv) {
+    size_t size = 0;
+    char *json = argc > 1 ? bench_read_file(argv[1], &size) : bench_generate_project_list(SYNTHETIC_PROJECTS, &size);
+    if (!json) {
+        fprintf(stderr, "Usage: %s [response.json] [iterations]\n", argv[0]);
+        return 1;
+    }
+    int iterations = argc > 2 ? atoi(argv[2]) : DEFAULT_ITERATIONS;
+    if (iterations < 1) iterations = DEFAULT_ITERATIONS;
+    printf("response: %zu bytes\n", size);
+
+    run("cjson", run_cjson, json, size, iterations);
+    run("stream", run_stream, json, size, iterations);
+    free(json);
+    return 0;
+}
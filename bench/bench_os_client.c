@@ -0,0 +1,124 @@
+// Compares answering "what is installed, and at which revision" by walking
+// installation_dir and parsing every app's install manifest with the
+// installed-apps index from os_client.c: cold start (loading the index file),
+// lookups by slug and a full enumeration.
+//
+// Runs in a fresh temporary directory, where it creates the apps' manifests.
+//
+// Usage: bench_os_client [apps] [files_per_app]
+#include "bench_fixtures.h"
+#include "badgehub_client.h"
+#include "install_manifest.h"
+#include "os_client.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DEFAULT_APPS 1000
+#define DEFAULT_FILES_PER_APP 20
+#define LOOKUPS 1000000
+
+static bool create_apps(int apps, int files_per_app) {
+    install_manifest_entry_t *entries = calloc(files_per_app, sizeof(install_manifest_entry_t));
+    char (*paths)[32] = calloc(files_per_app, sizeof(*paths));
+    if (!entries || !paths) return false;
+    mkdir(INSTALLATION_DIR, 0755);
+    bool ok = true;
+    for (int a = 0; ok && a < apps; a++) {
+        char app_dir[256];
+        snprintf(app_dir, sizeof(app_dir), "%s/app-%04d", INSTALLATION_DIR, a);
+        mkdir(app_dir, 0755);
+        for (int f = 0; f < files_per_app; f++) {
+            snprintf(paths[f], sizeof(paths[f]), "lib/module_%02d.py", f);
+            entries[f].full_path = paths[f];
+            snprintf(entries[f].sha256, sizeof(entries[f].sha256), "%064x", a * files_per_app + f);
+            entries[f].size = 1000 + f;
+            entries[f].mtime = 0;
+        }
+        install_manifest_t manifest = { a % 7 + 1, entries, files_per_app };
+        ok = install_manifest_save(app_dir, &manifest);
+    }
+    free(entries);
+    free(paths);
+    return ok;
+}
+
+// The old way: one directory walk and one manifest parse per app, every time.
+static int scan_installed(int *revision_sum) {
+    DIR *dir = opendir(INSTALLATION_DIR);
+    if (!dir) return 0;
+    int count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+        char app_dir[512];
+        snprintf(app_dir, sizeof(app_dir), "%s/%s", INSTALLATION_DIR, entry->d_name);
+        install_manifest_t *manifest = install_manifest_load(app_dir);
+        if (manifest) *revision_sum += manifest->revision;
+        install_manifest_free(manifest);
+        count++;
+    }
+    closedir(dir);
+    return count;
+}
+
+int main(int argc, char **argv) {
+    int apps = argc > 1 ? atoi(argv[1]) : DEFAULT_APPS;
+    int files_per_app = argc > 2 ? atoi(argv[2]) : DEFAULT_FILES_PER_APP;
+    if (apps < 1) apps = DEFAULT_APPS;
+    if (files_per_app < 1) files_per_app = DEFAULT_FILES_PER_APP;
+
+    char work_dir[] = "/tmp/bench_os_client.XXXXXX";
+    if (!mkdtemp(work_dir) || chdir(work_dir) != 0) {
+        perror("mkdtemp");
+        return 1;
+    }
+    if (!create_apps(apps, files_per_app)) {
+        fprintf(stderr, "Failed to create the test apps in %s\n", work_dir);
+        return 1;
+    }
+    printf("apps=%d files/app=%d in %s\n", apps, files_per_app, work_dir);
+
+    int revision_sum = 0;
+    double start = bench_now_ms();
+    int count = scan_installed(&revision_sum);
+    printf("  scan     list all:   %8.3f ms (%d apps)\n", bench_now_ms() - start, count);
+
+    start = bench_now_ms();
+    os_client_init(); // No index yet: rebuilt from the manifests and written
+    printf("  index    rebuild:    %8.3f ms\n", bench_now_ms() - start);
+
+    start = bench_now_ms();
+    os_client_init();
+    printf("  index    cold load:  %8.3f ms (%d apps)\n", bench_now_ms() - start, os_client_count());
+
+    start = bench_now_ms();
+    for (int i = 0; i < os_client_count(); i++) revision_sum += os_client_get(i)->revision;
+    printf("  index    list all:   %8.3f ms\n", bench_now_ms() - start);
+
+    // Half of the slugs are not installed.
+    char (*slugs)[32] = calloc(apps * 2, sizeof(*slugs));
+    if (!slugs) return 1;
+    for (int i = 0; i < apps * 2; i++) snprintf(slugs[i], sizeof(slugs[i]), "app-%04d", i);
+    int found = 0;
+    start = bench_now_ms();
+    for (int i = 0; i < LOOKUPS; i++) {
+        if (os_client_find(slugs[(int)((i * 7919LL) % (apps * 2))])) found++;
+    }
+    printf("  index    lookup:     %8.1f ns (%d%% hits)\n", (bench_now_ms() - start) * 1e6 / LOOKUPS,
+           (int)(found * 100LL / LOOKUPS));
+    free(slugs);
+
+    start = bench_now_ms();
+    os_client_delete_app("app-0000", false);
+    printf("  index    uninstall:  %8.3f ms (delete + index rewrite)\n", bench_now_ms() - start);
+
+    os_client_deinit();
+    printf("(checksum %d)\n", revision_sum);
+    char command[64];
+    snprintf(command, sizeof(command), "rm -rf %s", work_dir);
+    return system(command) == 0 ? 0 : 1;
+}
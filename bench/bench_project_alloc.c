@@ -0,0 +1,169 @@
+// Counts heap allocations needed to build, show and free a page of projects:
+// once the old way (a malloc per string, including a 1-byte one per missing
+// field, plus the copies each card made of slug and icon_url) and once with the
+// per-page arena used by project_parser.c.
+//
+// Usage: bench_project_alloc [response.json] [iterations]
+// Without a file, synthetic responses of 7 and 1000 projects are used.
+// Allocations are counted by wrapping glibc's malloc, so this runs on Linux only.
+#include "badgehub_client.h"
+#include "bench_fixtures.h"
+#include "json_stream.h"
+#include "project_parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_ITERATIONS 200
+#define CHUNK_SIZE 16384 // CURL_MAX_WRITE_SIZE
+
+// --- ALLOCATION COUNTING ---
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static size_t s_allocs = 0;
+static size_t s_frees = 0;
+
+void *malloc(size_t size) { s_allocs++; return __libc_malloc(size); }
+void *calloc(size_t nmemb, size_t size) { s_allocs++; return __libc_calloc(nmemb, size); }
+void *realloc(void *ptr, size_t size) { s_allocs++; return __libc_realloc(ptr, size); }
+void free(void *ptr) { if (ptr) s_frees++; __libc_free(ptr); }
+
+// --- OLD LAYOUT: ONE MALLOC PER STRING ---
+
+typedef struct {
+    project_t *projects;
+    int count;
+    int capacity;
+    bool in_icon_map;
+    bool in_icon_64;
+} legacy_builder_t;
+
+static char **legacy_field(project_t *project, const char *key) {
+    if (strcmp(key, "name") == 0) return &project->name;
+    if (strcmp(key, "slug") == 0) return &project->slug;
+    if (strcmp(key, "description") == 0) return &project->description;
+    if (strcmp(key, "project_url") == 0) return &project->project_url;
+    return NULL;
+}
+
+static void legacy_event_cb(const json_stream_event_t *event, void *user_data) {
+    legacy_builder_t *b = user_data;
+    if (event->depth == 1 && event->type == JSON_EVENT_OBJECT_START) {
+        if (b->count == b->capacity) {
+            b->capacity = b->capacity ? b->capacity * 2 : 8;
+            b->projects = realloc(b->projects, b->capacity * sizeof(project_t));
+        }
+        memset(&b->projects[b->count++], 0, sizeof(project_t));
+        return;
+    }
+    if (b->count == 0 || !event->key) return;
+    project_t *project = &b->projects[b->count - 1];
+    if (event->depth == 2) {
+        char **field = legacy_field(project, event->key);
+        if (field && !*field && event->type == JSON_EVENT_STRING) *field = strdup(event->value);
+        if (strcmp(event->key, "revision") == 0 && event->type == JSON_EVENT_NUMBER) project->revision = atoi(event->value);
+        if (strcmp(event->key, "icon_map") == 0) b->in_icon_map = event->type == JSON_EVENT_OBJECT_START;
+    } else if (event->depth == 3 && b->in_icon_map && strcmp(event->key, "64x64") == 0) {
+        b->in_icon_64 = event->type == JSON_EVENT_OBJECT_START;
+    } else if (event->depth == 4 && b->in_icon_64 && strcmp(event->key, "url") == 0 && event->type == JSON_EVENT_STRING) {
+        if (!project->icon_url) project->icon_url = strdup(event->value);
+    }
+}
+
+static void run_legacy(const char *json, size_t size, int *count) {
+    legacy_builder_t b;
+    memset(&b, 0, sizeof(b));
+    json_stream_t stream;
+    json_stream_init(&stream, legacy_event_cb, &b);
+    for (size_t off = 0; off < size; off += CHUNK_SIZE) {
+        json_stream_feed(&stream, json + off, size - off < CHUNK_SIZE ? size - off : CHUNK_SIZE);
+    }
+    json_stream_finish(&stream);
+    json_stream_free(&stream);
+    // get_json_string() gave every missing field its own 1-byte buffer.
+    for (int i = 0; i < b.count; i++) {
+        char **fields[] = { &b.projects[i].name, &b.projects[i].slug, &b.projects[i].description, &b.projects[i].project_url };
+        for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+            if (!*fields[f]) *fields[f] = strdup("");
+        }
+    }
+    // Each card copied slug and icon_url into its user data.
+    char **card_copies = malloc(b.count * 2 * sizeof(char *));
+    for (int i = 0; i < b.count; i++) {
+        card_copies[i * 2] = strdup(b.projects[i].slug);
+        card_copies[i * 2 + 1] = b.projects[i].icon_url ? strdup(b.projects[i].icon_url) : NULL;
+    }
+    for (int i = 0; i < b.count * 2; i++) free(card_copies[i]);
+    free(card_copies);
+    for (int i = 0; i < b.count; i++) {
+        free(b.projects[i].name);
+        free(b.projects[i].slug);
+        free(b.projects[i].description);
+        free(b.projects[i].project_url);
+        free(b.projects[i].icon_url);
+    }
+    free(b.projects);
+    *count = b.count;
+}
+
+// --- NEW LAYOUT: ONE ARENA PER PAGE ---
+
+static void run_arena(const char *json, size_t size, int *count) {
+    project_list_parser_t *parser = project_list_parser_create();
+    for (size_t off = 0; off < size; off += CHUNK_SIZE) {
+        project_list_parser_feed(parser, json + off, size - off < CHUNK_SIZE ? size - off : CHUNK_SIZE);
+    }
+    project_t *projects = project_list_parser_finish(parser, count);
+    // Cards reference the page's strings, so there is nothing to copy.
+    free_applications(projects, *count);
+}
+
+static void run(const char *name, void (*fn)(const char *, size_t, int *), const char *json, size_t size, int iterations) {
+    int count = 0;
+    s_allocs = s_frees = 0;
+    fn(json, size, &count);
+    size_t allocs = s_allocs, frees = s_frees;
+
+    double start = bench_now_ms();
+    for (int i = 0; i < iterations; i++) fn(json, size, &count);
+    double elapsed = bench_now_ms() - start;
+    printf("%-7s projects=%-5d allocs=%-6zu frees=%-6zu allocs/project=%5.2f  avg=%8.3f ms\n",
+           name, count, allocs, frees, count ? (double)allocs / count : 0.0, elapsed / iterations);
+}
+
+static void compare(const char *json, size_t size, int iterations) {
+    printf("response: %zu bytes\n", size);
+    run("legacy", run_legacy, json, size, iterations);
+    run("arena", run_arena, json, size, iterations);
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 2 ? atoi(argv[2]) : DEFAULT_ITERATIONS;
+    if (iterations < 1) iterations = DEFAULT_ITERATIONS;
+
+    if (argc > 1) {
+        size_t size = 0;
+        char *json = bench_read_file(argv[1], &size);
+        if (!json) {
+            fprintf(stderr, "Usage: %s [response.json] [iterations]\n", argv[0]);
+            return 1;
+        }
+        compare(json, size, iterations);
+        free(json);
+        return 0;
+    }
+
+    static const int page_sizes[] = { 7, 1000 }; // One home-screen page, one large search result
+    for (size_t i = 0; i < sizeof(page_sizes) / sizeof(page_sizes[0]); i++) {
+        size_t size = 0;
+        char *json = bench_generate_project_list(page_sizes[i], &size);
+        if (!json) return 1;
+        compare(json, size, iterations);
+        free(json);
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Measures bytes/second through the curl write callback for the old
+// WriteMemoryCallback (one realloc per chunk, grown by exactly the chunk size)
+// and for response_buffer.c: geometric growth, presized from Content-Length,
+// and presized buffers reused from the pool.
+//
+// Usage: bench_response_buffer [chunk_size] [iterations]
+#include "bench_fixtures.h"
+#include "response_buffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_CHUNK_SIZE 1400 // Roughly what one TCP segment delivers
+#define DEFAULT_ITERATIONS 200
+
+typedef struct {
+    char *memory;
+    size_t size;
+} legacy_buffer_t;
+
+// The callback this module replaced.
+static size_t legacy_write_cb(void *contents, size_t size, size_t nmemb, void *userp) {
+    size_t realsize = size * nmemb;
+    legacy_buffer_t *mem = (legacy_buffer_t *)userp;
+    char *ptr = realloc(mem->memory, mem->size + realsize + 1);
+    if (!ptr) return 0;
+    mem->memory = ptr;
+    memcpy(&(mem->memory[mem->size]), contents, realsize);
+    mem->size += realsize;
+    mem->memory[mem->size] = 0;
+    return realsize;
+}
+
+// Each receive function returns the number of (re)allocations it caused.
+static int receive_legacy(const char *body, size_t body_size, size_t chunk_size) {
+    legacy_buffer_t mem = { .memory = malloc(1), .size = 0 };
+    int allocations = 1;
+    for (size_t off = 0; off < body_size; off += chunk_size) {
+        size_t n = body_size - off < chunk_size ? body_size - off : chunk_size;
+        legacy_write_cb((void *)(body + off), 1, n, &mem);
+        allocations++;
+    }
+    free(mem.memory);
+    return allocations;
+}
+
+static int receive_buffer(const char *body, size_t body_size, size_t chunk_size, bool presize, bool pooled) {
+    response_buffer_t *buffer = response_buffer_acquire(0);
+    size_t capacity = buffer->capacity;
+    int allocations = 0;
+    if (presize) response_buffer_reserve(buffer, body_size); // What the Content-Length header enables
+    for (size_t off = 0; off <= body_size; off += chunk_size) {
+        if (buffer->capacity != capacity) {
+            capacity = buffer->capacity;
+            allocations++;
+        }
+        if (off == body_size) break;
+        size_t n = body_size - off < chunk_size ? body_size - off : chunk_size;
+        response_buffer_write_cb((void *)(body + off), 1, n, buffer);
+    }
+    if (buffer->capacity != capacity) allocations++;
+    if (pooled) {
+        response_buffer_release(buffer);
+    } else {
+        free(buffer->data);
+        free(buffer);
+    }
+    return allocations;
+}
+
+static void run(const char *name, int mode, const char *body, size_t body_size, size_t chunk_size, int iterations) {
+    int allocations = 0;
+    double start = bench_now_ms();
+    for (int i = 0; i < iterations; i++) {
+        switch (mode) {
+        case 0: allocations = receive_legacy(body, body_size, chunk_size); break;
+        case 1: allocations = receive_buffer(body, body_size, chunk_size, false, false); break;
+        case 2: allocations = receive_buffer(body, body_size, chunk_size, true, false); break;
+        default: allocations = receive_buffer(body, body_size, chunk_size, true, true); break;
+        }
+    }
+    double elapsed = bench_now_ms() - start;
+    printf("  %-10s %9.1f MB/s  allocations/response=%d\n", name,
+           (double)body_size * iterations / (elapsed / 1000.0) / (1024 * 1024), allocations);
+}
+
+int main(int argc, char **argv) {
+    size_t chunk_size = argc > 1 ? (size_t)atol(argv[1]) : DEFAULT_CHUNK_SIZE;
+    int iterations = argc > 2 ? atoi(argv[2]) : DEFAULT_ITERATIONS;
+    if (chunk_size == 0) chunk_size = DEFAULT_CHUNK_SIZE;
+    if (iterations < 1) iterations = DEFAULT_ITERATIONS;
+
+    // An icon, a page of projects, a large search result.
+    static const size_t body_sizes[] = { 4 * 1024, 64 * 1024, 512 * 1024 };
+    for (size_t i = 0; i < sizeof(body_sizes) / sizeof(body_sizes[0]); i++) {
+        size_t body_size = body_sizes[i];
+        char *body = malloc(body_size);
+        if (!body) return 1;
+        memset(body, 'x', body_size);
+        printf("body=%zu bytes chunk=%zu bytes\n", body_size, chunk_size);
+        run("legacy", 0, body, body_size, chunk_size, iterations);
+        run("growth", 1, body, body_size, chunk_size, iterations);
+        run("presized", 2, body, body_size, chunk_size, iterations);
+        run("pooled", 3, body, body_size, chunk_size, iterations);
+        free(body);
+    }
+    response_buffer_pool_clear();
+    return 0;
+}
@@ -0,0 +1,224 @@
+// Measures search-as-you-type over a catalog of 10,000 projects: the time to build
+// the local trigram index and its size, then the latency of every keystroke while
+// typing a set of queries, answered by the index versus a case-insensitive scan of
+// every project's name, slug and description. For comparison it times the same
+// searches as /project-summaries?search= round trips, which is what each search
+// cost before (after a one second pause in typing).
+//
+// Usage: bench_search [base_url] [projects]
+// The round trips need a server, by default the mock server on port 8080:
+//   python3 tools/mock_badgehub/mock_badgehub.py --synthetic 10000
+// They are skipped when it cannot be reached.
+#define _GNU_SOURCE // strcasestr()
+#include "bench_fixtures.h"
+#include "badgehub_client.h"
+#include "search_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define DEFAULT_BASE_URL "http://127.0.0.1:8080/api/v3"
+#define DEFAULT_PROJECTS 10000
+#define BUILD_ITERATIONS 5
+#define TYPING_ROUNDS 20
+#define SERVER_PAGE_LENGTH 20
+#define MAX_KEYSTROKES 4096
+
+// Words the generated names and descriptions are made of, badge apps being what they are.
+static const char *const s_words[] = {
+    "snake", "tetris", "clock", "weather", "led", "matrix", "badge", "game", "pong", "synth",
+    "music", "audio", "radio", "wifi", "scanner", "sensor", "temperature", "camera", "paint", "draw",
+    "text", "editor", "terminal", "shell", "python", "demo", "hello", "world", "flappy", "bird",
+    "space", "invaders", "asteroids", "breakout", "maze", "puzzle", "sudoku", "chess", "calculator", "timer",
+    "stopwatch", "alarm", "calendar", "notes", "todo", "qr", "code", "reader", "nfc", "infrared",
+    "remote", "bluetooth", "mesh", "chat", "irc", "mqtt", "dashboard", "graph", "plot", "fractal",
+    "mandelbrot", "life", "conway", "fire", "plasma", "rainbow", "lamp", "light", "disco", "party",
+    "dice", "cards", "poker", "slots", "racer", "car", "train", "map", "gps", "compass",
+    "level", "accelerometer", "tilt", "ball", "simple", "tiny", "mega", "retro", "pixel", "neon",
+};
+#define WORD_COUNT (int)(sizeof(s_words) / sizeof(s_words[0]))
+
+// Typed one character at a time; the last ones match nothing.
+static const char *const s_queries[] = {
+    "snake", "weather station", "led matrix", "retro space invaders", "Python Demo", "mandelbrot",
+    "qr code reader", "tiny", "calc", "flappy bird", "zzyzx", "chess engine",
+};
+#define QUERY_COUNT (int)(sizeof(s_queries) / sizeof(s_queries[0]))
+
+typedef int (*search_fn_t)(const char *query, int *results, int max_results);
+
+static project_t *s_projects = NULL;
+static int s_project_count = 0;
+static search_index_t *s_index = NULL;
+
+static unsigned s_seed = 12345;
+
+static int next_random(int bound) {
+    s_seed = s_seed * 1103515245u + 12345u;
+    return (int)((s_seed >> 16) % (unsigned)bound);
+}
+
+static char *append_words(char *out, const char *end, int count, bool capitalize) {
+    for (int i = 0; i < count && out < end; i++) {
+        const char *word = s_words[next_random(WORD_COUNT)];
+        if (i > 0) *out++ = ' ';
+        char *start = out;
+        out += snprintf(out, end - out, "%s", word);
+        if (capitalize) *start = *start - 'a' + 'A';
+    }
+    return out;
+}
+
+static bool generate_projects(int count) {
+    s_projects = calloc(count, sizeof(project_t));
+    if (!s_projects) return false;
+    for (int i = 0; i < count; i++) {
+        char name[128], slug[128], description[512];
+        int name_words = 2 + next_random(2);
+        char *end = append_words(name, name + sizeof(name) - 16, name_words, true);
+        snprintf(end, name + sizeof(name) - end, " %d", i);
+        int length = 0;
+        for (const char *c = name; *c; c++) {
+            slug[length++] = *c == ' ' ? '_' : (*c >= 'A' && *c <= 'Z' ? *c - 'A' + 'a' : *c);
+        }
+        slug[length] = '\0';
+        end = append_words(description, description + sizeof(description) - 32, 10 + next_random(8), false);
+        snprintf(end, description + sizeof(description) - end, ", for the WHY2025 badge.");
+        s_projects[i].name = strdup(name);
+        s_projects[i].slug = strdup(slug);
+        s_projects[i].description = strdup(description);
+        s_projects[i].revision = i % 17;
+        if (!s_projects[i].name || !s_projects[i].slug || !s_projects[i].description) return false;
+        s_project_count++;
+    }
+    return true;
+}
+
+static void free_projects(void) {
+    for (int i = 0; i < s_project_count; i++) {
+        free(s_projects[i].name);
+        free(s_projects[i].slug);
+        free(s_projects[i].description);
+    }
+    free(s_projects);
+}
+
+static int index_search(const char *query, int *results, int max_results) {
+    return search_index_query(s_index, query, results, max_results);
+}
+
+// What a search without an index does: look at every project for every word.
+static int scan_search(const char *query, int *results, int max_results) {
+    char words[SEARCH_INDEX_MAX_WORDS][64];
+    int word_count = 0;
+    char copy[256];
+    snprintf(copy, sizeof(copy), "%s", query);
+    for (char *word = strtok(copy, " "); word && word_count < SEARCH_INDEX_MAX_WORDS; word = strtok(NULL, " ")) {
+        snprintf(words[word_count++], sizeof(words[0]), "%s", word);
+    }
+    int count = 0;
+    for (int i = 0; i < s_project_count && word_count > 0; i++) {
+        bool match = true;
+        for (int w = 0; w < word_count && match; w++) {
+            match = strcasestr(s_projects[i].name, words[w]) || strcasestr(s_projects[i].slug, words[w]) ||
+                    strcasestr(s_projects[i].description, words[w]);
+        }
+        if (match && count < max_results) results[count] = i;
+        if (match) count++;
+    }
+    return count;
+}
+
+// Types every query a character at a time and times the search after each keystroke.
+static void bench_typing(const char *name, search_fn_t search) {
+    double *samples = malloc(MAX_KEYSTROKES * sizeof(double));
+    int *results = malloc(s_project_count * sizeof(int));
+    if (!samples || !results) {
+        free(samples);
+        free(results);
+        return;
+    }
+    int n = 0;
+    long matches = 0;
+    for (int round = 0; round < TYPING_ROUNDS; round++) {
+        for (int q = 0; q < QUERY_COUNT; q++) {
+            char typed[128];
+            size_t length = strlen(s_queries[q]);
+            for (size_t k = 1; k <= length && k < sizeof(typed); k++) {
+                memcpy(typed, s_queries[q], k);
+                typed[k] = '\0';
+                double start = bench_now_ms();
+                int count = search(typed, results, s_project_count);
+                double elapsed = bench_now_ms() - start;
+                if (round == 0) matches += count;
+                if (n < MAX_KEYSTROKES) samples[n++] = elapsed;
+            }
+        }
+    }
+    bench_report(name, samples, n, "ms");
+    printf("%-26s %ld matches over one round of typing\n", "", matches);
+    free(samples);
+    free(results);
+}
+
+static void bench_build(void) {
+    double samples[BUILD_ITERATIONS];
+    for (int i = 0; i < BUILD_ITERATIONS; i++) {
+        double start = bench_now_ms();
+        search_index_t *index = search_index_build(s_projects, s_project_count);
+        samples[i] = bench_now_ms() - start;
+        if (i == BUILD_ITERATIONS - 1) {
+            s_index = index;
+        } else {
+            search_index_free(index);
+        }
+    }
+    bench_report("index build", samples, BUILD_ITERATIONS, "ms");
+    if (s_index) printf("%-26s %.1f KiB\n", "index size", search_index_memory(s_index) / 1024.0);
+}
+
+static void bench_server(const char *base_url) {
+    double samples[QUERY_COUNT];
+    int n = 0;
+    badgehub_client_set_base_url(base_url);
+    if (!badgehub_client_init()) return;
+    for (int q = 0; q < QUERY_COUNT; q++) {
+        int count = 0;
+        double start = bench_now_ms();
+        project_t *projects = get_applications(&count, s_queries[q], SERVER_PAGE_LENGTH, 0);
+        double elapsed = bench_now_ms() - start;
+        if (!projects && q == 0) {
+            printf("server round trips skipped: no response from %s\n", base_url);
+            break;
+        }
+        free_applications(projects, count);
+        samples[n++] = elapsed;
+    }
+    if (n > 0) bench_report("server search", samples, n, "ms");
+    badgehub_client_cleanup();
+}
+
+int main(int argc, char **argv) {
+    const char *base_url = argc > 1 ? argv[1] : DEFAULT_BASE_URL;
+    int count = argc > 2 ? atoi(argv[2]) : DEFAULT_PROJECTS;
+    if (count < 1 || count > SEARCH_INDEX_MAX_PROJECTS) count = DEFAULT_PROJECTS;
+
+    if (!generate_projects(count)) {
+        fprintf(stderr, "Failed to build the projects\n");
+        return 1;
+    }
+    printf("%d projects\n", s_project_count);
+    bench_build();
+    if (!s_index) {
+        fprintf(stderr, "Failed to build the index\n");
+        return 1;
+    }
+    bench_typing("keystroke, index", index_search);
+    bench_typing("keystroke, scan", scan_search);
+    bench_server(base_url);
+
+    search_index_free(s_index);
+    free_projects();
+    return 0;
+}
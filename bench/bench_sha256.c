@@ -0,0 +1,55 @@
+// Measures SHA-256 throughput of every backend compiled into sha256.c that the
+// CPU supports, feeding data in chunks the size curl hands the write callback.
+//
+// Usage: bench_sha256 [megabytes] [chunk_size]
+#include "bench_fixtures.h"
+#include "sha256.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_MEGABYTES 256
+#define DEFAULT_CHUNK_SIZE 16384 // CURL_MAX_WRITE_SIZE
+
+int main(int argc, char **argv) {
+    long megabytes = argc > 1 ? atol(argv[1]) : DEFAULT_MEGABYTES;
+    size_t chunk_size = argc > 2 ? (size_t)atol(argv[2]) : DEFAULT_CHUNK_SIZE;
+    if (megabytes < 1) megabytes = DEFAULT_MEGABYTES;
+    if (chunk_size == 0) chunk_size = DEFAULT_CHUNK_SIZE;
+
+    uint8_t *chunk = malloc(chunk_size);
+    if (!chunk) return 1;
+    for (size_t i = 0; i < chunk_size; i++) chunk[i] = (uint8_t)(i * 31 + 7);
+    size_t total = (size_t)megabytes * 1024 * 1024;
+
+    printf("hashing %ld MiB in %zu byte chunks\n", megabytes, chunk_size);
+    char reference[SHA256_HEX_SIZE] = "";
+    for (int backend = 0; backend < SHA256_BACKEND_COUNT; backend++) {
+        if (!sha256_set_backend((sha256_backend_t)backend)) {
+            printf("  %-9s not available\n", sha256_backend_name((sha256_backend_t)backend));
+            continue;
+        }
+        sha256_ctx_t ctx;
+        uint8_t digest[SHA256_DIGEST_SIZE];
+        char hex[SHA256_HEX_SIZE];
+        double start = bench_now_ms();
+        sha256_init(&ctx);
+        for (size_t hashed = 0; hashed < total; hashed += chunk_size) {
+            sha256_update(&ctx, chunk, total - hashed < chunk_size ? total - hashed : chunk_size);
+        }
+        sha256_final(&ctx, digest);
+        double elapsed = bench_now_ms() - start;
+        sha256_to_hex(digest, hex);
+        // Every backend must produce the portable backend's digest.
+        bool match = !reference[0] || strcmp(reference, hex) == 0;
+        if (!reference[0]) memcpy(reference, hex, sizeof(reference));
+        printf("  %-9s %8.1f MB/s%s\n", sha256_backend_name((sha256_backend_t)backend),
+               (double)total / (elapsed / 1000.0) / (1024 * 1024), match ? "" : "  DIGEST MISMATCH");
+        if (!match) {
+            free(chunk);
+            return 1;
+        }
+    }
+    free(chunk);
+    return 0;
+}
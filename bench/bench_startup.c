@@ -0,0 +1,192 @@
+// Measures the time from process start to the first frame of the home view that
+// shows projects, on the headless display. Each run is a fresh process, spawned
+// from this one with --child, so the time includes loading the executable and
+// initializing LVGL and the client. The runs are made without a catalog snapshot,
+// when the home view waits for the first chunk from the server, with the snapshot
+// left by a completed sync, and with that snapshot while the server is unreachable.
+//
+// Usage: bench_startup [base_url] [runs]
+// The runs need a server, by default the mock server on port 8080:
+//   python3 tools/mock_badgehub/mock_badgehub.py --synthetic 2000
+// Add --latency-ms to see what the snapshot saves on a slow network. The runs
+// work in a temporary directory, so the snapshot and caches of the current
+// directory are left alone.
+#include "bench_fixtures.h"
+#include "app_home.h"
+#include "badgehub_client.h"
+#include "catalog_snapshot.h"
+#include "catalog_window.h"
+#include "headless_display.h"
+#include "icon_cache.h"
+#include "install_manager.h"
+#include "os_client.h"
+#include "update_checker.h"
+#include "utils.h"
+#include "lvgl/lvgl.h"
+#include <limits.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DISPLAY_WIDTH 720
+#define DISPLAY_HEIGHT 720
+#define DEFAULT_BASE_URL "http://127.0.0.1:8080/api/v3"
+#define UNREACHABLE_BASE_URL "http://127.0.0.1:9/api/v3" // The discard port; nothing listens there
+#define DEFAULT_RUNS 10
+#define WAIT_TIMEOUT_MS 10000
+#define SYNC_TIMEOUT_MS 60000
+
+extern char **environ;
+
+// The home view shows projects once the first row is bound and nothing on screen waits.
+static bool home_populated(void) {
+    return !app_home_is_loading() && catalog_window_get(0) != NULL;
+}
+
+// Starts like main.c, renders the first populated frame and prints the time it was
+// done, the time the snapshot took to load and the number of projects it held.
+// With sync, it then waits for the catalog snapshot to be brought up to date.
+static int run_child(const char *base_url, bool sync) {
+    lv_init();
+    lv_group_set_default(lv_group_create());
+    if (!headless_display_create(DISPLAY_WIDTH, DISPLAY_HEIGHT)) return 1;
+    icon_cache_init(ICON_CACHE_DEFAULT_BUDGET);
+    badgehub_client_set_base_url(base_url);
+    if (!badgehub_client_init()) return 1;
+    install_manager_init();
+    os_client_init();
+
+    double load_start = bench_now_ms();
+    catalog_snapshot_load();
+    double load_ms = bench_now_ms() - load_start;
+    create_app_home_view();
+
+    double deadline = bench_now_ms() + WAIT_TIMEOUT_MS;
+    bool populated = home_populated();
+    while (!populated && bench_now_ms() < deadline) {
+        lv_timer_handler();
+        usleep(200);
+        populated = home_populated();
+    }
+    lv_refr_now(NULL);
+    double done = bench_now_ms();
+    if (populated) printf("%.3f %.3f %d\n", done, load_ms, catalog_snapshot_count());
+    fflush(stdout);
+
+    bool synced = !sync;
+    if (sync && populated) {
+        time_t previous = catalog_snapshot_synced_at();
+        deadline = bench_now_ms() + SYNC_TIMEOUT_MS;
+        catalog_snapshot_sync(true); // Joins the sync the home view started, if any
+        while (catalog_snapshot_is_syncing() && bench_now_ms() < deadline) {
+            lv_timer_handler();
+            usleep(1000);
+        }
+        synced = catalog_snapshot_count() > 0 && catalog_snapshot_synced_at() != previous;
+    }
+
+    lv_obj_clean(lv_screen_active());
+    update_checker_deinit();
+    catalog_snapshot_deinit();
+    install_manager_deinit();
+    os_client_deinit();
+    badgehub_client_cleanup();
+    icon_cache_deinit();
+    headless_display_deinit();
+    return populated && synced ? 0 : 1;
+}
+
+// Spawns a child run and returns the time from the spawn to its first populated frame.
+static bool time_startup(const char *exe, const char *base_url, bool sync, double *elapsed, double *load_ms,
+                         int *snapshot_count) {
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, fds[0]);
+    char *argv[] = {(char *)exe, "--child", (char *)base_url, sync ? "--sync" : NULL, NULL};
+
+    pid_t pid;
+    double start = bench_now_ms();
+    int err = posix_spawn(&pid, exe, &actions, NULL, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+    if (err != 0) {
+        close(fds[0]);
+        return false;
+    }
+    FILE *out = fdopen(fds[0], "r");
+    double done = 0;
+    bool ok = out && fscanf(out, "%lf %lf %d", &done, load_ms, snapshot_count) == 3;
+    if (out) {
+        fclose(out);
+    } else {
+        close(fds[0]);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    *elapsed = done - start;
+    return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void bench_startup(const char *exe, const char *name, const char *base_url, bool keep_snapshot, int runs) {
+    double *elapsed = malloc(runs * sizeof(double));
+    double *loads = malloc(runs * sizeof(double));
+    if (!elapsed || !loads) {
+        free(elapsed);
+        free(loads);
+        return;
+    }
+    int n = 0, snapshot_count = 0;
+    for (int i = 0; i < runs; i++) {
+        if (!keep_snapshot) remove(CATALOG_SNAPSHOT_PATH);
+        if (time_startup(exe, base_url, false, &elapsed[n], &loads[n], &snapshot_count)) n++;
+    }
+    bench_report(name, elapsed, n, "ms");
+    if (keep_snapshot && n > 0) {
+        char label[64];
+        snprintf(label, sizeof(label), "  snapshot load (%d)", snapshot_count);
+        bench_report(label, loads, n, "ms");
+    }
+    free(elapsed);
+    free(loads);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 2 && strcmp(argv[1], "--child") == 0) {
+        return run_child(argv[2], argc > 3 && strcmp(argv[3], "--sync") == 0);
+    }
+    const char *base_url = argc > 1 ? argv[1] : DEFAULT_BASE_URL;
+    int runs = argc > 2 ? atoi(argv[2]) : DEFAULT_RUNS;
+    if (runs < 1) runs = DEFAULT_RUNS;
+
+    char exe[PATH_MAX];
+    if (!realpath(argv[0], exe)) {
+        fprintf(stderr, "Cannot find %s\n", argv[0]);
+        return 1;
+    }
+    char work_dir[] = "/tmp/bench_startup.XXXXXX";
+    if (!mkdtemp(work_dir) || chdir(work_dir) != 0) {
+        fprintf(stderr, "Failed to create a working directory\n");
+        return 1;
+    }
+
+    bench_startup(exe, "no snapshot", base_url, false, runs);
+
+    double elapsed = 0, load_ms = 0;
+    int snapshot_count = 0;
+    if (!time_startup(exe, base_url, true, &elapsed, &load_ms, &snapshot_count)) {
+        printf("snapshot runs skipped: the catalog could not be synced from %s\n", base_url);
+    } else {
+        bench_startup(exe, "snapshot", base_url, true, runs);
+        bench_startup(exe, "snapshot, server down", UNREACHABLE_BASE_URL, true, runs);
+    }
+
+    if (chdir("/") == 0) remove_tree(work_dir);
+    return 0;
+}
@@ -0,0 +1,319 @@
+// Measures the UI on the headless display: the cost of creating app cards, the
+// render time per frame while scrolling a list of cards and after invalidating the
+// whole screen, the cost of replacing a page of cards by recreating them versus
+// rebinding the recycled cards of the virtualized list, and the latency of
+// switching pages and opening a project, from the key press until the new view is
+// rendered. Finally it scrolls through the catalog in continuous scroll mode,
+// timing each frame and counting the frames that still showed placeholders.
+//
+// Usage: bench_ui [base_url] [frames]
+// The page switches need a server, by default the mock server on port 8080:
+//   python3 tools/mock_badgehub/mock_badgehub.py --synthetic 2000
+// They are skipped when it cannot be reached. Card icons are not loaded, so the
+// render times cover the cards without their icons.
+#include "app_card.h"
+#include "app_detail.h"
+#include "app_home.h"
+#include "app_list.h"
+#include "badgehub_client.h"
+#include "bench_fixtures.h"
+#include "catalog_snapshot.h"
+#include "catalog_window.h"
+#include "headless_display.h"
+#include "http_async.h"
+#include "icon_cache.h"
+#include "install_manager.h"
+#include "os_client.h"
+#include "page_cache.h"
+#include "project_parser.h"
+#include "update_checker.h"
+#include "lvgl/lvgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define DISPLAY_WIDTH 720
+#define DISPLAY_HEIGHT 720
+#define DEFAULT_BASE_URL "http://127.0.0.1:8080/api/v3"
+#define DEFAULT_FRAMES 300
+#define CREATE_CARDS 200
+#define CREATE_ITERATIONS 10
+#define SCROLL_CARDS 50
+#define SCROLL_STEP 12
+#define PAGE_LENGTH 7 // ITEMS_PER_PAGE in app_home.c
+#define PAGE_SWITCHES 10
+#define PAGE_REPLACEMENTS 200
+#define DETAIL_OPENS 10
+#define WAIT_TIMEOUT_MS 10000
+#define CATALOG_SCROLL_STEP 45 // Pixels per frame, half a card
+
+typedef bool (*loading_fn_t)(void);
+
+// Runs the LVGL loop until the view stops loading and no request is in flight.
+static bool pump_until_idle(loading_fn_t loading, bool wait_for_requests) {
+    double deadline = bench_now_ms() + WAIT_TIMEOUT_MS;
+    while ((loading && loading()) || (wait_for_requests && http_async_active_count() > 0)) {
+        if (bench_now_ms() > deadline) return false;
+        lv_timer_handler();
+        usleep(200);
+    }
+    return true;
+}
+
+// Times an action from its start until the view it loads has been rendered.
+static bool time_action(void (*action)(void), loading_fn_t loading, double *elapsed) {
+    double start = bench_now_ms();
+    action();
+    if (!pump_until_idle(loading, false)) return false;
+    lv_refr_now(NULL);
+    *elapsed = bench_now_ms() - start;
+    return true;
+}
+
+static lv_obj_t *create_list(void) {
+    lv_obj_t *list = lv_obj_create(lv_screen_active());
+    lv_obj_set_size(list, lv_pct(100), lv_pct(100));
+    lv_obj_set_flex_flow(list, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(list, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    return list;
+}
+
+static void bench_card_creation(const project_t *projects, int count) {
+    double per_card[CREATE_ITERATIONS];
+    double layout[CREATE_ITERATIONS];
+    for (int it = 0; it < CREATE_ITERATIONS; it++) {
+        lv_obj_t *list = create_list();
+        double start = bench_now_ms();
+        for (int i = 0; i < count; i++) create_app_card(list, &projects[i]);
+        double created = bench_now_ms();
+        lv_obj_update_layout(list);
+        layout[it] = bench_now_ms() - created;
+        per_card[it] = (created - start) * 1000.0 / count;
+        lv_obj_delete(list);
+    }
+    bench_report("card creation", per_card, CREATE_ITERATIONS, "us/card");
+    bench_report("card layout", layout, CREATE_ITERATIONS, "ms");
+}
+
+// Shows successive pages of cards, rendering each one.
+static void bench_page_replacement(project_t *projects, int count) {
+    double rebuilt[PAGE_REPLACEMENTS], rebound[PAGE_REPLACEMENTS];
+    int pages = count / PAGE_LENGTH;
+    if (pages < 1) return;
+
+    lv_obj_t *list = create_list();
+    for (int i = 0; i < PAGE_REPLACEMENTS; i++) {
+        double start = bench_now_ms();
+        lv_obj_clean(list);
+        create_app_list_view(list, &projects[(i % pages) * PAGE_LENGTH], PAGE_LENGTH);
+        lv_refr_now(NULL);
+        rebuilt[i] = bench_now_ms() - start;
+    }
+    lv_obj_delete(list);
+    bench_report("page, rebuilt", rebuilt, PAGE_REPLACEMENTS, "ms");
+
+    list = app_list_create(lv_screen_active());
+    lv_obj_set_size(list, lv_pct(100), lv_pct(100));
+    for (int i = 0; i < PAGE_REPLACEMENTS; i++) {
+        double start = bench_now_ms();
+        app_list_set_projects(list, &projects[(i % pages) * PAGE_LENGTH], PAGE_LENGTH);
+        lv_refr_now(NULL);
+        rebound[i] = bench_now_ms() - start;
+    }
+    lv_obj_delete(list);
+    bench_report("page, recycled", rebound, PAGE_REPLACEMENTS, "ms");
+}
+
+static void bench_rendering(const project_t *projects, int count, int frames) {
+    double *samples = malloc(frames * sizeof(double));
+    if (!samples) return;
+    lv_obj_t *list = create_list();
+    for (int i = 0; i < count && i < SCROLL_CARDS; i++) create_app_card(list, &projects[i]);
+    lv_refr_now(NULL);
+
+    headless_display_stats_t before = headless_display_get_stats();
+    for (int frame = 0; frame < frames; frame++) {
+        double start = bench_now_ms();
+        lv_obj_scroll_by(list, 0, (frame / 100) % 2 ? SCROLL_STEP : -SCROLL_STEP, LV_ANIM_OFF);
+        lv_refr_now(NULL);
+        samples[frame] = bench_now_ms() - start;
+    }
+    headless_display_stats_t after = headless_display_get_stats();
+    bench_report("scroll frame", samples, frames, "ms");
+    printf("%-26s %.0f pixels/frame\n", "", (double)(after.pixels_flushed - before.pixels_flushed) / frames);
+
+    for (int frame = 0; frame < frames; frame++) {
+        double start = bench_now_ms();
+        lv_obj_invalidate(lv_screen_active());
+        lv_refr_now(NULL);
+        samples[frame] = bench_now_ms() - start;
+    }
+    bench_report("full frame", samples, frames, "ms");
+    lv_obj_delete(list);
+    free(samples);
+}
+
+static const char *s_detail_slug = NULL;
+static int s_detail_revision = 0;
+
+static void open_detail(void) {
+    create_app_detail_view(s_detail_slug, s_detail_revision);
+}
+
+static void bench_navigation(const char *base_url) {
+    // Probe the server and find out how many pages there are to switch between.
+    int count = 0;
+    project_t *projects = get_applications(&count, "", PAGE_LENGTH * (PAGE_SWITCHES + 1), 0);
+    if (!projects || count == 0) {
+        printf("page switches skipped: no projects from %s\n", base_url);
+        free_applications(projects, count);
+        return;
+    }
+    int switches = (count - 1) / PAGE_LENGTH;
+    if (switches > PAGE_SWITCHES) switches = PAGE_SWITCHES;
+
+    app_home_set_continuous_scroll(false);
+    create_app_home_view();
+    if (!pump_until_idle(app_home_is_loading, true)) {
+        printf("page switches skipped: the first page did not load\n");
+        free_applications(projects, count);
+        return;
+    }
+    lv_refr_now(NULL);
+
+    double fetched[PAGE_SWITCHES], prefetched[PAGE_SWITCHES], cached[PAGE_SWITCHES];
+    int n_fetched = 0, n_prefetched = 0, n_cached = 0;
+    // Forward once with the prefetched page dropped, so the page comes from the server...
+    for (int i = 0; i < switches; i++) {
+        pump_until_idle(NULL, true);
+        page_cache_clear();
+        if (time_action(app_home_show_next_page, app_home_is_loading, &fetched[n_fetched])) n_fetched++;
+    }
+    for (int i = 0; i < switches; i++) {
+        if (time_action(app_home_show_previous_page, app_home_is_loading, &cached[n_cached])) n_cached++;
+    }
+    // ...and once with the prefetch of the next page given time to land.
+    for (int i = 0; i < switches; i++) {
+        pump_until_idle(NULL, true);
+        if (time_action(app_home_show_next_page, app_home_is_loading, &prefetched[n_prefetched])) n_prefetched++;
+    }
+    if (switches == 0) printf("page switches skipped: the server has a single page of projects\n");
+    bench_report("next page, fetched", fetched, n_fetched, "ms");
+    bench_report("next page, prefetched", prefetched, n_prefetched, "ms");
+    bench_report("previous page, cached", cached, n_cached, "ms");
+
+    double opened[DETAIL_OPENS], back[DETAIL_OPENS];
+    int n_opened = 0, n_back = 0;
+    s_detail_slug = projects[0].slug;
+    s_detail_revision = projects[0].revision;
+    for (int i = 0; i < DETAIL_OPENS; i++) {
+        pump_until_idle(NULL, true);
+        if (time_action(open_detail, app_detail_is_loading, &opened[n_opened])) n_opened++;
+        if (time_action(create_app_home_view, app_home_is_loading, &back[n_back])) n_back++;
+    }
+    bench_report("open project", opened, n_opened, "ms");
+    bench_report("back to list", back, n_back, "ms");
+    pump_until_idle(NULL, true);
+    free_applications(projects, count);
+}
+
+static const project_t *catalog_item_cb(int index, void *user_data) {
+    return catalog_window_get(index);
+}
+
+static void catalog_visible_cb(int first, int last, void *user_data) {
+    catalog_window_set_visible(first, last);
+}
+
+static void catalog_changed_cb(void *user_data) {
+    lv_obj_t *list = user_data;
+    app_list_set_count(list, catalog_window_count());
+    app_list_refresh_items(list);
+}
+
+static void bench_catalog_scroll(int frames) {
+    double *samples = malloc(frames * sizeof(double));
+    if (!samples) return;
+    // The home view synced a catalog snapshot; drop it so the rows come from the server.
+    catalog_snapshot_deinit();
+    lv_obj_t *list = app_list_create(lv_screen_active());
+    lv_obj_set_size(list, lv_pct(100), lv_pct(100));
+    catalog_window_start("", catalog_changed_cb, list);
+    app_list_set_source(list, catalog_window_count(), catalog_item_cb, catalog_visible_cb, NULL);
+    if (!pump_until_idle(catalog_window_is_loading, false) || catalog_window_count() == 0) {
+        printf("catalog scroll skipped: the first chunk did not load\n");
+    } else {
+        int waiting = 0;
+        for (int frame = 0; frame < frames; frame++) {
+            double start = bench_now_ms();
+            lv_obj_scroll_by(list, 0, -CATALOG_SCROLL_STEP, LV_ANIM_OFF);
+            lv_timer_handler();
+            lv_refr_now(NULL);
+            samples[frame] = bench_now_ms() - start;
+            if (catalog_window_is_loading()) waiting++;
+            usleep(16 * 1000); // Leave the chunks ahead time to arrive, like a 60 Hz display
+        }
+        bench_report("catalog scroll frame", samples, frames, "ms");
+        printf("%-26s %d rows scrolled, %d/%d frames waiting for projects, %d rows known%s\n", "",
+               (int)(lv_obj_get_scroll_y(list) / APP_LIST_ROW_HEIGHT), waiting, frames, catalog_window_count(),
+               catalog_window_end_reached() ? " (end reached)" : "");
+    }
+    lv_obj_delete(list);
+    catalog_window_stop();
+    free(samples);
+}
+
+int main(int argc, char **argv) {
+    const char *base_url = argc > 1 ? argv[1] : DEFAULT_BASE_URL;
+    int frames = argc > 2 ? atoi(argv[2]) : DEFAULT_FRAMES;
+    if (frames < 1) frames = DEFAULT_FRAMES;
+
+    lv_init();
+    lv_group_set_default(lv_group_create());
+    if (!headless_display_create(DISPLAY_WIDTH, DISPLAY_HEIGHT)) {
+        fprintf(stderr, "Failed to create the display\n");
+        return 1;
+    }
+    icon_cache_init(ICON_CACHE_DEFAULT_BUDGET);
+    badgehub_client_set_base_url(base_url);
+    if (!badgehub_client_init()) {
+        fprintf(stderr, "Failed to initialize the BadgeHub client\n");
+        return 1;
+    }
+    install_manager_init();
+    os_client_init();
+
+    size_t size = 0;
+    char *json = bench_generate_project_list(CREATE_CARDS, &size);
+    project_list_parser_t *parser = json ? project_list_parser_create() : NULL;
+    int count = 0;
+    project_t *projects = NULL;
+    if (parser && project_list_parser_feed(parser, json, size)) {
+        projects = project_list_parser_finish(parser, &count);
+    } else if (parser) {
+        project_list_parser_abort(parser);
+    }
+    free(json);
+    if (!projects) {
+        fprintf(stderr, "Failed to build the projects\n");
+        return 1;
+    }
+    // The generated icon URLs point at the live service; keep the cards offline.
+    for (int i = 0; i < count; i++) projects[i].icon_url = NULL;
+
+    bench_card_creation(projects, count);
+    bench_page_replacement(projects, count);
+    bench_rendering(projects, count, frames);
+    bench_navigation(base_url);
+    bench_catalog_scroll(frames);
+    free_applications(projects, count);
+
+    lv_obj_clean(lv_screen_active());
+    update_checker_deinit();
+    install_manager_deinit();
+    os_client_deinit();
+    badgehub_client_cleanup();
+    icon_cache_deinit();
+    headless_display_deinit();
+    return 0;
+}
@@ -1181,8 +1181,12 @@
  * DEVICES
  *==================*/
 
-/** Use SDL to open window on PC and handle mouse and keyboard. */
-#define LV_USE_SDL              1
+/** Use SDL to open window on PC and handle mouse and keyboard. Headless builds render to memory instead. */
+#ifdef BADGEHUB_HEADLESS
+    #define LV_USE_SDL          0
+#else
+    #define LV_USE_SDL          1
+#endif
 #if LV_USE_SDL
     #define LV_SDL_INCLUDE_PATH     <SDL2/SDL.h>
     #define LV_SDL_RENDER_MODE      LV_DISPLAY_RENDER_MODE_DIRECT   /**< LV_DISPLAY_RENDER_MODE_DIRECT is recommended for best performance */
@@ -2,6 +2,8 @@
 #include "app_detail.h"
 #include "app_home.h"
 #include "badgehub_client.h"
+#include "icon_cache.h"
+#include "icon_loader.h"
 #include "lvgl/lvgl.h"
 #include <string.h>
 #include <stdlib.h>
@@ -9,19 +11,46 @@
 static void card_click_event_handler(lv_event_t * e);
 static void card_delete_event_handler(lv_event_t * e);
 static void card_key_event_handler(lv_event_t * e);
+static void icon_downloaded_cb(const char* icon_url, const uint8_t* icon_data, size_t icon_size, void* owner);
+
+// --- STATIC STATE VARIABLES ---
+static lv_style_t s_style_focused;
+static lv_style_t s_style_title;
+static bool s_styles_initialized = false;
+
+// --- IMPLEMENTATIONS ---
+
+// The styles are shared by every card, so they are set up once rather than per card.
+static void init_styles(void) {
+    if (s_styles_initialized) return;
+    lv_style_init(&s_style_focused);
+    lv_style_set_border_color(&s_style_focused, lv_palette_main(LV_PALETTE_BLUE));
+    lv_style_set_border_width(&s_style_focused, 2);
+    lv_style_init(&s_style_title);
+    lv_style_set_text_font(&s_style_title, lv_font_get_default());
+    s_styles_initialized = true;
+}
 
 void create_app_card(lv_obj_t* parent, const project_t* project) {
-    static lv_style_t style_focused;
-    lv_style_init(&style_focused);
-    lv_style_set_border_color(&style_focused, lv_palette_main(LV_PALETTE_BLUE));
-    lv_style_set_border_width(&style_focused, 2);
+    lv_obj_t* card = app_card_create(parent);
+    if (!card) return;
+    lv_obj_add_event_cb(card, card_key_event_handler, LV_EVENT_KEY, NULL);
+    app_card_bind(card, project);
+}
+
+lv_obj_t* app_card_create(lv_obj_t* parent) {
+    init_styles();
+
+    // Allocated once per card and reused by every project the card is bound to.
+    card_user_data_t* user_data = calloc(1, sizeof(card_user_data_t));
+    if (!user_data) return NULL;
 
     lv_obj_t* card = lv_obj_create(parent);
-    lv_obj_set_size(card, lv_pct(95), 80);
+    lv_obj_set_size(card, lv_pct(95), APP_CARD_HEIGHT);
     lv_obj_set_flex_flow(card, LV_FLEX_FLOW_ROW);
     lv_obj_set_flex_align(card, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_add_flag(card, LV_OBJ_FLAG_CLICKABLE);
-    lv_obj_add_style(card, &style_focused, LV_STATE_FOCUSED);
+    lv_obj_add_flag(card, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_style(card, &s_style_focused, LV_STATE_FOCUSED);
     lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
 
     lv_obj_t* icon_img = lv_image_create(card);
@@ -35,67 +64,92 @@ void create_app_card(lv_obj_t* parent, const project_t* project) {
     lv_obj_set_flex_flow(text_container, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_style_pad_left(text_container, 10, 0);
 
-    card_user_data_t* user_data = calloc(1, sizeof(card_user_data_t));
-    if (user_data) {
-        user_data->slug = strdup(project->slug);
-        user_data->revision = project->revision;
-        if (project->icon_url) {
-            user_data->icon_url = strdup(project->icon_url);
-        }
-    }
-
     lv_obj_set_user_data(card, user_data);
     lv_obj_add_event_cb(card, card_click_event_handler, LV_EVENT_CLICKED, user_data);
     lv_obj_add_event_cb(card, card_delete_event_handler, LV_EVENT_DELETE, user_data);
-    lv_obj_add_event_cb(card, card_key_event_handler, LV_EVENT_KEY, NULL);
 
     lv_group_add_obj(lv_group_get_default(), card);
 
-    static lv_style_t style_title;
-    lv_style_init(&style_title);
-    lv_style_set_text_font(&style_title, lv_font_get_default());
-
     lv_obj_t* title_label = lv_label_create(text_container);
-    lv_label_set_text(title_label, project->name);
-    lv_obj_add_style(title_label, &style_title, 0);
+    lv_label_set_text_static(title_label, "");
+    lv_obj_add_style(title_label, &s_style_title, 0);
     lv_label_set_long_mode(title_label, LV_LABEL_LONG_WRAP);
     lv_obj_set_width(title_label, lv_pct(100));
 
     lv_obj_t* desc_label = lv_label_create(text_container);
-    lv_label_set_text(desc_label, project->description);
     lv_label_set_long_mode(desc_label, LV_LABEL_LONG_DOT);
     lv_obj_set_width(desc_label, lv_pct(100));
+    return card;
+}
+
+void app_card_bind(lv_obj_t* card, const project_t* project) {
+    card_user_data_t* user_data = lv_obj_get_user_data(card);
+    if (!user_data) return;
+
+    icon_loader_cancel(card);
+    if (user_data->icon_buf) {
+        icon_cache_release(user_data->icon_buf);
+        user_data->icon_buf = NULL;
+        lv_image_set_src(lv_obj_get_child(card, 0), LV_SYMBOL_IMAGE);
+    }
+
+    lv_obj_t* text_container = lv_obj_get_child(card, 1);
+    lv_obj_t* title_label = lv_obj_get_child(text_container, 0);
+    lv_obj_t* desc_label = lv_obj_get_child(text_container, 1);
+    if (!project) {
+        user_data->slug = NULL;
+        user_data->icon_url = NULL;
+        lv_label_set_text_static(title_label, "");
+        lv_obj_add_flag(card, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+
+    // Reference the page's arena instead of copying; the page outlives the binding.
+    user_data->slug = project->slug;
+    user_data->revision = project->revision;
+    user_data->icon_url = project->icon_url;
+    lv_label_set_text_static(title_label, project->name ? project->name : "");
+    // LV_LABEL_LONG_DOT writes the ellipsis into the text, so the description keeps a copy.
+    lv_label_set_text(desc_label, project->description ? project->description : "");
+    lv_obj_clear_flag(card, LV_OBJ_FLAG_HIDDEN);
 }
 
 void app_card_load_icon(lv_obj_t* card) {
     if (!card) return;
     card_user_data_t* user_data = lv_obj_get_user_data(card);
-    if (!user_data || !user_data->icon_url || user_data->icon_data) {
+    if (!user_data || !user_data->icon_url || user_data->icon_buf) {
         return; // No URL or icon already loaded
     }
 
-    size_t icon_size = 0;
-    uint8_t* icon_data = download_icon_to_memory(user_data->icon_url, &icon_size);
+    const lv_draw_buf_t* cached = icon_cache_acquire(user_data->icon_url);
+    if (cached) {
+        user_data->icon_buf = cached;
+        lv_image_set_src(lv_obj_get_child(card, 0), cached);
+        return;
+    }
+    icon_loader_request(user_data->icon_url, icon_downloaded_cb, card);
+}
 
-    if (icon_data) {
-        user_data->icon_data = icon_data;
-        user_data->icon_dsc.data = icon_data;
-        user_data->icon_dsc.data_size = icon_size;
-        user_data->icon_dsc.header.cf = LV_COLOR_FORMAT_RAW;
+static void icon_downloaded_cb(const char* icon_url, const uint8_t* icon_data, size_t icon_size, void* owner) {
+    lv_obj_t* card = (lv_obj_t*)owner;
+    card_user_data_t* user_data = lv_obj_get_user_data(card);
+    if (!user_data || user_data->icon_buf) {
+        return;
+    }
 
+    // Decode once; redraws then blit the cached buffer instead of re-running the PNG decoder.
+    user_data->icon_buf = icon_cache_insert(user_data->icon_url, icon_data, icon_size);
+    if (user_data->icon_buf) {
         lv_obj_t* icon_img = lv_obj_get_child(card, 0);
-        lv_image_set_src(icon_img, &user_data->icon_dsc);
+        lv_image_set_src(icon_img, user_data->icon_buf);
     }
 }
 
 static void card_delete_event_handler(lv_event_t * e) {
     card_user_data_t* user_data = (card_user_data_t*)lv_event_get_user_data(e);
+    icon_loader_cancel(lv_event_get_target(e));
     if (user_data) {
-        free(user_data->slug);
-        free(user_data->icon_url);
-        if (user_data->icon_data) {
-            free(user_data->icon_data);
-        }
+        icon_cache_release(user_data->icon_buf);
         free(user_data);
     }
 }
@@ -103,7 +157,7 @@ static void card_delete_event_handler(lv_event_t * e) {
 // ... (rest of app_card.c is unchanged)
 static void card_click_event_handler(lv_event_t * e) {
     card_user_data_t* user_data = (card_user_data_t*)lv_event_get_user_data(e);
-    if (user_data) {
+    if (user_data && user_data->slug) {
         create_app_detail_view(user_data->slug, user_data->revision);
     }
 }
@@ -4,18 +4,41 @@
 #include "badgehub_client.h"
 #include "lvgl/lvgl.h"
 
+// Card geometry, shared with the virtualized list that positions the cards.
+#define APP_CARD_HEIGHT 80
+
+// The strings point into the project page the card is bound to; that page must
+// outlive the binding.
 typedef struct {
-    char* slug;
+    const char* slug;
     int revision;
-    char* icon_url; // Store the URL for on-demand loading
-    uint8_t* icon_data;
-    lv_image_dsc_t icon_dsc;
+    const char* icon_url; // Store the URL for on-demand loading
+    const lv_draw_buf_t* icon_buf; // Decoded icon pinned in the icon cache
 } card_user_data_t;
 
 void create_app_card(lv_obj_t* parent, const project_t* project);
 
 /**
- * @brief Triggers the download and display of the icon for a specific card.
+ * @brief Creates a hidden card that is not bound to a project yet, for lists that
+ * recycle their cards. Show it with app_card_bind().
+ *
+ * Unlike create_app_card(), the card does not handle arrow keys; its list does.
+ */
+lv_obj_t* app_card_create(lv_obj_t* parent);
+
+/**
+ * @brief Rebinds a card to another project, or hides it if project is NULL.
+ *
+ * Cancels the icon download of the previous project and unpins its icon. The title
+ * references the project's name without copying it.
+ */
+void app_card_bind(lv_obj_t* card, const project_t* project);
+
+/**
+ * @brief Schedules the download of the icon for a specific card.
+ *
+ * The download runs concurrently with other icon requests; the icon is shown
+ * as soon as it arrives. Pending downloads are cancelled when the card is deleted.
  * @param card A pointer to the card object.
  */
 void app_card_load_icon(lv_obj_t* card);
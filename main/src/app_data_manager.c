@@ -15,6 +15,8 @@ static int current_offset = 0;
 static bool is_fetching = false;
 static bool end_of_list_reached = false;
 static int total_pages = -1;
+static project_t *current_projects = NULL; // Kept alive while its cards are shown
+static int current_project_count = 0;
 
 // --- UI Pointers (set by the fetch function) ---
 static lv_obj_t *current_list_container = NULL;
@@ -28,8 +30,14 @@ void data_manager_init(void) {
     total_pages = -1;
 }
 
+static void release_current_projects(void) {
+    free_applications(current_projects, current_project_count);
+    current_projects = NULL;
+    current_project_count = 0;
+}
+
 void data_manager_deinit(void) {
-    // Nothing to do here currently, as memory is managed per-page.
+    release_current_projects();
 }
 
 void data_manager_request_next_page(void) {
@@ -68,7 +76,9 @@ void data_manager_fetch_page(lv_obj_t* list_container, lv_obj_t* page_indicator,
         lv_obj_add_flag(search_bar, LV_OBJ_FLAG_HIDDEN);
     }
 
+    // The cards reference the page they were created from, so drop them first.
     lv_obj_clean(list_container);
+    release_current_projects();
     lv_obj_t *spinner = lv_spinner_create(list_container);
     lv_obj_center(spinner);
     lv_refr_now(NULL);
@@ -76,6 +86,8 @@ void data_manager_fetch_page(lv_obj_t* list_container, lv_obj_t* page_indicator,
     const char *query = lv_textarea_get_text(search_bar);
     int project_count = 0;
     project_t *projects = get_applications(&project_count, query, ITEMS_PER_PAGE, offset);
+    current_projects = projects;
+    current_project_count = project_count;
 
     lv_obj_clean(list_container);
     create_app_list_view(list_container, projects, project_count);
@@ -107,7 +119,6 @@ void data_manager_fetch_page(lv_obj_t* list_container, lv_obj_t* page_indicator,
         } else {
              lv_group_focus_obj(search_bar);
         }
-        free_applications(projects, project_count);
     }
 
     is_fetching = false;
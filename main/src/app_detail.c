@@ -1,24 +1,36 @@
 #include "app_detail.h"
 #include "app_home.h"
 #include "badgehub_client.h"
+#include "install_manager.h"
 #include "lvgl/lvgl.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <sys/stat.h>
-#include <errno.h>
 
-#define INSTALLATION_DIR "installation_dir"
-
-// ... (forward declarations and other functions are unchanged)
 static void back_button_event_handler(lv_event_t * e);
 static void install_button_event_handler(lv_event_t * e);
 static void detail_view_delete_event_handler(lv_event_t * e);
+static void details_free_event_handler(lv_event_t * e);
+static void nav_free_event_handler(lv_event_t * e);
 static void detail_key_event_handler(lv_event_t * e);
+static void details_loaded_cb(project_detail_t *details, void *user_data);
+static void install_progress_cb(const install_progress_t *progress, void *user_data);
+static void show_install_progress(const install_progress_t *progress);
 typedef struct { lv_obj_t *btn_back; lv_obj_t *btn_install; } detail_nav_t;
 
+// --- STATIC STATE VARIABLES ---
+static lv_obj_t *s_container = NULL;
+static lv_obj_t *s_btn_back = NULL;
+static lv_obj_t *s_loading_label = NULL;
+static lv_obj_t *s_loading_spinner = NULL;
+static http_request_t *s_details_request = NULL;
+// The project shown and its install widgets, NULL until its details have loaded.
+static project_detail_t *s_details = NULL;
+static lv_obj_t *s_btn_install = NULL;
+static lv_obj_t *s_install_bar = NULL;
+static lv_obj_t *s_status_label = NULL;
+
 void create_app_detail_view(const char* slug, int revision) {
-    // ... (this function is unchanged)
     char local_slug[256];
     if (slug) { strncpy(local_slug, slug, sizeof(local_slug) - 1); local_slug[sizeof(local_slug) - 1] = '\0'; } else { local_slug[0] = '\0'; }
     int local_revision = revision;
@@ -27,19 +39,43 @@ void create_app_detail_view(const char* slug, int revision) {
     lv_obj_set_size(container, lv_pct(100), lv_pct(100));
     lv_obj_set_flex_flow(container, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(container, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_START);
+    lv_obj_add_event_cb(container, detail_view_delete_event_handler, LV_EVENT_DELETE, NULL);
     lv_obj_t* btn_back = lv_btn_create(container);
     lv_obj_add_event_cb(btn_back, back_button_event_handler, LV_EVENT_CLICKED, NULL);
     lv_obj_t* label_back = lv_label_create(btn_back);
     lv_label_set_text(label_back, "Back to List");
     lv_obj_set_style_margin_bottom(btn_back, 10, 0);
+    lv_group_add_obj(lv_group_get_default(), btn_back);
     lv_obj_t* loading_label = lv_label_create(container);
     lv_label_set_text(loading_label, "Loading details...");
     lv_obj_align(loading_label, LV_ALIGN_CENTER, 0, 0);
-    lv_refr_now(NULL);
-    project_detail_t* details = get_project_details(local_slug, local_revision);
-    lv_obj_del(loading_label);
+    lv_obj_t* loading_spinner = lv_spinner_create(container);
+    lv_obj_set_size(loading_spinner, 48, 48);
+
+    s_container = container;
+    s_btn_back = btn_back;
+    s_loading_label = loading_label;
+    s_loading_spinner = loading_spinner;
+    s_details_request = get_project_details_async(local_slug, local_revision, details_loaded_cb, NULL);
+    if (!s_details_request) {
+        details_loaded_cb(NULL, NULL);
+    }
+}
+
+bool app_detail_is_loading(void) {
+    return s_details_request != NULL;
+}
+
+static void details_loaded_cb(project_detail_t *details, void *user_data) {
+    s_details_request = NULL;
+    lv_obj_t* container = s_container;
+    lv_obj_t* btn_back = s_btn_back;
+    lv_obj_del(s_loading_label);
+    lv_obj_del(s_loading_spinner);
+    s_loading_label = NULL;
+    s_loading_spinner = NULL;
     if (details) {
-        lv_obj_add_event_cb(container, detail_view_delete_event_handler, LV_EVENT_DELETE, details);
+        lv_obj_add_event_cb(container, details_free_event_handler, LV_EVENT_DELETE, details);
         lv_obj_t* title_label = lv_label_create(container);
         lv_label_set_text_fmt(title_label, "Name: %s (rev %d)", details->name, details->revision);
         lv_obj_set_width(title_label, lv_pct(95));
@@ -64,9 +100,18 @@ void create_app_detail_view(const char* slug, int revision) {
         lv_obj_set_width(status_label, lv_pct(95));
         lv_label_set_long_mode(status_label, LV_LABEL_LONG_WRAP);
         lv_obj_set_style_margin_top(status_label, 10, 0);
-        lv_obj_set_user_data(btn_install, status_label);
+        lv_obj_t* install_bar = lv_bar_create(container);
+        lv_obj_set_width(install_bar, lv_pct(95));
+        lv_obj_add_flag(install_bar, LV_OBJ_FLAG_HIDDEN);
+        s_details = details;
+        s_btn_install = btn_install;
+        s_install_bar = install_bar;
+        s_status_label = status_label;
+        // Installs outlive this view; pick up one started on an earlier visit.
+        install_manager_set_listener(install_progress_cb, NULL);
+        install_progress_t progress;
+        if (install_manager_get_progress(details->slug, &progress)) show_install_progress(&progress);
         lv_group_t * g = lv_group_get_default();
-        lv_group_add_obj(g, btn_back);
         lv_group_add_obj(g, btn_install);
         detail_nav_t *nav_data = malloc(sizeof(detail_nav_t));
         if (nav_data) {
@@ -75,7 +120,7 @@ void create_app_detail_view(const char* slug, int revision) {
             lv_obj_add_event_cb(btn_back, detail_key_event_handler, LV_EVENT_KEY, nav_data);
             lv_obj_add_event_cb(btn_install, detail_key_event_handler, LV_EVENT_KEY, nav_data);
         }
-        lv_obj_add_event_cb(container, detail_view_delete_event_handler, LV_EVENT_DELETE, nav_data);
+        lv_obj_add_event_cb(container, nav_free_event_handler, LV_EVENT_DELETE, nav_data);
     } else {
         lv_obj_t* error_label = lv_label_create(container);
         lv_label_set_text(error_label, "Failed to load project details.");
@@ -83,47 +128,84 @@ void create_app_detail_view(const char* slug, int revision) {
 }
 
 static void install_button_event_handler(lv_event_t * e) {
-    lv_obj_t* btn = lv_event_get_target(e);
     project_detail_t* details = (project_detail_t*)lv_event_get_user_data(e);
-    lv_obj_t* status_label = (lv_obj_t*)lv_obj_get_user_data(btn);
-    if (!details || !status_label) return;
-    lv_obj_add_state(btn, LV_STATE_DISABLED);
-    lv_label_set_text(status_label, "Starting installation...");
-    lv_refr_now(NULL);
-    char project_dir_path[512];
-    snprintf(project_dir_path, sizeof(project_dir_path), "%s/%s", INSTALLATION_DIR, details->slug);
-    if (mkdir(INSTALLATION_DIR, 0755) != 0 && errno != EEXIST) {
-        lv_label_set_text_fmt(status_label, "Error: Could not create directory '%s'", INSTALLATION_DIR);
-        lv_obj_clear_state(btn, LV_STATE_DISABLED);
-        return;
+    if (!details || install_manager_get_progress(details->slug, NULL)) return;
+    // The manager copies the file list, so the install continues if this view goes away.
+    // Reinstalling an app only fetches the files that changed.
+    if (!install_manager_install(details, INSTALL_MODE_INCREMENTAL)) {
+        lv_label_set_text(s_status_label, "Error: Could not start installation");
     }
-    if (mkdir(project_dir_path, 0755) != 0 && errno != EEXIST) {
-        lv_label_set_text_fmt(status_label, "Error: Could not create directory '%s'", project_dir_path);
-        lv_obj_clear_state(btn, LV_STATE_DISABLED);
-        return;
+}
+
+static void install_progress_cb(const install_progress_t *progress, void *user_data) {
+    if (!s_details || strcmp(progress->slug, s_details->slug) != 0) return;
+    show_install_progress(progress);
+}
+
+// Reflects the state of this project's install in the button, bar and status label.
+static void show_install_progress(const install_progress_t *progress) {
+    bool busy = progress->status == INSTALL_STATUS_QUEUED || progress->status == INSTALL_STATUS_RUNNING;
+    if (busy) {
+        lv_obj_add_state(s_btn_install, LV_STATE_DISABLED);
+        lv_obj_clear_flag(s_install_bar, LV_OBJ_FLAG_HIDDEN);
+        lv_bar_set_range(s_install_bar, 0, progress->files_total > 0 ? progress->files_total : 1);
+        lv_bar_set_value(s_install_bar, progress->files_done, LV_ANIM_OFF);
+    } else {
+        lv_obj_clear_state(s_btn_install, LV_STATE_DISABLED);
+        lv_obj_add_flag(s_install_bar, LV_OBJ_FLAG_HIDDEN);
     }
-    bool all_successful = true;
-    for (int i = 0; i < details->file_count; i++) {
-        lv_label_set_text_fmt(status_label, "Downloading (%d/%d): %s",
-                              i + 1, details->file_count, details->files[i].full_path);
-        lv_refr_now(NULL);
-        // --- CHANGED: Call the simplified download function ---
-        if (!download_project_file(&details->files[i], details->slug)) {
-            lv_label_set_text_fmt(status_label, "Error: Failed to download %s", details->files[i].full_path);
-            all_successful = false;
-            break;
+    switch (progress->status) {
+    case INSTALL_STATUS_QUEUED:
+        lv_label_set_text(s_status_label, "Waiting for other installs...");
+        break;
+    case INSTALL_STATUS_RUNNING:
+        if (progress->current_file) {
+            lv_label_set_text_fmt(s_status_label, "Downloading (%d/%d, %lu KiB): %s", progress->files_done,
+                                  progress->files_total, (unsigned long)(progress->bytes_done / 1024), progress->current_file);
+        } else {
+            lv_label_set_text(s_status_label, "Starting installation...");
         }
-    }
-    if (all_successful) {
-        lv_label_set_text(status_label, "Installation complete!");
-    } else {
-        lv_obj_clear_state(btn, LV_STATE_DISABLED);
+        break;
+    case INSTALL_STATUS_COMPLETE:
+        if (progress->files_skipped > 0 || progress->files_removed > 0) {
+            lv_label_set_text_fmt(s_status_label, "Installation complete! %d of %d files up to date (%lu KiB not downloaded), %d removed",
+                                  progress->files_skipped, progress->files_total,
+                                  (unsigned long)(progress->bytes_skipped / 1024), progress->files_removed);
+        } else {
+            lv_label_set_text(s_status_label, "Installation complete!");
+        }
+        break;
+    case INSTALL_STATUS_FAILED:
+        lv_label_set_text_fmt(s_status_label, "Error: %s (%s)",
+                              progress->error ? progress->error : "installation failed",
+                              progress->failed_file ? progress->failed_file : "project files");
+        break;
+    case INSTALL_STATUS_CANCELLED:
+        lv_label_set_text(s_status_label, "Installation cancelled");
+        break;
     }
 }
 
-// ... (rest of app_detail.c is unchanged)
 static void back_button_event_handler(lv_event_t * e) { create_app_home_view(); }
-static void detail_view_delete_event_handler(lv_event_t * e) { void* user_data = lv_event_get_user_data(e); if (user_data) { free(user_data); } }
+static void detail_view_delete_event_handler(lv_event_t * e) {
+    // Abort any network work that still references this view.
+    if (s_details_request) {
+        http_async_cancel(s_details_request);
+        s_details_request = NULL;
+    }
+    // A running install keeps going; only stop reporting to this view.
+    install_manager_set_listener(NULL, NULL);
+    s_details = NULL;
+    s_btn_install = NULL;
+    s_install_bar = NULL;
+    s_status_label = NULL;
+    s_container = NULL;
+    s_btn_back = NULL;
+    s_loading_label = NULL;
+    s_loading_spinner = NULL;
+}
+static void details_free_event_handler(lv_event_t * e) { free_project_details((project_detail_t*)lv_event_get_user_data(e)); }
+static void nav_free_event_handler(lv_event_t * e) { void* user_data = lv_event_get_user_data(e); if (user_data) { free(user_data); } }
 static void detail_key_event_handler(lv_event_t * e) {
     uint32_t key = lv_indev_get_key(lv_indev_active());
     lv_obj_t * focused_btn = lv_event_get_target(e);
@@ -1,6 +1,8 @@
 #ifndef APP_DETAIL_H
 #define APP_DETAIL_H
 
+#include <stdbool.h>
+
 /**
  * @brief Creates the application detail view for a given project slug and revision.
  *
@@ -12,4 +14,9 @@
  */
 void create_app_detail_view(const char* slug, int revision);
 
+/**
+ * @brief Returns whether the detail view is still waiting for the project details.
+ */
+bool app_detail_is_loading(void);
+
 #endif // APP_DETAIL_H
@@ -1,7 +1,13 @@
 #include "app_home.h"
 #include "app_list.h"
 #include "badgehub_client.h"
-#include "app_card.h"
+#include "catalog_snapshot.h"
+#include "catalog_window.h"
+#include "icon_cache.h"
+#include "icon_loader.h"
+#include "install_manager.h"
+#include "page_cache.h"
+#include "update_checker.h"
 #include "lvgl/lvgl.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -14,12 +20,31 @@
 static lv_obj_t *list_container;
 static lv_obj_t *search_bar;
 static lv_obj_t *page_indicator_label;
+static lv_obj_t *s_mode_label = NULL;
+static lv_obj_t *s_update_all_btn = NULL;
+static lv_obj_t *s_update_all_label = NULL;
 static lv_timer_t *search_timer = NULL;
-static lv_timer_t *icon_loader_timer = NULL; // Timer to orchestrate icon downloads
-static int icon_loader_index = 0; // Which icon to download next
 
-static project_t *s_current_page_projects = NULL;
-static int s_current_page_project_count = 0;
+static page_cache_entry_t *s_current_page = NULL; // Page on screen, pinned in the page cache
+
+static http_request_t *s_fetch_request = NULL; // In-flight page request, if any
+static char *s_fetch_query = NULL;
+static int s_fetch_offset = 0;
+static bool s_fetch_focus_last = false;
+
+static http_request_t *s_prefetch_request = NULL; // In-flight prefetch of the next page, if any
+static char *s_prefetch_query = NULL;
+static int s_prefetch_offset = 0;
+static bool s_show_prefetch = false; // Display the prefetched page once it arrives
+
+static bool s_continuous = false; // Scroll through the whole catalog instead of paging
+static int s_visible_first = 0;  // Rows on screen in continuous mode
+static int s_visible_last = 0;
+
+static bool s_local_search = false; // Showing matches from the snapshot's search index
+static int *s_search_results = NULL; // Their positions in the snapshot
+static int s_search_result_count = 0;
+static int s_search_capacity = 0;
 
 static int current_offset = 0;
 static bool is_fetching = false;
@@ -31,8 +56,32 @@ static void search_timer_cb(lv_timer_t *timer);
 static void search_bar_event_cb(lv_event_t *e);
 static void search_bar_key_event_cb(lv_event_t *e);
 static void home_view_delete_event_cb(lv_event_t *e);
+static void start_browsing(void);
+static void start_catalog(void);
+static void stop_paging(void);
+static bool show_local_results(void);
+static const project_t *search_item_cb(int index, void *user_data);
+static void search_visible_cb(int first, int last, void *user_data);
+static const project_t *catalog_item_cb(int index, void *user_data);
+static void catalog_visible_cb(int first, int last, void *user_data);
+static void catalog_changed_cb(void *user_data);
+static void snapshot_synced_cb(bool success, void *user_data);
+static void update_catalog_indicator(void);
 static void fetch_and_display_page(int offset, bool focus_last);
-static void icon_loader_timer_cb(lv_timer_t *timer);
+static void page_fetched_cb(project_t *projects, int project_count, bool success, void *user_data);
+static void show_page(page_cache_entry_t *page);
+static void release_current_page(void);
+static void set_query(char **dest, const char *query);
+static void prefetch_page(int offset);
+static void prefetch_fetched_cb(project_t *projects, int project_count, bool success, void *user_data);
+static void prefetch_icons(const page_cache_entry_t *page);
+static void prefetched_icon_cb(const char *icon_url, const uint8_t *data, size_t size, void *owner);
+static void refresh_update_all_button(void);
+static void update_checker_changed_cb(bool success, void *user_data);
+static void install_progress_cb(const install_progress_t *progress, void *user_data);
+static void update_all_event_cb(lv_event_t *e);
+static void refresh_mode_button(void);
+static void mode_event_cb(lv_event_t *e);
 
 // --- IMPLEMENTATIONS ---
 
@@ -58,32 +107,59 @@ void create_app_home_view(void) {
     lv_obj_add_event_cb(search_bar, search_bar_key_event_cb, LV_EVENT_KEY, NULL);
     lv_group_add_obj(lv_group_get_default(), search_bar);
 
-    list_container = lv_obj_create(main_container);
+    // The list recycles its cards across pages instead of recreating them.
+    list_container = app_list_create(main_container);
     lv_obj_set_width(list_container, lv_pct(100));
     lv_obj_set_flex_grow(list_container, 1);
-    lv_obj_set_flex_flow(list_container, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_flex_align(list_container, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
 
     page_indicator_label = lv_label_create(main_container);
     lv_obj_set_width(page_indicator_label, lv_pct(95));
     lv_obj_set_style_text_align(page_indicator_label, LV_TEXT_ALIGN_CENTER, 0);
 
-    fetch_and_display_page(0, false);
+    lv_obj_t *mode_btn = lv_button_create(main_container);
+    lv_obj_add_event_cb(mode_btn, mode_event_cb, LV_EVENT_CLICKED, NULL);
+    lv_group_add_obj(lv_group_get_default(), mode_btn);
+    s_mode_label = lv_label_create(mode_btn);
+    refresh_mode_button();
+
+    s_update_all_btn = lv_button_create(main_container);
+    lv_obj_add_event_cb(s_update_all_btn, update_all_event_cb, LV_EVENT_CLICKED, NULL);
+    lv_group_add_obj(lv_group_get_default(), s_update_all_btn);
+    s_update_all_label = lv_label_create(s_update_all_btn);
+    update_checker_set_listener(update_checker_changed_cb, NULL);
+    install_manager_set_listener(install_progress_cb, NULL);
+    update_checker_refresh(false);
+    refresh_update_all_button();
+
+    current_offset = 0;
+    start_browsing();
+    // The rows shown so far may come from the snapshot; bring it up to date.
+    catalog_snapshot_set_listener(snapshot_synced_cb, NULL);
+    catalog_snapshot_sync(false);
+}
+
+void app_home_set_continuous_scroll(bool enabled) {
+    s_continuous = enabled;
 }
 
 void app_home_show_next_page(void) {
-    if (is_fetching || end_of_list_reached) return;
+    if (s_continuous || is_fetching || end_of_list_reached) return;
     current_offset += ITEMS_PER_PAGE;
     fetch_and_display_page(current_offset, false);
 }
 
 void app_home_show_previous_page(void) {
-    if (is_fetching || current_offset == 0) return;
+    if (s_continuous || is_fetching || current_offset == 0) return;
     current_offset -= ITEMS_PER_PAGE;
     if (current_offset < 0) current_offset = 0;
     fetch_and_display_page(current_offset, true);
 }
 
+bool app_home_is_loading(void) {
+    if (s_local_search) return false;
+    return s_continuous ? catalog_window_is_loading() : is_fetching;
+}
+
 void app_home_focus_search_and_start_typing(uint32_t key) {
     if (!search_bar) return;
     current_offset = 0;
@@ -93,33 +169,174 @@ void app_home_focus_search_and_start_typing(uint32_t key) {
     search_bar_event_cb(NULL);
 }
 
+// Shows the results for the search bar's query from the top, in the current mode.
+static void start_browsing(void) {
+    if (s_continuous) {
+        start_catalog();
+    } else {
+        fetch_and_display_page(current_offset, false);
+        catalog_window_stop();
+    }
+}
+
+// Drops the page on screen and the fetch of the next one.
+static void stop_paging(void) {
+    if (s_fetch_request) {
+        http_async_cancel(s_fetch_request);
+        s_fetch_request = NULL;
+    }
+    s_show_prefetch = false;
+    is_fetching = false;
+    // The cards reference the previous results; unbind them before those are released.
+    app_list_set_loading(list_container);
+    release_current_page();
+}
+
+static void start_catalog(void) {
+    stop_paging();
+    s_local_search = false;
+    s_visible_first = s_visible_last = 0;
+    catalog_window_start(lv_textarea_get_text(search_bar), catalog_changed_cb, NULL);
+    app_list_set_source(list_container, catalog_window_count(), catalog_item_cb, catalog_visible_cb, NULL);
+    update_catalog_indicator();
+    lv_group_focus_obj(search_bar);
+}
+
+static const project_t *catalog_item_cb(int index, void *user_data) {
+    return catalog_window_get(index);
+}
+
+// The list scrolled: slide the window of loaded chunks along.
+static void catalog_visible_cb(int first, int last, void *user_data) {
+    s_visible_first = first;
+    s_visible_last = last;
+    catalog_window_set_visible(first, last);
+    update_catalog_indicator();
+}
+
+static void catalog_changed_cb(void *user_data) {
+    app_list_set_count(list_container, catalog_window_count());
+    app_list_refresh_items(list_container);
+    update_catalog_indicator();
+}
+
+// Shows the snapshot's matches for the search bar's query, found by its local
+// index within the frame. Returns false if there is nothing to search locally.
+static bool show_local_results(void) {
+    const char *query = lv_textarea_get_text(search_bar);
+    int capacity = catalog_snapshot_count();
+    if (!s_continuous || !query[0] || capacity == 0) return false;
+    if (capacity > s_search_capacity) {
+        int *results = realloc(s_search_results, capacity * sizeof(int));
+        if (!results) return false;
+        s_search_results = results;
+        s_search_capacity = capacity;
+    }
+    int count = catalog_snapshot_search(query, s_search_results, s_search_capacity);
+    if (count < 0) return false;
+
+    stop_paging();
+    catalog_window_stop();
+    s_local_search = true;
+    s_search_result_count = count < s_search_capacity ? count : s_search_capacity;
+    s_visible_first = s_visible_last = 0;
+    app_list_set_source(list_container, s_search_result_count, search_item_cb, search_visible_cb, NULL);
+    update_catalog_indicator();
+    return true;
+}
+
+static const project_t *search_item_cb(int index, void *user_data) {
+    if (index < 0 || index >= s_search_result_count) return NULL;
+    return catalog_snapshot_get(s_search_results[index]);
+}
+
+static void search_visible_cb(int first, int last, void *user_data) {
+    s_visible_first = first;
+    s_visible_last = last;
+    update_catalog_indicator();
+}
+
+// A sync replaced the snapshot: rebind the rows that still show the previous one.
+static void snapshot_synced_cb(bool success, void *user_data) {
+    if (!success) return;
+    update_checker_refresh(true); // Against the new snapshot, without paging the server
+    if (!s_continuous) return;
+    if (!s_local_search) {
+        catalog_changed_cb(NULL);
+    } else if (!show_local_results()) {
+        start_browsing(); // Ask the server instead
+    }
+}
+
+static void update_catalog_indicator(void) {
+    int count = s_local_search ? s_search_result_count : catalog_window_count();
+    if (count == 0 || s_visible_last == 0) {
+        lv_label_set_text(page_indicator_label, "");
+    } else if (s_local_search || catalog_window_end_reached()) {
+        lv_label_set_text_fmt(page_indicator_label, "Apps %d-%d / %d", s_visible_first + 1, s_visible_last, count);
+    } else {
+        lv_label_set_text_fmt(page_indicator_label, "Apps %d-%d / ?", s_visible_first + 1, s_visible_last);
+    }
+}
+
 static void fetch_and_display_page(int offset, bool focus_last) {
-    if (is_fetching) return;
+    // A newer fetch (e.g. a new search) supersedes the one still in flight.
+    if (s_fetch_request) {
+        http_async_cancel(s_fetch_request);
+        s_fetch_request = NULL;
+    }
+    s_show_prefetch = false;
     is_fetching = true;
 
-    if (icon_loader_timer) {
-        lv_timer_del(icon_loader_timer);
-        icon_loader_timer = NULL;
+    // Unbinding the cards also cancels their pending icon downloads.
+    app_list_set_loading(list_container);
+    release_current_page();
+
+    s_fetch_offset = offset;
+    s_fetch_focus_last = focus_last;
+    set_query(&s_fetch_query, lv_textarea_get_text(search_bar));
+
+    page_cache_entry_t *cached = page_cache_acquire(s_fetch_query, offset, ITEMS_PER_PAGE);
+    if (cached) {
+        show_page(cached);
+        return;
     }
 
-    lv_obj_clean(list_container);
-    lv_obj_t *spinner = lv_spinner_create(list_container);
-    lv_obj_center(spinner);
-    lv_refr_now(NULL);
+    // The page may already be on its way as a prefetch; wait for it instead of asking twice.
+    if (s_prefetch_request && s_prefetch_offset == offset && strcmp(s_prefetch_query, s_fetch_query) == 0) {
+        s_show_prefetch = true;
+        return;
+    }
 
-    if (s_current_page_projects) {
-        free_applications(s_current_page_projects, s_current_page_project_count);
-        s_current_page_projects = NULL;
+    s_fetch_request = get_applications_async(s_fetch_query, ITEMS_PER_PAGE, offset, page_fetched_cb, NULL);
+    if (!s_fetch_request) {
+        page_fetched_cb(NULL, 0, false, NULL);
     }
+}
 
-    const char *query = lv_textarea_get_text(search_bar);
-    s_current_page_projects = get_applications(&s_current_page_project_count, query, ITEMS_PER_PAGE, offset);
+static void page_fetched_cb(project_t *projects, int project_count, bool success, void *user_data) {
+    s_fetch_request = NULL;
+    page_cache_entry_t *page = NULL;
+    if (success) {
+        page = page_cache_insert(s_fetch_query, s_fetch_offset, ITEMS_PER_PAGE, projects, project_count);
+    } else {
+        free_applications(projects, project_count);
+    }
+    show_page(page);
+}
+
+// Renders a page (NULL for a failed fetch) and takes over the caller's pin on it.
+static void show_page(page_cache_entry_t *page) {
+    s_current_page = page;
+    int offset = s_fetch_offset;
+    bool focus_last = s_fetch_focus_last;
+    project_t *projects = page ? page->projects : NULL;
+    int project_count = page ? page->project_count : 0;
 
-    lv_obj_clean(list_container);
-    create_app_list_view(list_container, s_current_page_projects, s_current_page_project_count);
+    app_list_set_projects(list_container, projects, project_count);
 
     int current_page = (offset / ITEMS_PER_PAGE) + 1;
-    if (s_current_page_project_count < ITEMS_PER_PAGE) {
+    if (project_count < ITEMS_PER_PAGE) {
         end_of_list_reached = true;
         total_pages = current_page;
     } else {
@@ -132,78 +349,209 @@ static void fetch_and_display_page(int offset, bool focus_last) {
         lv_label_set_text_fmt(page_indicator_label, "Page %d / ?", current_page);
     }
 
-    if (s_current_page_projects && s_current_page_project_count > 0) {
-        lv_obj_t* target_to_focus = NULL;
-        if (focus_last) {
-            target_to_focus = lv_obj_get_child(list_container, s_current_page_project_count - 1);
-            lv_obj_scroll_to_view(target_to_focus, LV_ANIM_OFF);
-        } else {
-            target_to_focus = search_bar;
-        }
-        lv_group_focus_obj(target_to_focus);
-
-        // --- NEW: Start the sequential icon loader ---
-        icon_loader_index = 0;
-        icon_loader_timer = lv_timer_create(icon_loader_timer_cb, 10, NULL);
-    } else {
-         lv_group_focus_obj(search_bar);
+    // The list loads the icons of the cards it shows.
+    if (!focus_last || !app_list_focus_item(list_container, project_count - 1, LV_ANIM_OFF)) {
+        lv_group_focus_obj(search_bar);
     }
 
     is_fetching = false;
+
+    if (!end_of_list_reached) {
+        prefetch_page(offset + ITEMS_PER_PAGE);
+    }
 }
 
-static void icon_loader_timer_cb(lv_timer_t *timer) {
-    if (is_fetching) return; // Don't load icons while fetching a new page
+static void release_current_page(void) {
+    if (s_current_page) {
+        page_cache_release(s_current_page);
+        s_current_page = NULL;
+    }
+}
 
-    if (icon_loader_index >= s_current_page_project_count) {
-        lv_timer_del(icon_loader_timer); // All icons loaded for this page
-        icon_loader_timer = NULL;
+static void set_query(char **dest, const char *query) {
+    free(*dest);
+    *dest = strdup(query ? query : "");
+}
+
+// Speculatively fetches the page after the one on screen, together with its icons.
+static void prefetch_page(int offset) {
+    page_cache_entry_t *cached = page_cache_acquire(s_fetch_query, offset, ITEMS_PER_PAGE);
+    if (cached) {
+        prefetch_icons(cached);
+        page_cache_release(cached);
         return;
     }
+    if (s_prefetch_request) {
+        if (s_prefetch_offset == offset && strcmp(s_prefetch_query, s_fetch_query) == 0) return;
+        http_async_cancel(s_prefetch_request);
+        s_prefetch_request = NULL;
+    }
+    s_prefetch_offset = offset;
+    set_query(&s_prefetch_query, s_fetch_query);
+    s_prefetch_request = get_applications_async(s_prefetch_query, ITEMS_PER_PAGE, offset, prefetch_fetched_cb, NULL);
+}
+
+static void prefetch_fetched_cb(project_t *projects, int project_count, bool success, void *user_data) {
+    s_prefetch_request = NULL;
+    page_cache_entry_t *page = NULL;
+    if (success) {
+        page = page_cache_insert(s_prefetch_query, s_prefetch_offset, ITEMS_PER_PAGE, projects, project_count);
+    } else {
+        free_applications(projects, project_count);
+    }
+    if (page) {
+        prefetch_icons(page);
+    }
+
+    if (s_show_prefetch) {
+        // The user already navigated to this page and is looking at a spinner.
+        s_show_prefetch = false;
+        show_page(page);
+    } else {
+        page_cache_release(page);
+    }
+}
+
+static void prefetch_icons(const page_cache_entry_t *page) {
+    for (int i = 0; i < page->project_count; i++) {
+        const char *icon_url = page->projects[i].icon_url;
+        if (!icon_url || !icon_url[0]) continue;
+        const lv_draw_buf_t *cached = icon_cache_acquire(icon_url);
+        if (cached) {
+            icon_cache_release(cached);
+            continue;
+        }
+        icon_loader_request(icon_url, prefetched_icon_cb, NULL);
+    }
+}
+
+// Decodes a prefetched icon into the icon cache so the next page renders it immediately.
+static void prefetched_icon_cb(const char *icon_url, const uint8_t *data, size_t size, void *owner) {
+    icon_cache_release(icon_cache_insert(icon_url, data, size));
+}
 
-    lv_obj_t* card = lv_obj_get_child(list_container, icon_loader_index);
-    if (card) {
-        app_card_load_icon(card); // Tell the card to download its icon
+// Shows "Update all" while installed apps have newer revisions that are not being installed yet.
+static void refresh_update_all_button(void) {
+    if (!s_update_all_btn) return;
+    int pending = 0;
+    for (int i = 0; i < update_checker_count(); i++) {
+        // An install that just ended is still found while its listener is told.
+        install_progress_t progress;
+        if (!install_manager_get_progress(update_checker_get(i)->slug, &progress) ||
+            progress.status >= INSTALL_STATUS_COMPLETE) {
+            pending++;
+        }
+    }
+    if (update_checker_is_updating()) {
+        lv_label_set_text(s_update_all_label, "Scheduling updates...");
+        lv_obj_add_state(s_update_all_btn, LV_STATE_DISABLED);
+        lv_obj_clear_flag(s_update_all_btn, LV_OBJ_FLAG_HIDDEN);
+    } else if (pending > 0) {
+        lv_label_set_text_fmt(s_update_all_label, LV_SYMBOL_DOWNLOAD " Update all (%d)", pending);
+        lv_obj_clear_state(s_update_all_btn, LV_STATE_DISABLED);
+        lv_obj_clear_flag(s_update_all_btn, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(s_update_all_btn, LV_OBJ_FLAG_HIDDEN);
     }
+}
+
+static void update_checker_changed_cb(bool success, void *user_data) {
+    refresh_update_all_button();
+}
 
-    icon_loader_index++;
+// A finished update drops out of the count; a failed one is pending again.
+static void install_progress_cb(const install_progress_t *progress, void *user_data) {
+    if (progress->status >= INSTALL_STATUS_COMPLETE) refresh_update_all_button();
+}
+
+static void update_all_event_cb(lv_event_t *e) {
+    update_checker_update_all();
+    refresh_update_all_button();
+}
+
+// Names the mode the button switches to.
+static void refresh_mode_button(void) {
+    if (!s_mode_label) return;
+    lv_label_set_text(s_mode_label, s_continuous ? LV_SYMBOL_LIST " Show pages" : LV_SYMBOL_DOWN " Scroll all apps");
+}
+
+// Switches between paging and continuous scrolling, starting over from the top.
+static void mode_event_cb(lv_event_t *e) {
+    app_home_set_continuous_scroll(!s_continuous);
+    refresh_mode_button();
+    if (search_timer) {
+        lv_timer_del(search_timer);
+        search_timer = NULL;
+    }
+    current_offset = 0;
+    total_pages = -1;
+    s_local_search = false;
+    if (!show_local_results()) start_browsing();
 }
 
 static void search_bar_key_event_cb(lv_event_t *e) {
     uint32_t key = lv_indev_get_key(lv_indev_active());
-    if (key == LV_KEY_DOWN && lv_obj_get_child_cnt(list_container) > 0) {
-        lv_obj_t* first_card = lv_obj_get_child(list_container, 0);
-        lv_group_focus_obj(first_card);
-        lv_obj_scroll_to_view(first_card, LV_ANIM_ON);
+    if (key == LV_KEY_DOWN) {
+        app_list_focus_item(list_container, 0, LV_ANIM_ON);
     }
 }
 
 static void search_timer_cb(lv_timer_t *timer) {
+    search_timer = NULL;
+    if (s_local_search && s_search_result_count > 0) {
+        // The local results stand; just make sure the snapshot behind them is recent.
+        catalog_snapshot_sync(false);
+        return;
+    }
     printf("Search timer fired. Starting new search...\n");
     current_offset = 0;
     total_pages = -1;
-    fetch_and_display_page(current_offset, false);
-    search_timer = NULL;
+    start_browsing();
 }
 
 static void search_bar_event_cb(lv_event_t *e) {
-    if (search_timer) lv_timer_del(search_timer);
+    if (search_timer) {
+        lv_timer_del(search_timer);
+        search_timer = NULL;
+    }
+    // Every keystroke is answered from the snapshot when there is one. The server is
+    // only asked once typing pauses, for queries the snapshot has no match for.
+    if (!show_local_results() && s_continuous && !lv_textarea_get_text(search_bar)[0] &&
+        catalog_snapshot_count() > 0) {
+        start_browsing(); // The whole catalog, shown from the snapshot right away
+        return;
+    }
     search_timer = lv_timer_create(search_timer_cb, 1000, NULL);
     lv_timer_set_repeat_count(search_timer, 1);
 }
 
 static void home_view_delete_event_cb(lv_event_t *e) {
+    if (s_fetch_request) {
+        http_async_cancel(s_fetch_request);
+        s_fetch_request = NULL;
+    }
+    if (s_prefetch_request) {
+        http_async_cancel(s_prefetch_request);
+        s_prefetch_request = NULL;
+    }
+    s_show_prefetch = false;
+    is_fetching = false;
     if (search_timer) {
         lv_timer_del(search_timer);
         search_timer = NULL;
     }
-    if (icon_loader_timer) {
-        lv_timer_del(icon_loader_timer);
-        icon_loader_timer = NULL;
-    }
-    if (s_current_page_projects) {
-        free_applications(s_current_page_projects, s_current_page_project_count);
-        s_current_page_projects = NULL;
-    }
+    icon_loader_cancel_all();
+    catalog_window_stop();
+    release_current_page();
+    s_local_search = false;
+    free(s_search_results);
+    s_search_results = NULL;
+    s_search_result_count = s_search_capacity = 0;
+    update_checker_set_listener(NULL, NULL); // Scheduling carries on without the view
+    install_manager_set_listener(NULL, NULL); // So do the installs
+    catalog_snapshot_set_listener(NULL, NULL); // So does the sync
+    s_update_all_btn = NULL;
+    s_update_all_label = NULL;
+    s_mode_label = NULL;
     search_bar = NULL;
 }
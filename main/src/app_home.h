@@ -6,9 +6,29 @@
 void create_app_home_view(void);
 lv_obj_t* get_search_bar(void);
 
+/**
+ * @brief Chooses between browsing the catalog a page at a time (the default) and
+ * scrolling through the whole of it, loaded in chunks as the list scrolls. Takes
+ * effect when the home view is next created or searched; the view also has a
+ * button that switches modes.
+ *
+ * In continuous scroll mode, searches are answered on every keystroke from the
+ * local index of the catalog snapshot, when there is one.
+ */
+void app_home_set_continuous_scroll(bool enabled);
+
+/**
+ * @brief Shows the next or previous page. Does nothing in continuous scroll mode.
+ */
 void app_home_show_next_page(void);
 void app_home_show_previous_page(void);
 
+/**
+ * @brief Returns whether the home view is still waiting for the page it is about to show,
+ * or in continuous scroll mode, for the projects of the rows on screen.
+ */
+bool app_home_is_loading(void);
+
 /**
  * @brief Focuses the search bar and initiates a search with the given key.
  * This is called when a user types a letter while focused on the list.
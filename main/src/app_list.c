@@ -1,6 +1,43 @@
 #include "app_list.h"
 #include "app_card.h"
+#include "app_home.h"
 #include <stdio.h>
+#include <stdlib.h>
+
+// --- CONSTANTS ---
+// Cards beyond the rows that fit the viewport: the two partially visible rows at
+// its top and bottom edges, and one row above and below them so the focus can move
+// there before the list scrolls.
+#define EXTRA_ROWS 4
+#define MAX_CARDS 32
+
+typedef struct {
+    lv_obj_t* obj;
+    lv_obj_t* cards[MAX_CARDS];
+    int card_index[MAX_CARDS];            // Position each card is bound to, -1 if none
+    const project_t* card_item[MAX_CARDS]; // Project shown by each card
+    int card_count;
+    lv_obj_t* spacer;          // Stretches the scrollable area to cover every project
+    lv_obj_t* empty_label;
+    lv_obj_t* spinner;
+    const project_t* projects; // Backs array_item() for app_list_set_projects()
+    int project_count;
+    app_list_item_cb_t get_item;
+    app_list_visible_cb_t visible_cb;
+    void* source_user_data;
+    int first_visible;         // Range last reported to visible_cb
+    int last_visible;
+    bool loading;
+} app_list_t;
+
+// Shown by cards whose project is still loading.
+static const project_t PLACEHOLDER_PROJECT = { .name = "Loading...", .description = "" };
+
+// --- FORWARD DECLARATIONS ---
+static void list_event_cb(lv_event_t* e);
+static void card_key_event_cb(lv_event_t* e);
+
+// --- IMPLEMENTATIONS ---
 
 void create_app_list_view(lv_obj_t* parent, project_t* projects, int project_count) {
     // This function is now purely for rendering cards.
@@ -14,3 +51,298 @@ void create_app_list_view(lv_obj_t* parent, project_t* projects, int project_cou
         lv_obj_center(label);
     }
 }
+
+lv_obj_t* app_list_create(lv_obj_t* parent) {
+    app_list_t* list = calloc(1, sizeof(app_list_t));
+    if (!list) return NULL;
+
+    list->obj = lv_obj_create(parent);
+    lv_obj_set_user_data(list->obj, list);
+    lv_obj_add_event_cb(list->obj, list_event_cb, LV_EVENT_SCROLL, NULL);
+    lv_obj_add_event_cb(list->obj, list_event_cb, LV_EVENT_SIZE_CHANGED, NULL);
+    lv_obj_add_event_cb(list->obj, list_event_cb, LV_EVENT_DELETE, NULL);
+
+    list->spacer = lv_obj_create(list->obj);
+    lv_obj_remove_style_all(list->spacer);
+    lv_obj_set_size(list->spacer, 1, 1);
+    lv_obj_clear_flag(list->spacer, LV_OBJ_FLAG_CLICKABLE);
+
+    list->empty_label = lv_label_create(list->obj);
+    lv_label_set_text_static(list->empty_label, "No applications found.");
+    lv_obj_center(list->empty_label);
+    lv_obj_add_flag(list->empty_label, LV_OBJ_FLAG_HIDDEN);
+
+    list->spinner = lv_spinner_create(list->obj);
+    lv_obj_center(list->spinner);
+    lv_obj_add_flag(list->spinner, LV_OBJ_FLAG_HIDDEN);
+    return list->obj;
+}
+
+static app_list_t* get_list(lv_obj_t* obj) {
+    return obj ? lv_obj_get_user_data(obj) : NULL;
+}
+
+static lv_obj_t* find_card(const app_list_t* list, int index) {
+    for (int i = 0; i < list->card_count; i++) {
+        if (list->card_index[i] == index) return list->cards[i];
+    }
+    return NULL;
+}
+
+static int find_free_slot(app_list_t* list) {
+    for (int i = 0; i < list->card_count; i++) {
+        if (list->card_index[i] < 0) return i;
+    }
+    if (list->card_count == MAX_CARDS) return -1;
+    lv_obj_t* card = app_card_create(list->obj);
+    if (!card) return -1;
+    lv_obj_add_event_cb(card, card_key_event_cb, LV_EVENT_KEY, list);
+    list->cards[list->card_count] = card;
+    list->card_index[list->card_count] = -1;
+    return list->card_count++;
+}
+
+static const project_t* array_item(int index, void* user_data) {
+    const app_list_t* list = user_data;
+    return &list->projects[index];
+}
+
+static void bind_card(app_list_t* list, int slot, int index) {
+    const project_t* item = list->get_item(index, list->source_user_data);
+    lv_obj_t* card = list->cards[slot];
+    list->card_index[slot] = index;
+    list->card_item[slot] = item;
+    app_card_bind(card, item ? item : &PLACEHOLDER_PROJECT);
+    if (item) app_card_load_icon(card);
+}
+
+static bool is_focused(lv_obj_t* card) {
+    lv_group_t* group = lv_obj_get_group(card);
+    return group && lv_group_get_focused(group) == card;
+}
+
+// Unbinds a card and returns whether it had the focus, which then stays on a hidden card.
+static bool unbind_card(app_list_t* list, int slot) {
+    bool focused = is_focused(list->cards[slot]);
+    app_card_bind(list->cards[slot], NULL);
+    list->card_index[slot] = -1;
+    list->card_item[slot] = NULL;
+    return focused;
+}
+
+// Moves the focus off a card that was unbound from position index, to the card of
+// the fully visible row nearest to it, so the keys keep working and the list does
+// not scroll back. Without one, the focus moves on to the next object of the group.
+static void focus_nearest_visible(app_list_t* list, lv_obj_t* unbound, int index) {
+    int32_t scroll_y = lv_obj_get_scroll_y(list->obj);
+    int32_t viewport = lv_obj_get_content_height(list->obj);
+    if (scroll_y < 0) scroll_y = 0;
+    int top = (scroll_y + APP_LIST_ROW_HEIGHT - 1) / APP_LIST_ROW_HEIGHT;
+    int bottom = (scroll_y + viewport - APP_CARD_HEIGHT) / APP_LIST_ROW_HEIGHT;
+    if (bottom < top) bottom = top; // Not even one card fits
+    if (index > bottom) index = bottom;
+    if (index < top) index = top;
+    if (index >= list->project_count) index = list->project_count - 1;
+    lv_obj_t* card = index >= 0 ? find_card(list, index) : NULL;
+    if (card) {
+        lv_group_focus_obj(card);
+    } else if (lv_obj_get_group(unbound)) {
+        lv_group_focus_next(lv_obj_get_group(unbound)); // Skips the hidden cards
+    }
+}
+
+static void unbind_all(app_list_t* list) {
+    int focused = -1;
+    for (int i = 0; i < list->card_count; i++) {
+        if (list->card_index[i] >= 0 && unbind_card(list, i)) focused = i;
+    }
+    if (focused >= 0) focus_nearest_visible(list, list->cards[focused], -1);
+}
+
+static void update_extent(app_list_t* list) {
+    int32_t height = list->project_count * APP_LIST_ROW_HEIGHT - APP_LIST_ROW_GAP;
+    lv_obj_set_pos(list->spacer, 0, height > 0 ? height - 1 : 0);
+    if (list->project_count == 0 && !list->loading) {
+        lv_obj_clear_flag(list->empty_label, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(list->empty_label, LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+// Binds a card to every project in the rows around the viewport and recycles the
+// cards of the rows that scrolled away.
+static void refresh(app_list_t* list) {
+    if (list->loading || list->project_count == 0) return;
+    int32_t viewport = lv_obj_get_content_height(list->obj);
+    if (viewport <= 0) viewport = lv_display_get_vertical_resolution(NULL);
+    int window = viewport / APP_LIST_ROW_HEIGHT + EXTRA_ROWS;
+    if (window > MAX_CARDS) window = MAX_CARDS;
+
+    int32_t scroll_y = lv_obj_get_scroll_y(list->obj);
+    if (scroll_y < 0) scroll_y = 0;
+    int first = scroll_y / APP_LIST_ROW_HEIGHT - 1;
+    if (first > list->project_count - window) first = list->project_count - window;
+    if (first < 0) first = 0;
+    int last = first + window;
+    if (last > list->project_count) last = list->project_count;
+
+    int focused_slot = -1; // A focused card that scrolled away, e.g. by touch
+    int focused_index = -1;
+    for (int i = 0; i < list->card_count; i++) {
+        int index = list->card_index[i];
+        if (index >= 0 && (index < first || index >= last) && unbind_card(list, i)) {
+            focused_slot = i;
+            focused_index = index;
+        }
+    }
+    for (int index = first; index < last; index++) {
+        if (find_card(list, index)) continue;
+        int slot = find_free_slot(list);
+        if (slot < 0) break;
+        bind_card(list, slot, index);
+        lv_obj_align(list->cards[slot], LV_ALIGN_TOP_MID, 0, index * APP_LIST_ROW_HEIGHT);
+    }
+    // Once the rows in view are bound: the card may have been rebound to another
+    // project meanwhile, and the focus must not silently follow it there.
+    if (focused_slot >= 0) focus_nearest_visible(list, list->cards[focused_slot], focused_index);
+
+    // Reported last: the source may change the list from its callback.
+    int first_visible = scroll_y / APP_LIST_ROW_HEIGHT;
+    int last_visible = (scroll_y + viewport + APP_LIST_ROW_HEIGHT - 1) / APP_LIST_ROW_HEIGHT;
+    if (first_visible > list->project_count) first_visible = list->project_count;
+    if (last_visible > list->project_count) last_visible = list->project_count;
+    if (list->visible_cb && (first_visible != list->first_visible || last_visible != list->last_visible)) {
+        list->first_visible = first_visible;
+        list->last_visible = last_visible;
+        list->visible_cb(first_visible, last_visible, list->source_user_data);
+    }
+}
+
+void app_list_set_projects(lv_obj_t* obj, const project_t* projects, int project_count) {
+    app_list_t* list = get_list(obj);
+    if (!list) return;
+    list->projects = projects;
+    app_list_set_source(obj, projects ? project_count : 0, array_item, NULL, list);
+}
+
+void app_list_set_source(lv_obj_t* obj, int project_count, app_list_item_cb_t get_item,
+                         app_list_visible_cb_t visible_cb, void* user_data) {
+    app_list_t* list = get_list(obj);
+    if (!list) return;
+    unbind_all(list);
+    list->project_count = project_count;
+    list->get_item = get_item;
+    list->visible_cb = visible_cb;
+    list->source_user_data = user_data;
+    list->first_visible = list->last_visible = -1;
+    list->loading = false;
+
+    update_extent(list);
+    lv_obj_add_flag(list->spinner, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_update_layout(obj);
+    lv_obj_scroll_to_y(obj, 0, LV_ANIM_OFF);
+    refresh(list);
+}
+
+void app_list_set_count(lv_obj_t* obj, int project_count) {
+    app_list_t* list = get_list(obj);
+    if (!list || list->loading || project_count == list->project_count) return;
+    list->project_count = project_count;
+    int focused_slot = -1;
+    for (int i = 0; i < list->card_count; i++) {
+        if (list->card_index[i] >= project_count && unbind_card(list, i)) focused_slot = i;
+    }
+    update_extent(list);
+    lv_obj_update_layout(obj);
+    refresh(list);
+    if (focused_slot >= 0) focus_nearest_visible(list, list->cards[focused_slot], project_count - 1);
+}
+
+void app_list_refresh_items(lv_obj_t* obj) {
+    app_list_t* list = get_list(obj);
+    if (!list || list->loading) return;
+    for (int i = 0; i < list->card_count; i++) {
+        int index = list->card_index[i];
+        if (index < 0 || list->get_item(index, list->source_user_data) == list->card_item[i]) continue;
+        bind_card(list, i, index);
+    }
+}
+
+void app_list_set_loading(lv_obj_t* obj) {
+    app_list_t* list = get_list(obj);
+    if (!list) return;
+    list->loading = true;
+    unbind_all(list);
+    list->projects = NULL;
+    list->project_count = 0;
+    list->visible_cb = NULL;
+    update_extent(list);
+    lv_obj_clear_flag(list->spinner, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_scroll_to_y(obj, 0, LV_ANIM_OFF);
+}
+
+bool app_list_focus_item(lv_obj_t* obj, int index, lv_anim_enable_t anim) {
+    app_list_t* list = get_list(obj);
+    if (!list || list->loading || index < 0 || index >= list->project_count) return false;
+
+    // A card that is not bound yet is too far away to animate towards; jump there.
+    if (!find_card(list, index)) anim = LV_ANIM_OFF;
+    int32_t top = index * APP_LIST_ROW_HEIGHT;
+    int32_t bottom = top + APP_CARD_HEIGHT;
+    int32_t scroll_y = lv_obj_get_scroll_y(obj);
+    int32_t viewport = lv_obj_get_content_height(obj);
+    if (top < scroll_y) {
+        lv_obj_scroll_to_y(obj, top, anim);
+    } else if (bottom > scroll_y + viewport) {
+        lv_obj_scroll_to_y(obj, bottom - viewport, anim);
+    }
+    refresh(list);
+
+    lv_obj_t* card = find_card(list, index);
+    if (!card) return false;
+    lv_group_focus_obj(card);
+    return true;
+}
+
+static void list_event_cb(lv_event_t* e) {
+    app_list_t* list = get_list(lv_event_get_current_target(e));
+    if (!list) return;
+    if (lv_event_get_code(e) != LV_EVENT_DELETE) {
+        refresh(list);
+    } else {
+        // The cards are deleted after their list and clean up after themselves.
+        lv_obj_set_user_data(list->obj, NULL);
+        free(list);
+    }
+}
+
+static void card_key_event_cb(lv_event_t* e) {
+    app_list_t* list = lv_event_get_user_data(e);
+    uint32_t key = lv_indev_get_key(lv_indev_active());
+    lv_obj_t* card = lv_event_get_target(e);
+    int index = -1;
+    for (int i = 0; i < list->card_count; i++) {
+        if (list->cards[i] == card) index = list->card_index[i];
+    }
+    if (index < 0) return;
+
+    if (key == LV_KEY_UP) {
+        if (index == 0) {
+            app_home_show_previous_page();
+            lv_event_stop_processing(e);
+            return;
+        }
+        app_list_focus_item(list->obj, index - 1, LV_ANIM_ON);
+    } else if (key == LV_KEY_DOWN) {
+        if (index == list->project_count - 1) {
+            app_home_show_next_page();
+            lv_event_stop_processing(e);
+            return;
+        }
+        app_list_focus_item(list->obj, index + 1, LV_ANIM_ON);
+    } else if (key >= ' ' && key < LV_KEY_DEL) {
+        app_home_focus_search_and_start_typing(key);
+    } else if (key == LV_KEY_ESC || key == LV_KEY_BACKSPACE || key == LV_KEY_DEL) {
+        app_home_focus_search_and_start_typing(0);
+    }
+}
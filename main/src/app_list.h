@@ -3,6 +3,11 @@
 
 #include "badgehub_client.h"
 #include "lvgl/lvgl.h"
+#include "app_card.h"
+
+// Vertical space taken by each card of the virtualized list.
+#define APP_LIST_ROW_GAP 10
+#define APP_LIST_ROW_HEIGHT (APP_CARD_HEIGHT + APP_LIST_ROW_GAP)
 
 /**
  * @brief Creates and populates the application list view.
@@ -13,4 +18,64 @@
  */
 void create_app_list_view(lv_obj_t* parent, project_t* projects, int project_count);
 
+/**
+ * @brief Creates a virtualized list of app cards.
+ *
+ * The list keeps a pool of cards sized to its viewport and rebinds them to other
+ * projects as it scrolls or its projects change, so showing another page only
+ * repositions existing objects. Up and down move the focus between cards; past the
+ * first or last card they switch to the previous or next page of the home view.
+ *
+ * @return The scrollable list object. Size it like any other object.
+ */
+lv_obj_t* app_list_create(lv_obj_t* parent);
+
+/**
+ * @brief Shows another set of projects, scrolled to the top, and loads the icons of
+ * the visible cards. An empty set shows "No applications found."
+ *
+ * The projects are referenced, not copied: keep them alive until the next call to
+ * app_list_set_projects() or app_list_set_loading(), or until the list is deleted.
+ */
+void app_list_set_projects(lv_obj_t* list, const project_t* projects, int project_count);
+
+// Returns the project at a position in the list, or NULL while it is not loaded.
+typedef const project_t* (*app_list_item_cb_t)(int index, void* user_data);
+// Called when the range of visible positions [first, last) changes.
+typedef void (*app_list_visible_cb_t)(int first, int last, void* user_data);
+
+/**
+ * @brief Shows project_count projects provided by get_item, scrolled to the top.
+ *
+ * Cards whose project is not loaded show a placeholder until
+ * app_list_refresh_items() finds it. visible_cb, which may be NULL, lets the
+ * source load the projects around the visible rows ahead of the scroll position.
+ */
+void app_list_set_source(lv_obj_t* list, int project_count, app_list_item_cb_t get_item,
+                         app_list_visible_cb_t visible_cb, void* user_data);
+
+/**
+ * @brief Changes the number of projects without moving the scroll position.
+ */
+void app_list_set_count(lv_obj_t* list, int project_count);
+
+/**
+ * @brief Asks the source again for the projects of the bound cards and rebinds the
+ * cards whose project changed, e.g. because it finished loading.
+ */
+void app_list_refresh_items(lv_obj_t* list);
+
+/**
+ * @brief Unbinds the cards from their projects and shows a spinner instead.
+ */
+void app_list_set_loading(lv_obj_t* list);
+
+/**
+ * @brief Scrolls the card of a project into view and focuses it.
+ *
+ * @param index The project's position in the list.
+ * @return false if there is no such project.
+ */
+bool app_list_focus_item(lv_obj_t* list, int index, lv_anim_enable_t anim);
+
 #endif // APP_LIST_H
@@ -0,0 +1,106 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Alignment of every allocation; enough for pointers, doubles and 64 bit integers.
+#define ARENA_ALIGN (2 * sizeof(void *))
+#define ALIGN_UP(n) (((n) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+typedef struct arena_block {
+    struct arena_block *next; // The previously filled block
+    size_t size;
+    size_t used;
+} arena_block_t;
+
+struct arena {
+    arena_block_t *current;
+    arena_block_t *first;     // Allocated together with the arena itself
+    size_t next_block_size;
+    size_t block_count;
+    size_t used_bytes;
+};
+
+// --- IMPLEMENTATIONS ---
+
+static char *block_data(arena_block_t *block) {
+    return (char *)block + ALIGN_UP(sizeof(arena_block_t));
+}
+
+arena_t *arena_create(size_t block_size) {
+    if (block_size == 0) block_size = ARENA_DEFAULT_BLOCK_SIZE;
+    block_size = ALIGN_UP(block_size);
+    // One allocation holds the arena and its first block, so a small response costs a single malloc.
+    arena_t *arena = malloc(ALIGN_UP(sizeof(arena_t)) + ALIGN_UP(sizeof(arena_block_t)) + block_size);
+    if (!arena) return NULL;
+    arena_block_t *block = (arena_block_t *)((char *)arena + ALIGN_UP(sizeof(arena_t)));
+    block->next = NULL;
+    block->size = block_size;
+    block->used = 0;
+    arena->current = block;
+    arena->first = block;
+    arena->next_block_size = block_size * 2;
+    arena->block_count = 1;
+    arena->used_bytes = 0;
+    return arena;
+}
+
+void arena_destroy(arena_t *arena) {
+    if (!arena) return;
+    arena_block_t *block = arena->current;
+    while (block != arena->first) {
+        arena_block_t *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(arena);
+}
+
+void *arena_alloc(arena_t *arena, size_t size) {
+    if (!arena) return NULL;
+    size = ALIGN_UP(size ? size : 1);
+    arena_block_t *block = arena->current;
+    if (block->size - block->used < size) {
+        size_t block_size = arena->next_block_size > size ? arena->next_block_size : size;
+        block = malloc(ALIGN_UP(sizeof(arena_block_t)) + block_size);
+        if (!block) return NULL;
+        block->next = arena->current;
+        block->size = block_size;
+        block->used = 0;
+        arena->current = block;
+        arena->next_block_size *= 2;
+        arena->block_count++;
+    }
+    void *ptr = block_data(block) + block->used;
+    block->used += size;
+    arena->used_bytes += size;
+    return ptr;
+}
+
+char *arena_strdup(arena_t *arena, const char *str) {
+    if (!str) return NULL;
+    size_t length = strlen(str) + 1;
+    char *copy = arena_alloc(arena, length);
+    if (copy) memcpy(copy, str, length);
+    return copy;
+}
+
+void *arena_alloc_root(arena_t *arena, size_t size) {
+    char *ptr = arena_alloc(arena, ARENA_ALIGN + size);
+    if (!ptr) return NULL;
+    *(arena_t **)ptr = arena;
+    memset(ptr + ARENA_ALIGN, 0, size);
+    return ptr + ARENA_ALIGN;
+}
+
+void arena_destroy_root(void *root) {
+    if (!root) return;
+    arena_destroy(*(arena_t **)((char *)root - ARENA_ALIGN));
+}
+
+size_t arena_block_count(const arena_t *arena) {
+    return arena ? arena->block_count : 0;
+}
+
+size_t arena_used_bytes(const arena_t *arena) {
+    return arena ? arena->used_bytes : 0;
+}
@@ -0,0 +1,65 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Size of the first block of an arena created with a block size of 0.
+#define ARENA_DEFAULT_BLOCK_SIZE 4096
+
+typedef struct arena arena_t;
+
+/**
+ * @brief Creates a region allocator. Allocations are carved out of large blocks
+ * and can only be released all at once with arena_destroy().
+ *
+ * @param block_size Size of the first block; later blocks double in size.
+ *                   0 selects ARENA_DEFAULT_BLOCK_SIZE.
+ * @return The arena, or NULL on allocation failure.
+ */
+arena_t *arena_create(size_t block_size);
+
+/**
+ * @brief Frees the arena and everything allocated from it.
+ */
+void arena_destroy(arena_t *arena);
+
+/**
+ * @brief Allocates suitably aligned, uninitialized memory from the arena.
+ *
+ * @return The memory, or NULL on allocation failure.
+ */
+void *arena_alloc(arena_t *arena, size_t size);
+
+/**
+ * @brief Copies a string into the arena.
+ *
+ * @return The copy, or NULL on allocation failure.
+ */
+char *arena_strdup(arena_t *arena, const char *str);
+
+/**
+ * @brief Allocates zeroed memory that remembers its arena.
+ *
+ * Handing out such a root lets owners free the whole arena through it with
+ * arena_destroy_root(), without keeping track of the arena themselves.
+ *
+ * @return The memory, or NULL on allocation failure.
+ */
+void *arena_alloc_root(arena_t *arena, size_t size);
+
+/**
+ * @brief Frees the arena a pointer from arena_alloc_root() belongs to. NULL is ignored.
+ */
+void arena_destroy_root(void *root);
+
+/**
+ * @brief Returns the number of blocks (i.e. malloc calls) the arena has made.
+ */
+size_t arena_block_count(const arena_t *arena);
+
+/**
+ * @brief Returns the number of bytes handed out by the arena.
+ */
+size_t arena_used_bytes(const arena_t *arena);
+
+#endif // ARENA_H
@@ -1,70 +1,102 @@
 #include "badgehub_client.h"
+#include "arena.h"
+#include "file_download.h"
+#include "http_pool.h"
+#include "icon_loader.h"
+#include "project_parser.h"
+#include "response_buffer.h"
 #include "utils.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <curl/curl.h>
-#include "cjson/cJSON.h"
 #include <sys/stat.h>
 #include <errno.h>
 
-#define INSTALLATION_DIR "installation_dir"
-
-project_t *get_applications(int *project_count, const char* search_query, int limit, int offset) {
-    *project_count = 0;
-    CURL *curl_handle;
-    CURLcode res;
-    struct MemoryStruct chunk = { .memory = malloc(1), .size = 0 };
-    project_t *projects = NULL;
+// Per-request state for the asynchronous API.
+typedef struct {
+    badgehub_applications_cb_t applications_cb;
+    badgehub_details_cb_t details_cb;
+    void *user_data;
+    project_list_parser_t *list_parser;
+    project_details_parser_t *details_parser;
     char url[512];
-    char base_url[256];
-    snprintf(base_url, sizeof(base_url), "%s/project-summaries", "https://badgehub.p1m.nl/api/v3");
-    curl_global_init(CURL_GLOBAL_ALL);
-    curl_handle = curl_easy_init();
-    if (!curl_handle) { free(chunk.memory); return NULL; }
+} async_ctx_t;
+
+// --- STATIC STATE VARIABLES ---
+static char s_base_url[256] = BADGEHUB_DEFAULT_BASE_URL;
+static bool s_base_url_set = false; // Set explicitly; takes precedence over the environment
+
+bool badgehub_client_set_base_url(const char *base_url) {
+    if (!base_url || !base_url[0] || strlen(base_url) >= sizeof(s_base_url)) return false;
+    snprintf(s_base_url, sizeof(s_base_url), "%s", base_url);
+    // Endpoints are appended with a leading slash.
+    size_t length = strlen(s_base_url);
+    while (length > 1 && s_base_url[length - 1] == '/') s_base_url[--length] = '\0';
+    s_base_url_set = true;
+    return true;
+}
+
+const char *badgehub_client_get_base_url(void) {
+    return s_base_url;
+}
+
+bool badgehub_client_init(void) {
+    const char *env_url = getenv(BADGEHUB_BASE_URL_ENV);
+    if (!s_base_url_set && env_url && env_url[0]) {
+        if (badgehub_client_set_base_url(env_url)) {
+            printf("Using BadgeHub at %s\n", s_base_url);
+        } else {
+            fprintf(stderr, "Ignoring invalid %s\n", BADGEHUB_BASE_URL_ENV);
+        }
+    }
+    if (!http_pool_init(HTTP_POOL_DEFAULT_SIZE)) return false;
+    return http_async_init();
+}
+
+void badgehub_client_cleanup(void) {
+    http_async_deinit();
+    http_pool_cleanup();
+    response_buffer_pool_clear();
+}
+
+// Builds the /project-summaries URL for a page of results.
+static void build_applications_url(char *url, size_t url_size, CURL *curl_handle, const char* search_query, int limit, int offset) {
+    char base_url[sizeof(s_base_url) + 32];
+    snprintf(base_url, sizeof(base_url), "%s/project-summaries", s_base_url);
     if (search_query && strlen(search_query) > 0) {
         char *escaped_query = NULL;
         escaped_query = curl_easy_escape(curl_handle, search_query, 0);
         printf("Searching with ?search=%s&pageLength=%d&pageStart=%d\n", escaped_query, limit, offset);
-        snprintf(url, sizeof(url), "%s?search=%s&pageLength=%d&pageStart=%d", base_url, escaped_query, limit, offset);
+        snprintf(url, url_size, "%s?search=%s&pageLength=%d&pageStart=%d", base_url, escaped_query, limit, offset);
         curl_free(escaped_query);
     } else {
-        snprintf(url, sizeof(url), "%s?pageLength=%d&pageStart=%d", base_url, limit, offset);
+        snprintf(url, url_size, "%s?pageLength=%d&pageStart=%d", base_url, limit, offset);
     }
+}
+
+project_t *get_applications(int *project_count, const char* search_query, int limit, int offset) {
+    *project_count = 0;
+    CURL *curl_handle;
+    CURLcode res;
+    project_t *projects = NULL;
+    char url[512];
+    // Projects are built while the body arrives; neither the raw text nor a DOM is kept.
+    project_list_parser_t *parser = project_list_parser_create();
+    if (!parser) return NULL;
+    curl_handle = http_pool_acquire();
+    if (!curl_handle) { project_list_parser_abort(parser); return NULL; }
+    build_applications_url(url, sizeof(url), curl_handle, search_query, limit, offset);
     curl_easy_setopt(curl_handle, CURLOPT_URL, url);
-    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteMemoryCallback);
-    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *)&chunk);
-    curl_easy_setopt(curl_handle, CURLOPT_USERAGENT, "lvgl-badgehub-client/1.0");
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, project_list_parser_write_cb);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *)parser);
     res = curl_easy_perform(curl_handle);
     if (res == CURLE_OK) {
-        cJSON *root = cJSON_Parse(chunk.memory);
-        if (cJSON_IsArray(root)) {
-            *project_count = cJSON_GetArraySize(root);
-            projects = calloc(*project_count, sizeof(project_t));
-            if (projects) {
-                cJSON *proj_json = NULL;
-                int i = 0;
-                cJSON_ArrayForEach(proj_json, root) {
-                    projects[i].name = get_json_string(proj_json, "name");
-                    projects[i].slug = get_json_string(proj_json, "slug");
-                    projects[i].description = get_json_string(proj_json, "description");
-                    projects[i].project_url = get_json_string(proj_json, "project_url");
-
-                    cJSON *icon_map = cJSON_GetObjectItemCaseSensitive(proj_json, "icon_map");
-                    cJSON *icon_64_obj = cJSON_GetObjectItemCaseSensitive(icon_map, "64x64");
-                    projects[i].icon_url = get_json_string(icon_64_obj, "url");
-
-                    cJSON *revision_item = cJSON_GetObjectItemCaseSensitive(proj_json, "revision");
-                    projects[i].revision = cJSON_IsNumber(revision_item) ? revision_item->valueint : 0;
-                    i++;
-                }
-            }
-        }
-        cJSON_Delete(root);
+        projects = project_list_parser_finish(parser, project_count);
+    } else {
+        project_list_parser_abort(parser);
     }
-    curl_easy_cleanup(curl_handle);
-    free(chunk.memory);
-    curl_global_cleanup();
+    http_pool_release(curl_handle);
     return projects;
 }
 
@@ -73,151 +105,166 @@ uint8_t* download_icon_to_memory(const char* icon_url, size_t* data_size) {
 
     CURL *curl_handle;
     CURLcode res;
-    struct MemoryStruct chunk = { .memory = malloc(1), .size = 0 };
     long response_code = 0;
+    uint8_t *data = NULL;
 
-    curl_handle = curl_easy_init();
+    response_buffer_t *buffer = response_buffer_acquire(ICON_LOADER_MAX_ICON_SIZE);
+    if (!buffer) return NULL;
+    curl_handle = http_pool_acquire();
     if (curl_handle) {
         curl_easy_setopt(curl_handle, CURLOPT_URL, icon_url);
-        curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteMemoryCallback);
-        curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *)&chunk);
+        response_buffer_attach(buffer, curl_handle);
         res = curl_easy_perform(curl_handle);
         if (res == CURLE_OK) {
             curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &response_code);
             if (response_code == 200) {
-                *data_size = chunk.size;
-                curl_easy_cleanup(curl_handle);
-                return (uint8_t*)chunk.memory;
+                data = (uint8_t*)response_buffer_detach(buffer, data_size);
             }
         }
-        free(chunk.memory);
-        curl_easy_cleanup(curl_handle);
+        http_pool_release(curl_handle);
     }
-    return NULL;
+    response_buffer_release(buffer);
+    return data;
 }
 
 void free_applications(project_t *projects, int count) {
-    if (!projects) return;
-    for (int i = 0; i < count; i++) {
-        free(projects[i].name);
-        free(projects[i].slug);
-        free(projects[i].description);
-        free(projects[i].project_url);
-        free(projects[i].icon_url);
-    }
-    free(projects);
+    (void)count;
+    // The array is the root of the page's arena, which also holds every string.
+    arena_destroy_root(projects);
 }
 
-// ... (rest of badgehub_client.c is unchanged)
 project_detail_t *get_project_details(const char *slug, int revision) {
     CURL *curl_handle;
     CURLcode res;
-    struct MemoryStruct chunk = { .memory = malloc(1), .size = 0 };
     project_detail_t *details = NULL;
     char url[256];
     if (!slug) return NULL;
-    snprintf(url, sizeof(url), "%s/projects/%s/rev%d", "https://badgehub.p1m.nl/api/v3", slug, revision);
-    if (chunk.memory == NULL) return NULL;
-    curl_global_init(CURL_GLOBAL_ALL);
-    curl_handle = curl_easy_init();
-    if (!curl_handle) { free(chunk.memory); return NULL; }
+    project_details_parser_t *parser = project_details_parser_create(slug, revision);
+    if (!parser) return NULL;
+    snprintf(url, sizeof(url), "%s/projects/%s/rev%d", s_base_url, slug, revision);
+    curl_handle = http_pool_acquire();
+    if (!curl_handle) { project_details_parser_abort(parser); return NULL; }
     curl_easy_setopt(curl_handle, CURLOPT_URL, url);
-    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteMemoryCallback);
-    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *)&chunk);
-    curl_easy_setopt(curl_handle, CURLOPT_USERAGENT, "lvgl-badgehub-client/1.0");
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, project_details_parser_write_cb);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *)parser);
     res = curl_easy_perform(curl_handle);
     if (res == CURLE_OK) {
-        cJSON *root = cJSON_Parse(chunk.memory);
-        if (root) {
-            details = calloc(1, sizeof(project_detail_t));
-            if (details) {
-                details->slug = strdup(slug);
-                details->revision = revision;
-                cJSON *version_obj = cJSON_GetObjectItemCaseSensitive(root, "version");
-                if (version_obj) {
-                    cJSON *metadata_obj = cJSON_GetObjectItemCaseSensitive(version_obj, "app_metadata");
-                    details->name = get_json_string(metadata_obj, "name");
-                    details->description = get_json_string(metadata_obj, "description");
-                    details->author = get_json_string(metadata_obj, "author");
-                    details->version = get_json_string(metadata_obj, "version");
-                    details->published_at = get_json_string(version_obj, "published_at");
-                    cJSON *files_array = cJSON_GetObjectItemCaseSensitive(version_obj, "files");
-                    if (cJSON_IsArray(files_array)) {
-                        details->file_count = cJSON_GetArraySize(files_array);
-                        details->files = malloc(details->file_count * sizeof(project_file_t));
-                        if (details->files) {
-                            cJSON *file_json = NULL;
-                            int i = 0;
-                            cJSON_ArrayForEach(file_json, files_array) {
-                                details->files[i].full_path = get_json_string(file_json, "full_path");
-                                details->files[i].sha256 = get_json_string(file_json, "sha256");
-                                details->files[i].url = get_json_string(file_json, "url");
-                                i++;
-                            }
-                        }
-                    }
-                }
-            }
-            cJSON_Delete(root);
-        }
+        details = project_details_parser_finish(parser);
+    } else {
+        project_details_parser_abort(parser);
     }
-    curl_easy_cleanup(curl_handle);
-    free(chunk.memory);
-    curl_global_cleanup();
+    http_pool_release(curl_handle);
     return details;
 }
+
 bool download_project_file(const project_file_t* file_info, const char* project_slug) {
     if (!file_info || !file_info->url || !project_slug) return false;
     CURL *curl_handle;
     CURLcode res;
-    FILE *fp;
+    file_download_t download;
     char local_path[512];
     long response_code = 0;
     bool success = false;
     snprintf(local_path, sizeof(local_path), "%s/%s/%s", INSTALLATION_DIR, project_slug, file_info->full_path);
-    ensure_dir_exists(local_path);
-    curl_handle = curl_easy_init();
+    curl_handle = http_pool_acquire();
     if (curl_handle) {
-        fp = fopen(local_path, "wb");
-        if (fp) {
-            curl_easy_setopt(curl_handle, CURLOPT_URL, file_info->url);
-            curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, WriteFileCallback);
-            curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, fp);
+        if (file_download_begin(&download, curl_handle, local_path, file_info->url, NULL, NULL)) {
             res = curl_easy_perform(curl_handle);
-            fclose(fp);
-            if (res == CURLE_OK) {
-                curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &response_code);
-                if (response_code == 200) {
-                    success = true;
-                } else {
-                    fprintf(stderr, "Download failed for %s: HTTP status %ld\n", file_info->url, response_code);
-                    remove(local_path);
-                }
-            } else {
+            curl_easy_getinfo(curl_handle, CURLINFO_RESPONSE_CODE, &response_code);
+            if (res != CURLE_OK) {
                 fprintf(stderr, "curl_easy_perform() failed: %s\n", curl_easy_strerror(res));
+            } else if (response_code != 200 && response_code != 206) {
+                fprintf(stderr, "Download failed for %s: HTTP status %ld\n", file_info->url, response_code);
             }
-        } else {
-            fprintf(stderr, "Failed to open file for writing: %s\n", local_path);
+            success = file_download_finish(&download, res, response_code, file_info->sha256) == FILE_DOWNLOAD_OK;
         }
-        curl_easy_cleanup(curl_handle);
+        http_pool_release(curl_handle);
     }
     return success;
 }
+
 void free_project_details(project_detail_t *details) {
-    if (!details) return;
-    free(details->name);
-    free(details->description);
-    free(details->published_at);
-    free(details->author);
-    free(details->version);
-    free(details->slug);
-    if (details->files) {
-        for (int i = 0; i < details->file_count; i++) {
-            free(details->files[i].full_path);
-            free(details->files[i].sha256);
-            free(details->files[i].url);
+    arena_destroy_root(details);
+}
+
+// --- ASYNCHRONOUS API ---
+
+static void free_async_ctx(async_ctx_t *ctx) {
+    project_list_parser_abort(ctx->list_parser);
+    project_details_parser_abort(ctx->details_parser);
+    free(ctx);
+}
+
+static void applications_done_cb(const http_response_t *response, void *user_data) {
+    async_ctx_t *ctx = user_data;
+    if (!response->cancelled) {
+        int project_count = 0;
+        project_t *projects = NULL;
+        bool success = response->result == CURLE_OK && response->status == 200;
+        if (success) {
+            projects = project_list_parser_finish(ctx->list_parser, &project_count);
+            ctx->list_parser = NULL;
+        } else {
+            fprintf(stderr, "Fetching %s failed: %s (HTTP %ld)\n", ctx->url, curl_easy_strerror(response->result), response->status);
+        }
+        ctx->applications_cb(projects, project_count, success, ctx->user_data);
+    }
+    free_async_ctx(ctx);
+}
+
+http_request_t *get_applications_async(const char* search_query, int limit, int offset, badgehub_applications_cb_t cb, void *user_data) {
+    if (!cb) return NULL;
+    async_ctx_t *ctx = calloc(1, sizeof(async_ctx_t));
+    if (!ctx) return NULL;
+    ctx->applications_cb = cb;
+    ctx->user_data = user_data;
+    ctx->list_parser = project_list_parser_create();
+    if (!ctx->list_parser) { free_async_ctx(ctx); return NULL; }
+
+    CURL *curl_handle = http_pool_acquire();
+    if (!curl_handle) { free_async_ctx(ctx); return NULL; }
+    build_applications_url(ctx->url, sizeof(ctx->url), curl_handle, search_query, limit, offset);
+    curl_easy_setopt(curl_handle, CURLOPT_URL, ctx->url);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, project_list_parser_write_cb);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *)ctx->list_parser);
+
+    http_request_t *request = http_async_submit(curl_handle, false, applications_done_cb, ctx);
+    if (!request) free_async_ctx(ctx);
+    return request;
+}
+
+static void details_done_cb(const http_response_t *response, void *user_data) {
+    async_ctx_t *ctx = user_data;
+    if (!response->cancelled) {
+        project_detail_t *details = NULL;
+        if (response->result == CURLE_OK && response->status == 200) {
+            details = project_details_parser_finish(ctx->details_parser);
+            ctx->details_parser = NULL;
+        } else {
+            fprintf(stderr, "Fetching %s failed: %s (HTTP %ld)\n", ctx->url, curl_easy_strerror(response->result), response->status);
         }
-        free(details->files);
+        ctx->details_cb(details, ctx->user_data);
     }
-    free(details);
+    free_async_ctx(ctx);
+}
+
+http_request_t *get_project_details_async(const char *slug, int revision, badgehub_details_cb_t cb, void *user_data) {
+    if (!slug || !cb) return NULL;
+    async_ctx_t *ctx = calloc(1, sizeof(async_ctx_t));
+    if (!ctx) return NULL;
+    ctx->details_cb = cb;
+    ctx->user_data = user_data;
+    ctx->details_parser = project_details_parser_create(slug, revision);
+    if (!ctx->details_parser) { free_async_ctx(ctx); return NULL; }
+    snprintf(ctx->url, sizeof(ctx->url), "%s/projects/%s/rev%d", s_base_url, slug, revision);
+
+    CURL *curl_handle = http_pool_acquire();
+    if (!curl_handle) { free_async_ctx(ctx); return NULL; }
+    curl_easy_setopt(curl_handle, CURLOPT_URL, ctx->url);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, project_details_parser_write_cb);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEDATA, (void *)ctx->details_parser);
+
+    http_request_t *request = http_async_submit(curl_handle, false, details_done_cb, ctx);
+    if (!request) free_async_ctx(ctx);
+    return request;
 }
@@ -3,8 +3,18 @@
 
 #include <stdbool.h>
 #include "lvgl/lvgl.h"
+#include "http_async.h"
 
-// Represents a project summary from the main project list.
+// Projects are installed into INSTALLATION_DIR/<slug>.
+#define INSTALLATION_DIR "installation_dir"
+// The public BadgeHub API, used unless another base URL is configured.
+#define BADGEHUB_DEFAULT_BASE_URL "https://badgehub.p1m.nl/api/v3"
+// Environment variable that points the client at another server, e.g. the mock
+// server in tools/mock_badgehub.
+#define BADGEHUB_BASE_URL_ENV "BADGEHUB_BASE_URL"
+
+// Represents a project summary from the main project list. A page of projects and
+// all of their strings share one arena; they stay valid until free_applications().
 typedef struct {
     char *name;
     char *slug;
@@ -21,7 +31,8 @@ typedef struct {
     char *url;
 } project_file_t;
 
-// Represents the detailed information for a single project.
+// Represents the detailed information for a single project. Like project pages, it
+// lives in one arena that free_project_details() releases at once.
 typedef struct {
     char *name;
     char *description;
@@ -33,7 +44,38 @@ typedef struct {
     project_file_t *files;
     int file_count;
 } project_detail_t;
+// Completion callbacks for the asynchronous API. They run on the LVGL thread and
+// take ownership of the passed data. They are not called for cancelled requests.
+typedef void (*badgehub_applications_cb_t)(project_t *projects, int project_count, bool success, void *user_data);
+typedef void (*badgehub_details_cb_t)(project_detail_t *details, void *user_data);
+
+/**
+ * @brief Initializes the client context: libcurl, the shared DNS/TLS/connection
+ * caches, the pool of reusable handles and the asynchronous request driver.
+ * Call once at startup, after lv_init().
+ *
+ * @return true on success.
+ */
+bool badgehub_client_init(void);
+
+/**
+ * @brief Tears down the client context created by badgehub_client_init().
+ */
+void badgehub_client_cleanup(void);
+
+/**
+ * @brief Sets the API base URL, e.g. "http://127.0.0.1:8080/api/v3". Requests
+ * started afterwards use it. Takes precedence over BADGEHUB_BASE_URL_ENV, which
+ * badgehub_client_init() reads otherwise.
+ *
+ * @return false if the URL is empty or too long; the previous one stays in use.
+ */
+bool badgehub_client_set_base_url(const char *base_url);
 
+/**
+ * @brief Returns the API base URL in use, without a trailing slash.
+ */
+const char *badgehub_client_get_base_url(void);
 
 project_t *get_applications(int *project_count, const char* search_query, int limit, int offset);
 void free_applications(project_t *projects, int count);
@@ -50,4 +92,21 @@ bool download_project_file(const project_file_t* file_info, const char* project_
  */
 uint8_t* download_icon_to_memory(const char* icon_url, size_t* data_size);
 
+/**
+ * @brief Non-blocking variant of get_applications().
+ *
+ * @param cb Receives the projects (free with free_applications()), their count and
+ *           whether the request succeeded.
+ * @return A request handle that can be passed to http_async_cancel(), or NULL on failure.
+ */
+http_request_t *get_applications_async(const char* search_query, int limit, int offset, badgehub_applications_cb_t cb, void *user_data);
+
+/**
+ * @brief Non-blocking variant of get_project_details().
+ *
+ * @param cb Receives the details (free with free_project_details()), or NULL on failure.
+ * @return A request handle that can be passed to http_async_cancel(), or NULL on failure.
+ */
+http_request_t *get_project_details_async(const char *slug, int revision, badgehub_details_cb_t cb, void *user_data);
+
 #endif // BADGEHUB_CLIENT_H
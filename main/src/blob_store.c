@@ -0,0 +1,191 @@
+#include "blob_store.h"
+#include "badgehub_client.h"
+#include "install_manifest.h"
+#include "sha256.h"
+#include "utils.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// --- CONSTANTS ---
+
+// Next to the installed apps, so blobs and apps share a filesystem and can be reflinked.
+#define BLOB_STORE_DIR INSTALLATION_DIR "/.blobs"
+
+// A digest in the form blobs are named by: 64 lowercase hex digits.
+typedef struct {
+    char hex[SHA256_HEX_SIZE];
+} digest_t;
+
+// --- STATIC STATE VARIABLES ---
+// The purge thread collects garbage while installs insert and materialize blobs.
+// The lock keeps a blob from being removed or replaced while it is copied.
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// --- IMPLEMENTATIONS ---
+
+// The digest comes from the server, so anything that is not exactly 64 hex digits
+// is rejected before it becomes part of a path.
+static bool normalize_digest(const char *sha256, digest_t *digest) {
+    if (!sha256 || strlen(sha256) != SHA256_HEX_SIZE - 1) return false;
+    for (int i = 0; i < SHA256_HEX_SIZE - 1; i++) {
+        if (!isxdigit((unsigned char)sha256[i])) return false;
+        digest->hex[i] = (char)tolower((unsigned char)sha256[i]);
+    }
+    digest->hex[SHA256_HEX_SIZE - 1] = '\0';
+    return true;
+}
+
+// Builds BLOB_STORE_DIR/ab/abcd... for a digest, fanned out over 256 directories
+// to keep each one small.
+static bool blob_path(const char *sha256, char *path, size_t path_size) {
+    digest_t digest;
+    if (!normalize_digest(sha256, &digest)) return false;
+    snprintf(path, path_size, "%s/%.2s/%s", BLOB_STORE_DIR, digest.hex, digest.hex);
+    return true;
+}
+
+bool blob_store_materialize(const char *sha256, const char *dst, uint64_t *size) {
+    char path[512];
+    char digest[SHA256_HEX_SIZE];
+    struct stat st;
+    if (!blob_path(sha256, path, sizeof(path))) return false;
+    pthread_mutex_lock(&s_lock);
+    bool ok = stat(path, &st) == 0 && S_ISREG(st.st_mode) && clone_or_copy(path, dst);
+    pthread_mutex_unlock(&s_lock);
+    if (!ok) return false;
+
+    // The copy is checked rather than trusted: it is what gets installed, and a
+    // blob changed on disk must not pass for the download it replaces.
+    uint64_t copied = 0;
+    if (sha256_file(dst, digest, &copied) && sha256_hex_equal(digest, sha256)) {
+        if (size) *size = copied;
+        return true;
+    }
+    fprintf(stderr, "Dropping damaged blob %s\n", path);
+    remove(dst);
+    pthread_mutex_lock(&s_lock);
+    struct stat now;
+    // Unless an insert has replaced it meanwhile.
+    if (stat(path, &now) == 0 && now.st_dev == st.st_dev && now.st_ino == st.st_ino) remove(path);
+    pthread_mutex_unlock(&s_lock);
+    return false;
+}
+
+static bool insert_locked(const char *path, const char *sha256) {
+    char blob[512];
+    char tmp[520];
+    struct stat st;
+    if (!blob_path(sha256, blob, sizeof(blob))) return false;
+    // A damaged blob is dropped by the materialize that finds it, so one that
+    // exists is kept rather than copied again.
+    if (stat(blob, &st) == 0 && S_ISREG(st.st_mode)) return true;
+
+    // Copied under a temporary name and renamed, so the blob path never holds a
+    // partial file. A copy rather than a hard link: apps may write to their files.
+    snprintf(tmp, sizeof(tmp), "%s.tmp", blob);
+    ensure_dir_exists(tmp);
+    if (!clone_or_copy(path, tmp)) return false;
+    chmod(tmp, 0444);
+    if (rename(tmp, blob) != 0) {
+        remove(tmp);
+        return false;
+    }
+    return true;
+}
+
+bool blob_store_insert(const char *path, const char *sha256) {
+    pthread_mutex_lock(&s_lock);
+    bool ok = insert_locked(path, sha256);
+    pthread_mutex_unlock(&s_lock);
+    return ok;
+}
+
+static int compare_digests(const void *a, const void *b) {
+    return strcmp(a, b);
+}
+
+// Lists the digests the manifests of the installed apps refer to, sorted.
+static bool list_used_digests(digest_t **digests, int *count) {
+    *digests = NULL;
+    *count = 0;
+    DIR *dir = opendir(INSTALLATION_DIR);
+    if (!dir) return true;
+    int capacity = 0;
+    bool ok = true;
+    struct dirent *entry;
+    while (ok && (entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue; // The store itself, staging areas and the trash
+        char app_dir[512];
+        snprintf(app_dir, sizeof(app_dir), "%s/%s", INSTALLATION_DIR, entry->d_name);
+        install_manifest_t *manifest = install_manifest_load(app_dir);
+        for (int i = 0; ok && manifest && i < manifest->count; i++) {
+            if (*count == capacity) {
+                capacity = capacity > 0 ? capacity * 2 : 256;
+                digest_t *grown = realloc(*digests, capacity * sizeof(digest_t));
+                ok = grown != NULL;
+                if (ok) *digests = grown;
+            }
+            if (ok && normalize_digest(manifest->entries[i].sha256, &(*digests)[*count])) (*count)++;
+        }
+        install_manifest_free(manifest);
+    }
+    closedir(dir);
+    if (!ok) {
+        free(*digests);
+        *digests = NULL;
+        return false;
+    }
+    if (*count > 1) qsort(*digests, *count, sizeof(digest_t), compare_digests);
+    return true;
+}
+
+// Takes the lock per blob rather than for the whole walk, so installs are not
+// held up while it runs in the background.
+void blob_store_gc(void) {
+    time_t started = time(NULL);
+    digest_t *used;
+    int used_count;
+    if (!list_used_digests(&used, &used_count)) return; // Without the list every blob would look unused
+    DIR *store = opendir(BLOB_STORE_DIR);
+    if (!store) {
+        free(used);
+        return;
+    }
+    struct dirent *fan;
+    while ((fan = readdir(store)) != NULL) {
+        if (fan->d_name[0] == '.') continue;
+        char dir_path[512];
+        snprintf(dir_path, sizeof(dir_path), "%s/%s", BLOB_STORE_DIR, fan->d_name);
+        DIR *dir = opendir(dir_path);
+        if (!dir) continue;
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (entry->d_name[0] == '.') continue;
+            char path[1024];
+            struct stat st;
+            snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name);
+            // Blobs entered since the manifests were read may belong to an install in progress.
+            if (lstat(path, &st) != 0 || !S_ISREG(st.st_mode) || st.st_mtime >= started) continue;
+            // Stray .tmp files of an interrupted insert are never in the list.
+            if (used_count > 0 && bsearch(entry->d_name, used, used_count, sizeof(digest_t), compare_digests)) {
+                continue;
+            }
+            pthread_mutex_lock(&s_lock);
+            if (lstat(path, &st) == 0 && st.st_mtime < started) remove(path);
+            pthread_mutex_unlock(&s_lock);
+        }
+        closedir(dir);
+        pthread_mutex_lock(&s_lock);
+        rmdir(dir_path); // Only succeeds once the directory is empty
+        pthread_mutex_unlock(&s_lock);
+    }
+    closedir(store);
+    free(used);
+}
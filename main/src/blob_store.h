@@ -0,0 +1,54 @@
+#ifndef BLOB_STORE_H
+#define BLOB_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Content-addressed store of installed files, keyed by their sha256.
+ *
+ * Every verified file of an install is entered into the store, and installs
+ * materialize files the store already holds instead of downloading them, so a
+ * library shipped by several apps, or unchanged across revisions, is downloaded
+ * once. Blobs and installed files never share an inode, since apps may write to
+ * their files: they are reflinks (sharing extents on filesystems such as btrfs
+ * and XFS, and so stored once) or, elsewhere, copies of each other.
+ *
+ * A blob is garbage once no installed app's manifest lists its digest.
+ *
+ * The functions may be called from any thread; they are serialized by one lock.
+ */
+
+/**
+ * @brief Places a copy of the blob with the given digest at dst, replacing
+ * whatever is there. The parent directory of dst must exist.
+ *
+ * The copy is hashed before it is accepted. A blob whose contents no longer
+ * match its digest is removed from the store, and dst with it.
+ *
+ * @param size If not NULL, set to the size of the file.
+ * @return false if the store has no intact blob for the digest, or it could not
+ *         be placed.
+ */
+bool blob_store_materialize(const char *sha256, const char *dst, uint64_t *size);
+
+/**
+ * @brief Enters a copy of the verified file at path as the store's blob for
+ * sha256, unless the store has one already.
+ *
+ * @return false if sha256 is not a valid digest or the file could not be entered.
+ */
+bool blob_store_insert(const char *path, const char *sha256);
+
+/**
+ * @brief Removes every blob no installed app's manifest lists. Call after
+ * uninstalling an app or replacing one's files; it reads every manifest, so
+ * preferably off the LVGL thread.
+ *
+ * Blobs entered while it runs are kept. One entered earlier by an install that
+ * is still in progress may be removed, which costs that file's next install a
+ * download.
+ */
+void blob_store_gc(void);
+
+#endif // BLOB_STORE_H
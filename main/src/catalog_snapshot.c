@@ -0,0 +1,333 @@
+#include "catalog_snapshot.h"
+#include "search_index.h"
+#include "utils.h"
+#include "lvgl/lvgl.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// --- CONSTANTS ---
+#define SNAPSHOT_MAGIC "BHCATSNP"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_FIELDS 5
+#define NO_STRING UINT32_MAX
+// Delay before the search index of a newly mapped snapshot is built, leaving the
+// frame that shows the snapshot to be drawn first.
+#define INDEX_BUILD_DELAY_MS 100
+
+// Format, in the byte order of the device that wrote it:
+//   snapshot_header_t, project_count x snapshot_record_t, strings_size bytes of
+//   NUL terminated strings. Records refer to their strings by offset, so the file
+//   holds no pointers and is used in place once mapped.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t project_count;
+    int64_t synced_at;
+    uint32_t strings_size;
+    uint32_t reserved;
+} snapshot_header_t;
+
+typedef struct {
+    uint32_t strings[SNAPSHOT_FIELDS]; // See project_strings() for the order; NO_STRING for NULL
+    int32_t revision;
+} snapshot_record_t;
+
+// A mapped snapshot file, the projects pointing into it and their search index.
+typedef struct {
+    void *map;
+    size_t map_size;
+    project_t *projects;
+    int count;
+    time_t synced_at;
+    search_index_t *index; // Built by the index timer, or by a search that comes first
+} snapshot_t;
+
+// A page fetched by the running sync.
+typedef struct {
+    project_t *projects;
+    int count;
+} sync_page_t;
+
+// --- STATIC STATE VARIABLES ---
+static snapshot_t s_snapshot;
+static lv_timer_t *s_index_timer = NULL;
+
+static http_request_t *s_sync_request = NULL; // In-flight catalog page of the running sync
+static sync_page_t *s_pages = NULL;           // Pages collected by the running sync
+static int s_page_count = 0;
+static int s_page_capacity = 0;
+static int s_synced_count = 0;
+
+static catalog_snapshot_cb_t s_listener = NULL;
+static void *s_listener_data = NULL;
+
+// --- FORWARD DECLARATIONS ---
+static void page_fetched_cb(project_t *projects, int project_count, bool success, void *user_data);
+
+// --- IMPLEMENTATIONS ---
+
+static void project_strings(const project_t *project, const char *strings[SNAPSHOT_FIELDS]) {
+    strings[0] = project->name;
+    strings[1] = project->slug;
+    strings[2] = project->description;
+    strings[3] = project->project_url;
+    strings[4] = project->icon_url;
+}
+
+static void unmap_snapshot(snapshot_t *snapshot) {
+    search_index_free(snapshot->index);
+    free(snapshot->projects);
+    if (snapshot->map) munmap(snapshot->map, snapshot->map_size);
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+// Maps CATALOG_SNAPSHOT_PATH and checks that every record stays within the file.
+static bool map_snapshot(snapshot_t *snapshot) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    int fd = open(CATALOG_SNAPSHOT_PATH, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    void *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (uint64_t)st.st_size >= sizeof(snapshot_header_t)) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd); // The mapping keeps the file open
+    if (map == MAP_FAILED) return false;
+    snapshot->map = map;
+    snapshot->map_size = (size_t)st.st_size;
+
+    const snapshot_header_t *header = map;
+    const snapshot_record_t *records = (const snapshot_record_t *)(header + 1);
+    uint64_t expected_size = sizeof(snapshot_header_t) + (uint64_t)header->project_count * sizeof(snapshot_record_t) +
+                             header->strings_size;
+    bool ok = memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0 &&
+              header->version == SNAPSHOT_VERSION && header->project_count <= CATALOG_SNAPSHOT_MAX_PROJECTS &&
+              expected_size == snapshot->map_size;
+    const char *strings = ok ? (const char *)(records + header->project_count) : NULL;
+    // A terminated last string keeps every other string within the file too.
+    if (ok && header->strings_size > 0 && strings[header->strings_size - 1] != '\0') ok = false;
+    if (ok && header->project_count > 0) {
+        snapshot->projects = calloc(header->project_count, sizeof(project_t));
+        ok = snapshot->projects != NULL;
+    }
+    for (uint32_t i = 0; ok && i < header->project_count; i++) {
+        char *fields[SNAPSHOT_FIELDS];
+        for (int f = 0; f < SNAPSHOT_FIELDS; f++) {
+            uint32_t offset = records[i].strings[f];
+            if (offset != NO_STRING && offset >= header->strings_size) ok = false;
+            // The mapping is read-only; project_t just has no const members.
+            fields[f] = ok && offset != NO_STRING ? (char *)strings + offset : NULL;
+        }
+        project_t *project = &snapshot->projects[i];
+        project->name = fields[0];
+        project->slug = fields[1];
+        project->description = fields[2];
+        project->project_url = fields[3];
+        project->icon_url = fields[4];
+        project->revision = records[i].revision;
+    }
+    if (!ok) {
+        fprintf(stderr, "Ignoring unreadable catalog snapshot %s\n", CATALOG_SNAPSHOT_PATH);
+        unmap_snapshot(snapshot);
+        return false;
+    }
+    snapshot->count = (int)header->project_count;
+    snapshot->synced_at = (time_t)header->synced_at;
+    return true;
+}
+
+static bool build_index(void) {
+    if (!s_snapshot.index) s_snapshot.index = search_index_build(s_snapshot.projects, s_snapshot.count);
+    return s_snapshot.index != NULL;
+}
+
+static void index_timer_cb(lv_timer_t *timer) {
+    (void)timer;
+    s_index_timer = NULL;
+    if (s_snapshot.map && !build_index()) fprintf(stderr, "Failed to build the catalog search index\n");
+}
+
+// Builds the index of a newly mapped snapshot once the loop is idle, so the first
+// keystroke of a search does not pay for it.
+static void schedule_index_build(void) {
+    if (s_index_timer) return;
+    s_index_timer = lv_timer_create(index_timer_cb, INDEX_BUILD_DELAY_MS, NULL);
+    lv_timer_set_repeat_count(s_index_timer, 1);
+}
+
+bool catalog_snapshot_load(void) {
+    snapshot_t snapshot;
+    if (!map_snapshot(&snapshot)) return false;
+    unmap_snapshot(&s_snapshot);
+    s_snapshot = snapshot;
+    schedule_index_build();
+    return true;
+}
+
+int catalog_snapshot_count(void) {
+    return s_snapshot.count;
+}
+
+const project_t *catalog_snapshot_get(int index) {
+    if (index < 0 || index >= s_snapshot.count) return NULL;
+    return &s_snapshot.projects[index];
+}
+
+time_t catalog_snapshot_synced_at(void) {
+    return s_snapshot.synced_at;
+}
+
+int catalog_snapshot_search(const char *query, int *results, int max_results) {
+    if (!s_snapshot.map || !build_index()) return -1;
+    return search_index_query(s_snapshot.index, query, results, max_results);
+}
+
+static void discard_pages(void) {
+    for (int i = 0; i < s_page_count; i++) free_applications(s_pages[i].projects, s_pages[i].count);
+    free(s_pages);
+    s_pages = NULL;
+    s_page_count = s_page_capacity = 0;
+    s_synced_count = 0;
+}
+
+static bool add_page(project_t *projects, int project_count) {
+    if (s_page_count == s_page_capacity) {
+        int capacity = s_page_capacity > 0 ? s_page_capacity * 2 : 16;
+        sync_page_t *pages = realloc(s_pages, capacity * sizeof(sync_page_t));
+        if (!pages) return false;
+        s_pages = pages;
+        s_page_capacity = capacity;
+    }
+    s_pages[s_page_count].projects = projects;
+    s_pages[s_page_count].count = project_count;
+    s_page_count++;
+    s_synced_count += project_count;
+    return true;
+}
+
+static bool put_snapshot(FILE *fp, void *context) {
+    bool ok = fwrite(context, sizeof(snapshot_header_t), 1, fp) == 1;
+    uint32_t offset = 0;
+    for (int p = 0; ok && p < s_page_count; p++) {
+        for (int i = 0; ok && i < s_pages[p].count; i++) {
+            const char *strings[SNAPSHOT_FIELDS];
+            project_strings(&s_pages[p].projects[i], strings);
+            snapshot_record_t record;
+            for (int f = 0; f < SNAPSHOT_FIELDS; f++) {
+                record.strings[f] = strings[f] ? offset : NO_STRING;
+                if (strings[f]) offset += (uint32_t)strlen(strings[f]) + 1;
+            }
+            record.revision = s_pages[p].projects[i].revision;
+            ok = fwrite(&record, sizeof(record), 1, fp) == 1;
+        }
+    }
+    for (int p = 0; ok && p < s_page_count; p++) {
+        for (int i = 0; ok && i < s_pages[p].count; i++) {
+            const char *strings[SNAPSHOT_FIELDS];
+            project_strings(&s_pages[p].projects[i], strings);
+            for (int f = 0; ok && f < SNAPSHOT_FIELDS; f++) {
+                if (strings[f]) ok = fwrite(strings[f], strlen(strings[f]) + 1, 1, fp) == 1;
+            }
+        }
+    }
+    return ok;
+}
+
+// Replaces the snapshot file with the collected pages.
+static bool write_snapshot(void) {
+    uint64_t strings_size = 0;
+    for (int p = 0; p < s_page_count; p++) {
+        for (int i = 0; i < s_pages[p].count; i++) {
+            const char *strings[SNAPSHOT_FIELDS];
+            project_strings(&s_pages[p].projects[i], strings);
+            for (int f = 0; f < SNAPSHOT_FIELDS; f++) {
+                if (strings[f]) strings_size += strlen(strings[f]) + 1;
+            }
+        }
+    }
+    if (strings_size >= NO_STRING) return false;
+
+    snapshot_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.project_count = (uint32_t)s_synced_count;
+    header.synced_at = (int64_t)time(NULL);
+    header.strings_size = (uint32_t)strings_size;
+    if (write_file_atomic(CATALOG_SNAPSHOT_PATH, put_snapshot, &header)) return true;
+    fprintf(stderr, "Failed to write the catalog snapshot %s\n", CATALOG_SNAPSHOT_PATH);
+    return false;
+}
+
+static void finish_sync(bool success) {
+    success = success && write_snapshot();
+    discard_pages();
+    snapshot_t snapshot;
+    if (!success || !map_snapshot(&snapshot)) {
+        if (s_listener) s_listener(false, s_listener_data);
+        return;
+    }
+    // The new file is mapped before the old one goes, so the listener can rebind
+    // whatever still points into the old mapping.
+    snapshot_t previous = s_snapshot;
+    s_snapshot = snapshot;
+    schedule_index_build();
+    if (s_listener) s_listener(true, s_listener_data);
+    unmap_snapshot(&previous);
+}
+
+static void page_fetched_cb(project_t *projects, int project_count, bool success, void *user_data) {
+    s_sync_request = NULL;
+    if (!success || !add_page(projects, project_count)) {
+        free_applications(projects, project_count);
+        discard_pages();
+        if (s_listener) s_listener(false, s_listener_data);
+        return;
+    }
+    // A project that moves between pages during the sync may be listed twice or
+    // missed; the next sync puts it right.
+    if (project_count < CATALOG_SNAPSHOT_PAGE_SIZE || s_synced_count >= CATALOG_SNAPSHOT_MAX_PROJECTS) {
+        finish_sync(true);
+        return;
+    }
+    s_sync_request = get_applications_async("", CATALOG_SNAPSHOT_PAGE_SIZE, s_synced_count, page_fetched_cb, NULL);
+    if (!s_sync_request) finish_sync(false);
+}
+
+bool catalog_snapshot_sync(bool force) {
+    if (s_sync_request) return true;
+    if (!force && s_snapshot.map && time(NULL) - s_snapshot.synced_at < CATALOG_SNAPSHOT_TTL_SECONDS) return false;
+    discard_pages();
+    s_sync_request = get_applications_async("", CATALOG_SNAPSHOT_PAGE_SIZE, 0, page_fetched_cb, NULL);
+    return s_sync_request != NULL;
+}
+
+bool catalog_snapshot_is_syncing(void) {
+    return s_sync_request != NULL;
+}
+
+void catalog_snapshot_set_listener(catalog_snapshot_cb_t cb, void *user_data) {
+    s_listener = cb;
+    s_listener_data = user_data;
+}
+
+void catalog_snapshot_deinit(void) {
+    if (s_sync_request) {
+        http_async_cancel(s_sync_request);
+        s_sync_request = NULL;
+    }
+    if (s_index_timer) {
+        lv_timer_del(s_index_timer);
+        s_index_timer = NULL;
+    }
+    discard_pages();
+    unmap_snapshot(&s_snapshot);
+    s_listener = NULL;
+    s_listener_data = NULL;
+}
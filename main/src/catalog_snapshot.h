@@ -0,0 +1,92 @@
+#ifndef CATALOG_SNAPSHOT_H
+#define CATALOG_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <time.h>
+#include "badgehub_client.h"
+
+// The catalog as of the last successful sync, read at boot before the network is up.
+#define CATALOG_SNAPSHOT_PATH "cache/catalog.snapshot"
+// Projects requested per /project-summaries page while syncing.
+#define CATALOG_SNAPSHOT_PAGE_SIZE 100
+// A sync stops after this many projects; the snapshot then covers the start of the catalog.
+#define CATALOG_SNAPSHOT_MAX_PROJECTS 20000
+// How old the snapshot may get before catalog_snapshot_sync() fetches the catalog again.
+#define CATALOG_SNAPSHOT_TTL_SECONDS 900
+
+// Called on the LVGL thread when a sync finishes; success tells whether a new
+// snapshot was written and is now the one served.
+typedef void (*catalog_snapshot_cb_t)(bool success, void *user_data);
+
+/**
+ * @brief Maps the snapshot written by the last successful sync, if there is one.
+ *
+ * The file holds fixed-size records followed by a table of NUL terminated
+ * strings. It is memory-mapped rather than read, so loading it costs one pass
+ * over the records whatever the size of the catalog, and the strings are only
+ * paged in for the rows that are shown. A missing, truncated or foreign file is
+ * ignored.
+ *
+ * @return true if a snapshot is available.
+ */
+bool catalog_snapshot_load(void);
+
+/**
+ * @brief Returns the number of projects in the snapshot, 0 without one.
+ */
+int catalog_snapshot_count(void);
+
+/**
+ * @brief Returns a project of the snapshot, 0 <= index < catalog_snapshot_count().
+ *
+ * The strings point into the read-only mapping and must not be modified. The
+ * project stays valid until a sync replaces the snapshot, which happens only
+ * after the listener has been told, or until catalog_snapshot_deinit().
+ */
+const project_t *catalog_snapshot_get(int index);
+
+/**
+ * @brief Returns when the snapshot was synced, 0 without one.
+ */
+time_t catalog_snapshot_synced_at(void);
+
+/**
+ * @brief Searches the snapshot locally, see search_index_query(). The index is
+ * built shortly after the snapshot is loaded or replaced, once the LVGL loop is
+ * idle; a search that comes before that builds it first.
+ *
+ * @param results Receives the positions (for catalog_snapshot_get()) of up to
+ *                max_results matching projects, best first.
+ * @return The number of matching projects, or -1 without a snapshot or if the
+ *         index could not be built.
+ */
+int catalog_snapshot_search(const char *query, int *results, int max_results);
+
+/**
+ * @brief Fetches the whole catalog in the background and replaces the snapshot
+ * with it once every page has arrived. The current snapshot keeps being served
+ * meanwhile, and stays if the sync fails.
+ *
+ * @param force Sync even if the snapshot is younger than CATALOG_SNAPSHOT_TTL_SECONDS.
+ * @return true if a sync is running (the listener will be called), false if the
+ *         snapshot is still fresh or the request could not be started.
+ */
+bool catalog_snapshot_sync(bool force);
+
+/**
+ * @brief Returns whether a sync is in flight.
+ */
+bool catalog_snapshot_is_syncing(void);
+
+/**
+ * @brief Sets the callback for finished syncs. Passing NULL detaches it without
+ * stopping a sync in progress.
+ */
+void catalog_snapshot_set_listener(catalog_snapshot_cb_t cb, void *user_data);
+
+/**
+ * @brief Cancels a sync in progress and unmaps the snapshot.
+ */
+void catalog_snapshot_deinit(void);
+
+#endif // CATALOG_SNAPSHOT_H
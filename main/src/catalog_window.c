@@ -0,0 +1,231 @@
+#include "catalog_window.h"
+#include "catalog_snapshot.h"
+#include "page_cache.h"
+#include "lvgl/lvgl.h"
+#include <stdlib.h>
+#include <string.h>
+
+// --- CONSTANTS ---
+#define RETRY_DELAY_MS 2000
+
+typedef enum {
+    CHUNK_EMPTY,   // Slot unused
+    CHUNK_LOADING,
+    CHUNK_LOADED,
+    CHUNK_FAILED,  // Retried by the retry timer or the next scroll
+} chunk_state_t;
+
+typedef struct {
+    chunk_state_t state;
+    int number;                 // Position in the catalog, in chunks
+    page_cache_entry_t *page;   // Pinned while the chunk is in the window
+    http_request_t *request;
+} chunk_t;
+
+// --- STATIC STATE VARIABLES ---
+static chunk_t s_chunks[CATALOG_WINDOW_MAX_CHUNKS];
+static char *s_query = NULL; // NULL while stopped
+static catalog_window_changed_cb_t s_changed_cb = NULL;
+static void *s_changed_user_data = NULL;
+static int s_known_count = 0;  // End of the furthest chunk loaded so far
+static int s_total = -1;       // Size of the catalog, once its last chunk was loaded
+static int s_first_visible = 0;
+static int s_last_visible = 0;
+static bool s_updating = false; // Inside catalog_window_set_visible()
+static bool s_changed = false;  // Chunks arrived during the update
+static lv_timer_t *s_retry_timer = NULL;
+
+// --- FORWARD DECLARATIONS ---
+static void chunk_fetched_cb(project_t *projects, int project_count, bool success, void *user_data);
+static void retry_timer_cb(lv_timer_t *timer);
+
+// --- IMPLEMENTATIONS ---
+
+static void notify_changed(void) {
+    if (s_updating) {
+        s_changed = true; // Reported once the update is done
+        return;
+    }
+    if (s_changed_cb) s_changed_cb(s_changed_user_data);
+}
+
+static chunk_t *find_chunk(int number) {
+    for (int i = 0; i < CATALOG_WINDOW_MAX_CHUNKS; i++) {
+        if (s_chunks[i].state != CHUNK_EMPTY && s_chunks[i].number == number) return &s_chunks[i];
+    }
+    return NULL;
+}
+
+static void release_chunk(chunk_t *chunk) {
+    if (chunk->request) http_async_cancel(chunk->request);
+    if (chunk->page) page_cache_release(chunk->page);
+    memset(chunk, 0, sizeof(*chunk));
+}
+
+static void chunk_loaded(chunk_t *chunk, page_cache_entry_t *page) {
+    chunk->state = CHUNK_LOADED;
+    chunk->page = page;
+    int end = page->offset + page->project_count;
+    if (end > s_known_count) s_known_count = end;
+    if (page->project_count < CATALOG_WINDOW_CHUNK_SIZE) s_total = end;
+    notify_changed();
+}
+
+static void chunk_failed(chunk_t *chunk) {
+    chunk->state = CHUNK_FAILED;
+    if (!s_retry_timer) {
+        s_retry_timer = lv_timer_create(retry_timer_cb, RETRY_DELAY_MS, NULL);
+        lv_timer_set_repeat_count(s_retry_timer, 1);
+    }
+    notify_changed();
+}
+
+static void fetch_chunk(chunk_t *chunk) {
+    int offset = chunk->number * CATALOG_WINDOW_CHUNK_SIZE;
+    page_cache_entry_t *cached = page_cache_acquire(s_query, offset, CATALOG_WINDOW_CHUNK_SIZE);
+    if (cached) {
+        chunk_loaded(chunk, cached);
+        return;
+    }
+    chunk->state = CHUNK_LOADING;
+    chunk->request = get_applications_async(s_query, CATALOG_WINDOW_CHUNK_SIZE, offset, chunk_fetched_cb, chunk);
+    if (!chunk->request) chunk_failed(chunk);
+}
+
+static void ensure_chunk(int number) {
+    chunk_t *chunk = find_chunk(number);
+    if (chunk) {
+        if (chunk->state == CHUNK_FAILED && !s_retry_timer) fetch_chunk(chunk);
+        return;
+    }
+    for (int i = 0; i < CATALOG_WINDOW_MAX_CHUNKS; i++) {
+        if (s_chunks[i].state == CHUNK_EMPTY) {
+            s_chunks[i].number = number;
+            fetch_chunk(&s_chunks[i]);
+            return;
+        }
+    }
+}
+
+static void chunk_fetched_cb(project_t *projects, int project_count, bool success, void *user_data) {
+    chunk_t *chunk = user_data;
+    chunk->request = NULL;
+    page_cache_entry_t *page = NULL;
+    if (success) {
+        int offset = chunk->number * CATALOG_WINDOW_CHUNK_SIZE;
+        page = page_cache_insert(s_query, offset, CATALOG_WINDOW_CHUNK_SIZE, projects, project_count);
+    } else {
+        free_applications(projects, project_count);
+    }
+    if (page) {
+        chunk_loaded(chunk, page);
+    } else {
+        chunk_failed(chunk);
+    }
+}
+
+static void retry_timer_cb(lv_timer_t *timer) {
+    s_retry_timer = NULL;
+    catalog_window_set_visible(s_first_visible, s_last_visible);
+}
+
+void catalog_window_start(const char *query, catalog_window_changed_cb_t cb, void *user_data) {
+    catalog_window_stop();
+    s_query = strdup(query ? query : "");
+    if (!s_query) return;
+    s_changed_cb = cb;
+    s_changed_user_data = user_data;
+    catalog_window_set_visible(0, 0);
+}
+
+void catalog_window_stop(void) {
+    for (int i = 0; i < CATALOG_WINDOW_MAX_CHUNKS; i++) {
+        release_chunk(&s_chunks[i]);
+    }
+    if (s_retry_timer) {
+        lv_timer_del(s_retry_timer);
+        s_retry_timer = NULL;
+    }
+    free(s_query);
+    s_query = NULL;
+    s_changed_cb = NULL;
+    s_changed_user_data = NULL;
+    s_known_count = 0;
+    s_total = -1;
+    s_first_visible = s_last_visible = 0;
+}
+
+void catalog_window_set_visible(int first, int last) {
+    s_first_visible = first;
+    s_last_visible = last;
+    if (!s_query) return;
+
+    int first_chunk = first / CATALOG_WINDOW_CHUNK_SIZE;
+    int last_chunk = (last > first ? last - 1 : first) / CATALOG_WINDOW_CHUNK_SIZE;
+    int lo = first_chunk - CATALOG_WINDOW_CHUNKS_BEHIND;
+    int hi = last_chunk + CATALOG_WINDOW_CHUNKS_AHEAD;
+    if (lo < 0) lo = 0;
+    if (hi - lo >= CATALOG_WINDOW_MAX_CHUNKS) hi = lo + CATALOG_WINDOW_MAX_CHUNKS - 1;
+    if (s_total >= 0 && hi > (s_total - 1) / CATALOG_WINDOW_CHUNK_SIZE) {
+        hi = (s_total - 1) / CATALOG_WINDOW_CHUNK_SIZE;
+    }
+
+    for (int i = 0; i < CATALOG_WINDOW_MAX_CHUNKS; i++) {
+        chunk_t *chunk = &s_chunks[i];
+        if (chunk->state != CHUNK_EMPTY && (chunk->number < lo || chunk->number > hi)) {
+            release_chunk(chunk);
+        }
+    }
+
+    // Visible chunks first, then the ones ahead, then the ones behind.
+    s_updating = true;
+    for (int number = first_chunk; number <= hi; number++) ensure_chunk(number);
+    for (int number = first_chunk - 1; number >= lo; number--) ensure_chunk(number);
+    s_updating = false;
+    if (s_changed) {
+        s_changed = false;
+        notify_changed();
+    }
+}
+
+// The unfiltered catalog falls back to the snapshot for the rows not fetched yet.
+static bool uses_snapshot(void) {
+    return s_query && s_query[0] == '\0' && catalog_snapshot_count() > 0;
+}
+
+const project_t *catalog_window_get(int index) {
+    if (index < 0) return NULL;
+    chunk_t *chunk = find_chunk(index / CATALOG_WINDOW_CHUNK_SIZE);
+    if (!chunk || chunk->state != CHUNK_LOADED) {
+        if (uses_snapshot() && (s_total < 0 || index < s_total)) return catalog_snapshot_get(index);
+        return NULL;
+    }
+    int position = index % CATALOG_WINDOW_CHUNK_SIZE;
+    return position < chunk->page->project_count ? &chunk->page->projects[position] : NULL;
+}
+
+int catalog_window_count(void) {
+    if (!s_query) return 0;
+    if (s_total >= 0) return s_total;
+    int count = s_known_count + CATALOG_WINDOW_CHUNK_SIZE;
+    if (uses_snapshot() && catalog_snapshot_count() > count) count = catalog_snapshot_count();
+    return count;
+}
+
+bool catalog_window_end_reached(void) {
+    return s_total >= 0;
+}
+
+bool catalog_window_is_loading(void) {
+    if (!s_query) return false;
+    int first_chunk = s_first_visible / CATALOG_WINDOW_CHUNK_SIZE;
+    int last_chunk = (s_last_visible > s_first_visible ? s_last_visible - 1 : s_first_visible) / CATALOG_WINDOW_CHUNK_SIZE;
+    for (int number = first_chunk; number <= last_chunk; number++) {
+        chunk_t *chunk = find_chunk(number);
+        if (chunk && chunk->state == CHUNK_LOADING &&
+            (!uses_snapshot() || number * CATALOG_WINDOW_CHUNK_SIZE >= catalog_snapshot_count())) {
+            return true;
+        }
+    }
+    return false;
+}
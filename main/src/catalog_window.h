@@ -0,0 +1,67 @@
+#ifndef CATALOG_WINDOW_H
+#define CATALOG_WINDOW_H
+
+#include <stdbool.h>
+#include "badgehub_client.h"
+
+// Projects per /project-summaries request.
+#define CATALOG_WINDOW_CHUNK_SIZE 20
+// Chunks kept loaded past the last visible row, and before the first one.
+#define CATALOG_WINDOW_CHUNKS_AHEAD 2
+#define CATALOG_WINDOW_CHUNKS_BEHIND 1
+// Upper bound on the chunks held at once, whatever the scroll position.
+#define CATALOG_WINDOW_MAX_CHUNKS 6
+
+// Called on the LVGL thread when chunks arrive or the catalog turns out to end.
+typedef void (*catalog_window_changed_cb_t)(void *user_data);
+
+/**
+ * @brief Starts browsing the catalog for a search query ("" for everything), dropping
+ * whatever was loaded for the previous one. Loads the first chunk.
+ *
+ * The catalog is held as a sliding window of chunks around the visible rows: chunks
+ * ahead of the scroll position are fetched before they are needed and those that
+ * fall behind are released, so memory stays bounded however far the user scrolls.
+ * Chunks go through the page cache, so scrolling back soon after is served from memory.
+ */
+void catalog_window_start(const char *query, catalog_window_changed_cb_t cb, void *user_data);
+
+/**
+ * @brief Cancels the requests in flight and releases every chunk.
+ */
+void catalog_window_stop(void);
+
+/**
+ * @brief Moves the window to the visible rows [first, last): fetches the chunks
+ * around them that are missing and releases the ones out of range.
+ */
+void catalog_window_set_visible(int first, int last);
+
+/**
+ * @brief Returns the project at a position in the catalog, or NULL if its chunk is
+ * not loaded. The project stays valid until its chunk leaves the window.
+ *
+ * Browsing the whole catalog (query ""), rows whose chunk is not loaded yet come
+ * from the catalog snapshot, if there is one, until the fetched chunk replaces them.
+ */
+const project_t *catalog_window_get(int index);
+
+/**
+ * @brief Returns the number of rows to show: the whole catalog once its end is
+ * known, otherwise the projects seen so far plus a chunk of rows still to load,
+ * or the size of the snapshot if that is larger.
+ */
+int catalog_window_count(void);
+
+/**
+ * @brief Returns true once the last chunk of the catalog has been loaded.
+ */
+bool catalog_window_end_reached(void);
+
+/**
+ * @brief Returns true while a chunk covering the visible rows is still loading
+ * and the snapshot has nothing to show in its place.
+ */
+bool catalog_window_is_loading(void);
+
+#endif // CATALOG_WINDOW_H
@@ -0,0 +1,254 @@
+#include "file_download.h"
+#include "utils.h"
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// --- CONSTANTS ---
+#define READ_CHUNK_SIZE 16384
+
+// Sidecar format, next to the partial file:
+//   offset <bytes on disk>
+//   etag <value>
+//   last-modified <value>
+
+// --- IMPLEMENTATIONS ---
+
+static void sidecar_path(const char *path, char *sidecar, size_t sidecar_size) {
+    snprintf(sidecar, sidecar_size, "%s%s", path, FILE_DOWNLOAD_PARTIAL_SUFFIX);
+}
+
+// If-Range needs a strong ETag; a weak one cannot guarantee byte-identical content.
+static bool has_strong_etag(const icon_validators_t *validators) {
+    return validators->etag[0] && strncmp(validators->etag, "W/", 2) != 0;
+}
+
+static bool can_resume(const icon_validators_t *validators) {
+    return has_strong_etag(validators) || validators->last_modified[0];
+}
+
+static bool read_sidecar(const char *path, icon_validators_t *validators, uint64_t *offset) {
+    char sidecar[520];
+    char line[256];
+    sidecar_path(path, sidecar, sizeof(sidecar));
+    FILE *fp = fopen(sidecar, "r");
+    if (!fp) return false;
+    memset(validators, 0, sizeof(*validators));
+    bool have_offset = false;
+    while (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (strncmp(line, "offset ", 7) == 0) {
+            have_offset = sscanf(line + 7, "%" SCNu64, offset) == 1;
+        } else if (strncmp(line, "etag ", 5) == 0) {
+            snprintf(validators->etag, sizeof(validators->etag), "%s", line + 5);
+        } else if (strncmp(line, "last-modified ", 14) == 0) {
+            snprintf(validators->last_modified, sizeof(validators->last_modified), "%s", line + 14);
+        }
+    }
+    fclose(fp);
+    return have_offset && can_resume(validators);
+}
+
+static bool put_sidecar(FILE *fp, void *context) {
+    const file_download_t *download = context;
+    fprintf(fp, "offset %" PRIu64 "\n", download->sidecar_offset);
+    if (download->validators.etag[0]) fprintf(fp, "etag %s\n", download->validators.etag);
+    if (download->validators.last_modified[0]) fprintf(fp, "last-modified %s\n", download->validators.last_modified);
+    return true;
+}
+
+// Rewritten while the transfer runs, so it goes through write_file_atomic().
+static void write_sidecar(file_download_t *download) {
+    char sidecar[520];
+    sidecar_path(download->path, sidecar, sizeof(sidecar));
+    write_file_atomic(sidecar, put_sidecar, download);
+}
+
+// Records how much of the file has reached the disk, once per writer flush.
+static void update_sidecar(file_download_t *download) {
+    if (!download->resumable || download->writer.position <= download->sidecar_offset) return;
+    download->sidecar_offset = download->writer.position;
+    write_sidecar(download);
+}
+
+// Feeds the first bytes of an existing file to the hash.
+static bool hash_prefix(const char *path, sha256_ctx_t *hash, uint64_t length) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return false;
+    uint8_t buffer[READ_CHUNK_SIZE];
+    while (length > 0) {
+        size_t n = fread(buffer, 1, length < sizeof(buffer) ? (size_t)length : sizeof(buffer), fp);
+        if (n == 0) break;
+        sha256_update(hash, buffer, n);
+        length -= n;
+    }
+    fclose(fp);
+    return length == 0;
+}
+
+static size_t header_cb(char *buffer, size_t size, size_t nitems, void *userdata) {
+    file_download_t *download = userdata;
+    size_t length = size * nitems;
+    static const char content_range[] = "content-range:";
+    if (length >= 5 && strncmp(buffer, "HTTP/", 5) == 0) {
+        // A new response (e.g. after a redirect); forget the previous one's headers.
+        memset(&download->validators, 0, sizeof(download->validators));
+        download->range_start = -1;
+    } else if (length > sizeof(content_range) - 1 && strncasecmp(buffer, content_range, sizeof(content_range) - 1) == 0) {
+        char value[128];
+        size_t n = length - (sizeof(content_range) - 1) < sizeof(value) - 1 ? length - (sizeof(content_range) - 1) : sizeof(value) - 1;
+        memcpy(value, buffer + sizeof(content_range) - 1, n);
+        value[n] = '\0';
+        int64_t start = -1;
+        if (sscanf(value, " bytes %" SCNd64 "-", &start) == 1) download->range_start = start;
+    } else {
+        icon_validators_parse_header(&download->validators, buffer, length);
+    }
+    return length;
+}
+
+static size_t write_cb(void *ptr, size_t size, size_t nmemb, void *userp) {
+    file_download_t *download = userp;
+    size_t length = size * nmemb;
+    if (!download->checked_status) {
+        download->checked_status = true;
+        long status = 0;
+        curl_easy_getinfo(download->handle, CURLINFO_RESPONSE_CODE, &status);
+        if (status == 200 && download->offset > 0) {
+            // The range was ignored or the file changed: start over.
+            if (!file_writer_restart(&download->writer)) return 0;
+            sha256_init(&download->hash);
+            download->offset = 0;
+        } else if (status == 206) {
+            if (download->offset == 0 || download->range_start != (int64_t)download->offset) return 0;
+        } else if (status != 200) {
+            return 0; // An error page must not end up in the file
+        }
+        curl_off_t content_length = -1;
+        if (curl_easy_getinfo(download->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length) == CURLE_OK &&
+            content_length > 0) {
+            file_writer_preallocate(&download->writer, download->offset + (uint64_t)content_length);
+        }
+        // The headers are complete: make the file resumable before the first byte lands,
+        // rather than only when the transfer fails cleanly.
+        download->resumable = can_resume(&download->validators);
+        download->sidecar_offset = download->offset;
+        if (download->resumable) {
+            write_sidecar(download);
+        } else if (download->offset == 0) {
+            // A body that cannot be resumed; a sidecar from an earlier attempt no longer applies.
+            char sidecar[520];
+            sidecar_path(download->path, sidecar, sizeof(sidecar));
+            remove(sidecar);
+        }
+    }
+    if (!file_writer_write(&download->writer, ptr, length)) return 0;
+    update_sidecar(download);
+    // Hash while the chunk is still in cache, so verifying never rereads the file.
+    sha256_update(&download->hash, ptr, length);
+    download->received += length;
+    return length;
+}
+
+bool file_download_begin(file_download_t *download, CURL *handle, const char *path, const char *url,
+                         dir_cache_t *dirs, file_writer_stats_t *stats) {
+    memset(download, 0, sizeof(*download));
+    download->handle = handle;
+    download->range_start = -1;
+    snprintf(download->path, sizeof(download->path), "%s", path);
+    sha256_init(&download->hash);
+    if (dirs) {
+        dir_cache_ensure_parent(dirs, path);
+    } else {
+        ensure_dir_exists(path);
+    }
+
+    icon_validators_t saved;
+    uint64_t saved_offset = 0;
+    struct stat st;
+    // Bytes past the saved offset may be a reservation or an unflushed tail; resume
+    // exactly where the sidecar says the received data ends.
+    if (read_sidecar(path, &saved, &saved_offset) && saved_offset > 0 && stat(path, &st) == 0 &&
+        S_ISREG(st.st_mode) && (uint64_t)st.st_size >= saved_offset &&
+        hash_prefix(path, &download->hash, saved_offset) &&
+        file_writer_open(&download->writer, path, saved_offset, stats)) {
+        char range[32];
+        char if_range[160];
+        download->open = true;
+        download->offset = saved_offset;
+        snprintf(range, sizeof(range), "%" PRIu64 "-", download->offset);
+        snprintf(if_range, sizeof(if_range), "If-Range: %s",
+                 has_strong_etag(&saved) ? saved.etag : saved.last_modified);
+        download->headers = curl_slist_append(NULL, if_range);
+        curl_easy_setopt(handle, CURLOPT_RANGE, range);
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, download->headers);
+    } else {
+        sha256_init(&download->hash);
+        // Whatever is at path may be a hard link to an installed file; never write through it.
+        file_download_discard(path);
+        download->open = file_writer_open(&download->writer, path, 0, stats);
+        if (!download->open) {
+            fprintf(stderr, "Failed to open file for writing: %s\n", path);
+            return false;
+        }
+    }
+    curl_easy_setopt(handle, CURLOPT_URL, url);
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, write_cb);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, (void *)download);
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, header_cb);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, (void *)download);
+    return true;
+}
+
+file_download_result_t file_download_finish(file_download_t *download, CURLcode result, long status,
+                                            const char *expected_sha256) {
+    bool closed = download->open && file_writer_close(&download->writer);
+    download->open = false;
+    curl_slist_free_all(download->headers);
+    download->headers = NULL;
+    char sidecar[520];
+    sidecar_path(download->path, sidecar, sizeof(sidecar));
+
+    if (closed && result == CURLE_OK && (status == 200 || status == 206)) {
+        uint8_t digest[SHA256_DIGEST_SIZE];
+        sha256_final(&download->hash, digest);
+        sha256_to_hex(digest, download->sha256);
+        remove(sidecar);
+        if (expected_sha256 && expected_sha256[0] && !sha256_hex_equal(download->sha256, expected_sha256)) {
+            fprintf(stderr, "Checksum mismatch for %s: expected %s, got %s\n", download->path, expected_sha256, download->sha256);
+            remove(download->path);
+            return FILE_DOWNLOAD_MISMATCH;
+        }
+        return FILE_DOWNLOAD_OK;
+    }
+
+    uint64_t on_disk = download->offset + download->received;
+    if (closed && (status == 200 || status == 206) && on_disk > 0 && can_resume(&download->validators)) {
+        // Interrupted mid-body: keep what arrived for a Range request next time.
+        download->sidecar_offset = on_disk;
+        write_sidecar(download);
+    } else if (!closed || download->offset == 0 || status == 416) {
+        // Nothing worth resuming, a file that could not be written completely, or
+        // a range the server no longer accepts.
+        file_download_discard(download->path);
+    }
+    // Otherwise the transfer failed before touching the partial file; its sidecar still holds.
+    return FILE_DOWNLOAD_FAILED;
+}
+
+bool file_download_has_partial(const char *path) {
+    char sidecar[520];
+    struct stat st;
+    sidecar_path(path, sidecar, sizeof(sidecar));
+    return stat(sidecar, &st) == 0;
+}
+
+void file_download_discard(const char *path) {
+    char sidecar[520];
+    sidecar_path(path, sidecar, sizeof(sidecar));
+    remove(path);
+    remove(sidecar);
+}
@@ -0,0 +1,90 @@
+#ifndef FILE_DOWNLOAD_H
+#define FILE_DOWNLOAD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <curl/curl.h>
+#include "file_writer.h"
+#include "icon_disk_cache.h"
+#include "sha256.h"
+
+// Appended to a file's path to name the sidecar that makes a partial download resumable.
+#define FILE_DOWNLOAD_PARTIAL_SUFFIX ".partial"
+
+typedef enum {
+    FILE_DOWNLOAD_OK,
+    FILE_DOWNLOAD_FAILED,    // Transfer or HTTP error; a partial file may have been kept for resuming
+    FILE_DOWNLOAD_MISMATCH,  // Complete, but the sha256 differs; nothing is kept
+} file_download_result_t;
+
+// A file being downloaded to disk, hashed as it is written.
+typedef struct {
+    CURL *handle;
+    file_writer_t writer;
+    bool open;                    // Whether writer holds an open file
+    sha256_ctx_t hash;
+    uint64_t offset;              // Bytes already on disk when the transfer started
+    uint64_t received;            // Bytes written by this transfer
+    bool checked_status;          // Whether the first body chunk has been seen
+    bool resumable;               // Whether the response's validators allow resuming it
+    uint64_t sidecar_offset;      // Offset the sidecar on disk records
+    int64_t range_start;          // First byte of a 206 response's Content-Range, -1 if none
+    icon_validators_t validators; // ETag / Last-Modified of the response
+    struct curl_slist *headers;
+    char sha256[SHA256_HEX_SIZE]; // Digest of the complete file, set by file_download_finish()
+    char path[512];
+} file_download_t;
+
+/**
+ * @brief Opens the destination file and configures an easy handle to write to it.
+ *
+ * The body goes through a file_writer_t, and the file is preallocated from the
+ * response's Content-Length.
+ *
+ * If a previous transfer left a partial file and a sidecar with a strong ETag or a
+ * Last-Modified date, the download resumes with a Range / If-Range request; the
+ * part already on disk is hashed once so the final digest covers the whole file.
+ * A server that ignores the range, or whose file changed, gets the whole file
+ * written from the start.
+ *
+ * The sidecar is written as soon as the response's validators are known and its
+ * offset advanced whenever the writer flushes, so a download cut short by a crash
+ * or power loss resumes from the last flush. Data a power loss kept from reaching
+ * the disk shows up as a digest mismatch, after which the file is fetched anew.
+ *
+ * @param download The download state; must stay at the same address until finished.
+ * @param path Where to store the file. Parent directories are created.
+ * @param url The URL to fetch.
+ * @param dirs Directories already created by the caller's other downloads, or NULL.
+ * @param stats Where to count the I/O, or NULL.
+ * @return false if the file could not be opened.
+ */
+bool file_download_begin(file_download_t *download, CURL *handle, const char *path, const char *url,
+                         dir_cache_t *dirs, file_writer_stats_t *stats);
+
+/**
+ * @brief Closes the file once the transfer has ended and verifies it.
+ *
+ * On success the sidecar is removed and download->sha256 holds the digest. On
+ * failure the partial file is kept, its sidecar updated to the flushed end, if the
+ * server sent a validator that allows resuming it; otherwise it is removed.
+ *
+ * @param result The transfer's CURLcode.
+ * @param status The HTTP status, 0 if none was received.
+ * @param expected_sha256 The expected digest; NULL or empty skips verification.
+ */
+file_download_result_t file_download_finish(file_download_t *download, CURLcode result, long status,
+                                            const char *expected_sha256);
+
+/**
+ * @brief Returns whether a resumable partial download exists for path.
+ */
+bool file_download_has_partial(const char *path);
+
+/**
+ * @brief Removes a file and its partial-download sidecar, if any.
+ */
+void file_download_discard(const char *path);
+
+#endif // FILE_DOWNLOAD_H
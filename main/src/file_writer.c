@@ -0,0 +1,221 @@
+#define _GNU_SOURCE // posix_fallocate(), pwrite()
+#include "file_writer.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// --- CONSTANTS ---
+#define DIR_CACHE_MIN_SLOTS 64
+
+struct dir_cache {
+    char **slots; // Open-addressing set of directory paths
+    size_t slot_count;
+    size_t used;
+    file_writer_stats_t *stats;
+};
+
+// --- STATIC STATE VARIABLES ---
+static uint8_t *s_free_buffers[FILE_WRITER_POOL_SIZE];
+static int s_free_count = 0;
+
+// --- IMPLEMENTATIONS ---
+
+static uint8_t *acquire_buffer(void) {
+    if (s_free_count > 0) return s_free_buffers[--s_free_count];
+    void *buffer = NULL;
+    return posix_memalign(&buffer, FILE_WRITER_ALIGNMENT, FILE_WRITER_BUFFER_SIZE) == 0 ? buffer : NULL;
+}
+
+static void release_buffer(uint8_t *buffer) {
+    if (!buffer) return;
+    if (s_free_count < FILE_WRITER_POOL_SIZE) {
+        s_free_buffers[s_free_count++] = buffer;
+    } else {
+        free(buffer);
+    }
+}
+
+void file_writer_pool_clear(void) {
+    while (s_free_count > 0) free(s_free_buffers[--s_free_count]);
+}
+
+// Writes the buffer at its file offset and empties it.
+static bool flush_buffer(file_writer_t *writer) {
+    size_t done = 0;
+    while (done < writer->used) {
+        ssize_t n = pwrite(writer->fd, writer->buffer + done, writer->used - done, (off_t)(writer->position + done));
+        if (writer->stats) writer->stats->write_calls++;
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += (size_t)n;
+    }
+    if (writer->stats) writer->stats->bytes_written += writer->used;
+    writer->position += writer->used;
+    writer->used = 0;
+    writer->flush_at = FILE_WRITER_BUFFER_SIZE;
+    return true;
+}
+
+bool file_writer_open(file_writer_t *writer, const char *path, uint64_t offset, file_writer_stats_t *stats) {
+    memset(writer, 0, sizeof(*writer));
+    writer->fd = open(path, offset > 0 ? O_WRONLY : O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (writer->fd < 0) return false;
+    writer->buffer = acquire_buffer();
+    if (!writer->buffer || (offset > 0 && ftruncate(writer->fd, (off_t)offset) != 0)) {
+        release_buffer(writer->buffer);
+        close(writer->fd);
+        writer->fd = -1;
+        return false;
+    }
+    writer->position = offset;
+    // A resumed file starts mid-block; the first flush ends on the next boundary.
+    writer->flush_at = FILE_WRITER_BUFFER_SIZE - (size_t)(offset % FILE_WRITER_ALIGNMENT);
+    writer->stats = stats;
+    if (stats) stats->files++;
+    return true;
+}
+
+bool file_writer_write(file_writer_t *writer, const void *data, size_t size) {
+    const uint8_t *bytes = data;
+    while (size > 0) {
+        size_t n = writer->flush_at - writer->used;
+        if (n > size) n = size;
+        memcpy(writer->buffer + writer->used, bytes, n);
+        writer->used += n;
+        bytes += n;
+        size -= n;
+        if (writer->used == writer->flush_at && !flush_buffer(writer)) return false;
+    }
+    return true;
+}
+
+void file_writer_preallocate(file_writer_t *writer, uint64_t size) {
+#ifdef __linux__
+    uint64_t current = file_writer_size(writer);
+    if (size <= current || posix_fallocate(writer->fd, (off_t)current, (off_t)(size - current)) != 0) return;
+    writer->preallocated = true;
+    if (writer->stats) writer->stats->preallocated_bytes += size - current;
+#else
+    (void)writer;
+    (void)size;
+#endif
+}
+
+bool file_writer_restart(file_writer_t *writer) {
+    writer->used = 0;
+    writer->position = 0;
+    writer->flush_at = FILE_WRITER_BUFFER_SIZE;
+    writer->preallocated = false;
+    return ftruncate(writer->fd, 0) == 0;
+}
+
+uint64_t file_writer_size(const file_writer_t *writer) {
+    return writer->position + writer->used;
+}
+
+bool file_writer_close(file_writer_t *writer) {
+    if (writer->fd < 0) return false;
+    bool ok = flush_buffer(writer);
+    // Give back a reservation the transfer did not fill, e.g. when it was cut short.
+    if (writer->preallocated && ftruncate(writer->fd, (off_t)writer->position) != 0) ok = false;
+    ok = close(writer->fd) == 0 && ok;
+    release_buffer(writer->buffer);
+    writer->buffer = NULL;
+    writer->fd = -1;
+    return ok;
+}
+
+// --- DIRECTORY CACHE ---
+
+// FNV-1a
+static size_t hash_path(const char *path) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char *p = (const unsigned char *)path; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return (size_t)hash;
+}
+
+static char **find_slot(const dir_cache_t *cache, const char *dir) {
+    size_t mask = cache->slot_count - 1;
+    size_t slot = hash_path(dir) & mask;
+    while (cache->slots[slot] && strcmp(cache->slots[slot], dir) != 0) slot = (slot + 1) & mask;
+    return &cache->slots[slot];
+}
+
+static void remember_dir(dir_cache_t *cache, const char *dir) {
+    if ((cache->used + 1) * 2 > cache->slot_count) {
+        size_t slot_count = cache->slot_count * 2;
+        char **slots = calloc(slot_count, sizeof(char *));
+        if (!slots) return; // Only means asking the filesystem again
+        char **old_slots = cache->slots;
+        size_t old_count = cache->slot_count;
+        cache->slots = slots;
+        cache->slot_count = slot_count;
+        for (size_t i = 0; i < old_count; i++) {
+            if (old_slots[i]) *find_slot(cache, old_slots[i]) = old_slots[i];
+        }
+        free(old_slots);
+    }
+    char **slot = find_slot(cache, dir);
+    if (*slot) return;
+    *slot = strdup(dir);
+    if (*slot) cache->used++;
+}
+
+static bool make_dir(dir_cache_t *cache, const char *dir) {
+    if (cache->stats) cache->stats->mkdir_calls++;
+    return mkdir(dir, 0755) == 0 || errno == EEXIST;
+}
+
+// Creates dir, a mutable buffer, and whatever of its parents is missing. The leaf is
+// tried first: usually only it is new, and then one mkdir is all it takes.
+static bool ensure_dir(dir_cache_t *cache, char *dir) {
+    if (*find_slot(cache, dir)) return true;
+    if (!make_dir(cache, dir)) {
+        char *slash = strrchr(dir, '/');
+        if (errno != ENOENT || !slash || slash == dir) return false;
+        *slash = '\0';
+        bool ok = ensure_dir(cache, dir);
+        *slash = '/';
+        if (!ok || !make_dir(cache, dir)) return false;
+    }
+    remember_dir(cache, dir);
+    return true;
+}
+
+dir_cache_t *dir_cache_create(file_writer_stats_t *stats) {
+    dir_cache_t *cache = calloc(1, sizeof(dir_cache_t));
+    if (!cache) return NULL;
+    cache->slots = calloc(DIR_CACHE_MIN_SLOTS, sizeof(char *));
+    if (!cache->slots) {
+        free(cache);
+        return NULL;
+    }
+    cache->slot_count = DIR_CACHE_MIN_SLOTS;
+    cache->stats = stats;
+    return cache;
+}
+
+bool dir_cache_ensure_parent(dir_cache_t *cache, const char *path) {
+    const char *slash = strrchr(path, '/');
+    if (!slash || slash == path) return true;
+    char dir[512];
+    size_t length = (size_t)(slash - path);
+    if (length >= sizeof(dir)) return false;
+    memcpy(dir, path, length);
+    dir[length] = '\0';
+    return ensure_dir(cache, dir);
+}
+
+void dir_cache_destroy(dir_cache_t *cache) {
+    if (!cache) return;
+    for (size_t i = 0; i < cache->slot_count; i++) free(cache->slots[i]);
+    free(cache->slots);
+    free(cache);
+}
@@ -0,0 +1,104 @@
+#ifndef FILE_WRITER_H
+#define FILE_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Size of the write buffer of each open file. Flash storage handles a few large
+// writes far better than many chunk-sized ones.
+#define FILE_WRITER_BUFFER_SIZE (128 * 1024)
+// Buffers, and the file offsets they are flushed at, are aligned to this.
+#define FILE_WRITER_ALIGNMENT 4096
+// Buffers kept for reuse once their file is closed.
+#define FILE_WRITER_POOL_SIZE 4
+
+// I/O done on behalf of one install (or any other group of files).
+typedef struct {
+    uint64_t files;              // Files opened for writing
+    uint64_t bytes_written;
+    uint64_t write_calls;        // write system calls
+    uint64_t mkdir_calls;        // mkdir system calls
+    uint64_t preallocated_bytes; // Reserved up front from Content-Length
+} file_writer_stats_t;
+
+// A file being written through a large aligned buffer.
+typedef struct {
+    int fd;
+    uint8_t *buffer;
+    size_t used;
+    size_t flush_at;      // Fill level at which the buffer ends on an aligned file offset
+    uint64_t position;    // File offset of buffer[0]
+    bool preallocated;
+    file_writer_stats_t *stats;
+} file_writer_t;
+
+// Directories known to exist, so each is created once per install rather than
+// once per path component of every file.
+typedef struct dir_cache dir_cache_t;
+
+/**
+ * @brief Opens a file for writing at offset.
+ *
+ * With offset 0 the file is created or truncated. Otherwise the file must exist
+ * and anything past offset is discarded, so writing resumes exactly there.
+ *
+ * @param stats Where to count the I/O, or NULL.
+ * @return false if the file could not be opened.
+ */
+bool file_writer_open(file_writer_t *writer, const char *path, uint64_t offset, file_writer_stats_t *stats);
+
+/**
+ * @brief Appends data, writing to the file only when the buffer is full.
+ */
+bool file_writer_write(file_writer_t *writer, const void *data, size_t size);
+
+/**
+ * @brief Reserves space for a file expected to reach size bytes, so the filesystem
+ * can allocate it in one piece. The reservation beyond what was written is given
+ * back by file_writer_close(). Does nothing where posix_fallocate() is unavailable.
+ */
+void file_writer_preallocate(file_writer_t *writer, uint64_t size);
+
+/**
+ * @brief Discards everything written so far and starts over at offset 0.
+ */
+bool file_writer_restart(file_writer_t *writer);
+
+/**
+ * @brief Returns the size the file has once the buffer is flushed.
+ */
+uint64_t file_writer_size(const file_writer_t *writer);
+
+/**
+ * @brief Flushes the buffer and closes the file.
+ *
+ * @return false if any write failed; the file's contents are then incomplete.
+ */
+bool file_writer_close(file_writer_t *writer);
+
+/**
+ * @brief Frees the pooled buffers.
+ */
+void file_writer_pool_clear(void);
+
+/**
+ * @brief Creates an empty directory cache.
+ *
+ * @param stats Where to count mkdir calls, or NULL.
+ */
+dir_cache_t *dir_cache_create(file_writer_stats_t *stats);
+
+/**
+ * @brief Creates the parent directories of path that are not known to exist yet.
+ *
+ * @return false if a directory could not be created.
+ */
+bool dir_cache_ensure_parent(dir_cache_t *cache, const char *path);
+
+/**
+ * @brief Frees a directory cache. NULL is ignored.
+ */
+void dir_cache_destroy(dir_cache_t *cache);
+
+#endif // FILE_WRITER_H
@@ -0,0 +1,327 @@
+#include "headless_display.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// --- CONSTANTS ---
+#define SCRIPT_LINE_SIZE 512
+#define DEFAULT_DRAG_STEPS 10
+
+typedef enum {
+    STEP_TAP,
+    STEP_DRAG,
+    STEP_KEY,
+    STEP_WAIT,
+    STEP_SCREENSHOT,
+    STEP_QUIT,
+} script_step_type_t;
+
+typedef struct {
+    script_step_type_t type;
+    int32_t x0, y0, x1, y1;
+    int moves;     // Drag: intermediate positions between press and release
+    uint32_t key;
+    uint32_t ms;
+    char *path;
+} script_step_t;
+
+typedef struct {
+    const char *name;
+    uint32_t key;
+} key_name_t;
+
+static const key_name_t KEY_NAMES[] = {
+    { "up", LV_KEY_UP },       { "down", LV_KEY_DOWN },   { "left", LV_KEY_LEFT },
+    { "right", LV_KEY_RIGHT }, { "enter", LV_KEY_ENTER }, { "esc", LV_KEY_ESC },
+    { "backspace", LV_KEY_BACKSPACE }, { "del", LV_KEY_DEL }, { "next", LV_KEY_NEXT },
+    { "prev", LV_KEY_PREV },   { "home", LV_KEY_HOME },   { "end", LV_KEY_END },
+    { "space", ' ' },
+};
+
+// --- STATIC STATE VARIABLES ---
+static lv_display_t *s_display = NULL;
+static void *s_framebuffer = NULL; // Unaligned allocation holding the draw buffer
+static uint8_t *s_pixels = NULL;
+static headless_display_stats_t s_stats;
+
+static lv_indev_t *s_pointer = NULL;
+static lv_indev_t *s_keypad = NULL;
+static lv_point_t s_point = { 0, 0 };
+static bool s_pointer_pressed = false;
+static uint32_t s_key = 0;
+static bool s_key_pressed = false;
+
+static script_step_t *s_steps = NULL;
+static int s_step_count = 0;
+static int s_current = 0;
+static int s_phase = 0;           // Progress within the current step
+static uint32_t s_wait_start = 0;
+static bool s_finished = false;
+
+// --- IMPLEMENTATIONS ---
+
+static uint32_t tick_get_cb(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    // Direct mode renders straight into the framebuffer; there is nothing to copy.
+    s_stats.pixels_flushed += (uint64_t)lv_area_get_width(area) * lv_area_get_height(area);
+    if (lv_display_flush_is_last(disp)) s_stats.frames++;
+    lv_display_flush_ready(disp);
+}
+
+lv_display_t *headless_display_create(int32_t width, int32_t height) {
+    lv_tick_set_cb(tick_get_cb);
+    lv_display_t *disp = lv_display_create(width, height);
+    if (!disp) return NULL;
+    lv_color_format_t cf = lv_display_get_color_format(disp);
+    uint32_t size = lv_draw_buf_width_to_stride(width, cf) * height;
+    s_framebuffer = malloc(size + LV_DRAW_BUF_ALIGN);
+    if (!s_framebuffer) {
+        lv_display_delete(disp);
+        return NULL;
+    }
+    s_pixels = lv_draw_buf_align(s_framebuffer, cf);
+    memset(s_pixels, 0, size);
+    lv_display_set_buffers(disp, s_pixels, NULL, size, LV_DISPLAY_RENDER_MODE_DIRECT);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_set_default(disp);
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_display = disp;
+    return disp;
+}
+
+headless_display_stats_t headless_display_get_stats(void) {
+    return s_stats;
+}
+
+bool headless_display_save_ppm(const char *path) {
+    if (!s_display) return false;
+    int32_t width = lv_display_get_horizontal_resolution(s_display);
+    int32_t height = lv_display_get_vertical_resolution(s_display);
+    lv_color_format_t cf = lv_display_get_color_format(s_display);
+    uint32_t stride = lv_draw_buf_width_to_stride(width, cf);
+    uint32_t pixel_size = lv_color_format_get_size(cf);
+    if (pixel_size != 2 && pixel_size < 3) return false;
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return false;
+    fprintf(fp, "P6\n%d %d\n255\n", (int)width, (int)height);
+    bool ok = true;
+    for (int32_t y = 0; ok && y < height; y++) {
+        const uint8_t *row = s_pixels + (size_t)y * stride;
+        for (int32_t x = 0; ok && x < width; x++) {
+            uint8_t rgb[3];
+            if (pixel_size == 2) {
+                uint16_t c = (uint16_t)(row[x * 2] | row[x * 2 + 1] << 8); // RGB565
+                rgb[0] = (uint8_t)((c >> 11) << 3);
+                rgb[1] = (uint8_t)(((c >> 5) & 0x3F) << 2);
+                rgb[2] = (uint8_t)((c & 0x1F) << 3);
+            } else {
+                const uint8_t *p = row + x * pixel_size; // B, G, R[, A]
+                rgb[0] = p[2];
+                rgb[1] = p[1];
+                rgb[2] = p[0];
+            }
+            ok = fwrite(rgb, 1, sizeof(rgb), fp) == sizeof(rgb);
+        }
+    }
+    return fclose(fp) == 0 && ok;
+}
+
+static void next_step(void) {
+    s_current++;
+    s_phase = 0;
+}
+
+// Runs the steps at the head of the script that need no input device. Returns the
+// step an input device has to carry out, or NULL.
+static const script_step_t *current_step(void) {
+    while (!s_finished && s_current < s_step_count) {
+        const script_step_t *step = &s_steps[s_current];
+        if (step->type == STEP_WAIT) {
+            if (s_phase == 0) {
+                s_wait_start = lv_tick_get();
+                s_phase = 1;
+            }
+            if (lv_tick_elaps(s_wait_start) < step->ms) return NULL;
+            next_step();
+        } else if (step->type == STEP_SCREENSHOT) {
+            if (!headless_display_save_ppm(step->path)) fprintf(stderr, "Failed to save %s\n", step->path);
+            next_step();
+        } else if (step->type == STEP_QUIT) {
+            s_finished = true;
+        } else {
+            return step;
+        }
+    }
+    return NULL;
+}
+
+static void pointer_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+    const script_step_t *step = current_step();
+    if (step && (step->type == STEP_TAP || step->type == STEP_DRAG)) {
+        int moves = step->type == STEP_DRAG ? step->moves : 0;
+        if (s_phase <= moves) {
+            // Phase 0 presses at the start; phases 1..moves walk towards the end.
+            s_point.x = step->x0 + (step->x1 - step->x0) * s_phase / (moves > 0 ? moves : 1);
+            s_point.y = step->y0 + (step->y1 - step->y0) * s_phase / (moves > 0 ? moves : 1);
+            s_pointer_pressed = true;
+            s_phase++;
+        } else {
+            s_pointer_pressed = false;
+            next_step();
+        }
+    }
+    data->point = s_point;
+    data->state = s_pointer_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+static void keypad_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+    const script_step_t *step = current_step();
+    if (step && step->type == STEP_KEY) {
+        if (s_phase == 0) {
+            s_key = step->key;
+            s_key_pressed = true;
+            s_phase++;
+        } else {
+            s_key_pressed = false;
+            next_step();
+        }
+    }
+    data->key = s_key;
+    data->state = s_key_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+}
+
+void headless_input_create(lv_group_t *group) {
+    s_pointer = lv_indev_create();
+    lv_indev_set_type(s_pointer, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(s_pointer, pointer_read_cb);
+    lv_indev_set_display(s_pointer, s_display);
+
+    s_keypad = lv_indev_create();
+    lv_indev_set_type(s_keypad, LV_INDEV_TYPE_KEYPAD);
+    lv_indev_set_read_cb(s_keypad, keypad_read_cb);
+    lv_indev_set_display(s_keypad, s_display);
+    lv_indev_set_group(s_keypad, group);
+}
+
+static void free_script(void) {
+    for (int i = 0; i < s_step_count; i++) free(s_steps[i].path);
+    free(s_steps);
+    s_steps = NULL;
+    s_step_count = s_current = s_phase = 0;
+    s_finished = false;
+}
+
+static script_step_t *append_step(int *capacity) {
+    if (s_step_count == *capacity) {
+        int grown_capacity = *capacity > 0 ? *capacity * 2 : 16;
+        script_step_t *grown = realloc(s_steps, grown_capacity * sizeof(script_step_t));
+        if (!grown) return NULL;
+        s_steps = grown;
+        *capacity = grown_capacity;
+    }
+    script_step_t *step = &s_steps[s_step_count++];
+    memset(step, 0, sizeof(*step));
+    return step;
+}
+
+static bool parse_key(const char *name, uint32_t *key) {
+    for (size_t i = 0; i < sizeof(KEY_NAMES) / sizeof(KEY_NAMES[0]); i++) {
+        if (strcmp(name, KEY_NAMES[i].name) == 0) {
+            *key = KEY_NAMES[i].key;
+            return true;
+        }
+    }
+    if (strlen(name) != 1) return false;
+    *key = (unsigned char)name[0];
+    return true;
+}
+
+static bool parse_line(char *line, int *capacity) {
+    char command[16];
+    int consumed = 0;
+    if (sscanf(line, "%15s %n", command, &consumed) != 1 || command[0] == '#') return true;
+    char *args = line + consumed;
+    script_step_t *step = NULL;
+    if (strcmp(command, "type") == 0) {
+        for (char *c = args; *c; c++) {
+            if (!(step = append_step(capacity))) return false;
+            step->type = STEP_KEY;
+            step->key = (unsigned char)*c;
+        }
+        return true;
+    }
+    if (!(step = append_step(capacity))) return false;
+    if (strcmp(command, "tap") == 0) {
+        step->type = STEP_TAP;
+        if (sscanf(args, "%" SCNd32 " %" SCNd32, &step->x0, &step->y0) != 2) return false;
+        step->x1 = step->x0;
+        step->y1 = step->y0;
+    } else if (strcmp(command, "drag") == 0) {
+        step->type = STEP_DRAG;
+        step->moves = DEFAULT_DRAG_STEPS;
+        if (sscanf(args, "%" SCNd32 " %" SCNd32 " %" SCNd32 " %" SCNd32 " %d", &step->x0, &step->y0, &step->x1,
+                   &step->y1, &step->moves) < 4 || step->moves < 1) {
+            return false;
+        }
+    } else if (strcmp(command, "key") == 0) {
+        step->type = STEP_KEY;
+        return parse_key(args, &step->key);
+    } else if (strcmp(command, "wait") == 0) {
+        step->type = STEP_WAIT;
+        return sscanf(args, "%" SCNu32, &step->ms) == 1;
+    } else if (strcmp(command, "screenshot") == 0) {
+        step->type = STEP_SCREENSHOT;
+        step->path = strdup(args);
+        return step->path && step->path[0];
+    } else if (strcmp(command, "quit") == 0) {
+        step->type = STEP_QUIT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool headless_input_load_script(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        fprintf(stderr, "Failed to open input script %s\n", path);
+        return false;
+    }
+    free_script();
+    char line[SCRIPT_LINE_SIZE];
+    int capacity = 0;
+    int line_number = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), fp)) {
+        line_number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        ok = parse_line(line, &capacity);
+        if (!ok) fprintf(stderr, "%s:%d: invalid input script line: %s\n", path, line_number, line);
+    }
+    fclose(fp);
+    if (!ok) free_script();
+    return ok;
+}
+
+bool headless_input_finished(void) {
+    return s_finished;
+}
+
+void headless_display_deinit(void) {
+    free_script();
+    if (s_pointer) lv_indev_delete(s_pointer);
+    if (s_keypad) lv_indev_delete(s_keypad);
+    s_pointer = s_keypad = NULL;
+    if (s_display) lv_display_delete(s_display);
+    s_display = NULL;
+    free(s_framebuffer);
+    s_framebuffer = NULL;
+    s_pixels = NULL;
+}
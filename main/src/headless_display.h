@@ -0,0 +1,72 @@
+#ifndef HEADLESS_DISPLAY_H
+#define HEADLESS_DISPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl/lvgl.h"
+
+// Rendering done by the headless display since it was created.
+typedef struct {
+    uint32_t frames;          // Completed refreshes, i.e. last flushes of a frame
+    uint64_t pixels_flushed;  // Sum of the flushed areas
+} headless_display_stats_t;
+
+/**
+ * @brief Creates a display that renders into a framebuffer in memory instead of a
+ * window, and makes it the default display. Also installs a monotonic tick source,
+ * which the SDL driver provides otherwise. Call after lv_init().
+ *
+ * @return The display, or NULL if the framebuffer could not be allocated.
+ */
+lv_display_t *headless_display_create(int32_t width, int32_t height);
+
+/**
+ * @brief Returns the rendering statistics of the headless display.
+ */
+headless_display_stats_t headless_display_get_stats(void);
+
+/**
+ * @brief Writes the last rendered frame as a binary PPM image.
+ *
+ * @return false if there is no headless display or the file could not be written.
+ */
+bool headless_display_save_ppm(const char *path);
+
+/**
+ * @brief Creates a pointer and a keypad input device fed by a script instead of a
+ * mouse and keyboard. The keypad sends its keys to group.
+ */
+void headless_input_create(lv_group_t *group);
+
+/**
+ * @brief Loads an input script, replacing any script still running.
+ *
+ * One command per line; blank lines and lines starting with '#' are skipped:
+ *
+ *   tap <x> <y>                        press and release at a point
+ *   drag <x0> <y0> <x1> <y1> [steps]   press, move in steps, release
+ *   key <name|char>                    press a key: up, down, left, right, enter,
+ *                                      esc, backspace, del, next, prev, home, end
+ *   type <text>                        press each character of the rest of the line
+ *   wait <ms>                          do nothing for a while
+ *   screenshot <path>                  save the framebuffer (see headless_display_save_ppm())
+ *   quit                               end the script; headless_input_finished() turns true
+ *
+ * Each press and release is held for at least one read of its input device, so
+ * the commands run at the pace LVGL polls input.
+ *
+ * @return false if the file could not be read or has an invalid line.
+ */
+bool headless_input_load_script(const char *path);
+
+/**
+ * @brief Returns whether the script reached "quit".
+ */
+bool headless_input_finished(void);
+
+/**
+ * @brief Deletes the input devices and the display, and frees the framebuffer.
+ */
+void headless_display_deinit(void);
+
+#endif // HEADLESS_DISPLAY_H
@@ -0,0 +1,162 @@
+#include "http_async.h"
+#include "http_pool.h"
+#include "response_buffer.h"
+#include "lvgl/lvgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// --- CONSTANTS ---
+#define POLL_PERIOD_MS 5
+
+struct http_request {
+    CURL *handle;
+    http_async_cb_t cb;
+    void *user_data;
+    response_buffer_t *body; // Pooled buffer for buffered requests, NULL otherwise
+    http_request_t *prev;
+    http_request_t *next;
+};
+
+// --- STATIC STATE VARIABLES ---
+static CURLM *s_multi = NULL;
+static lv_timer_t *s_poll_timer = NULL;
+static http_request_t *s_active = NULL; // Doubly linked list of in-flight requests
+static int s_active_count = 0;
+
+// --- FORWARD DECLARATIONS ---
+static void poll_timer_cb(lv_timer_t *timer);
+static void finish_request(http_request_t *request, CURLcode result, bool cancelled);
+
+// --- IMPLEMENTATIONS ---
+
+bool http_async_init(void) {
+    if (s_multi) return true;
+    s_multi = curl_multi_init();
+    if (!s_multi) {
+        fprintf(stderr, "curl_multi_init() failed\n");
+        return false;
+    }
+    // Let concurrent requests to the same host share one HTTP/2 connection.
+    curl_multi_setopt(s_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    s_poll_timer = lv_timer_create(poll_timer_cb, POLL_PERIOD_MS, NULL);
+    lv_timer_pause(s_poll_timer);
+    return true;
+}
+
+void http_async_deinit(void) {
+    while (s_active) {
+        http_async_cancel(s_active);
+    }
+    if (s_poll_timer) {
+        lv_timer_del(s_poll_timer);
+        s_poll_timer = NULL;
+    }
+    if (s_multi) {
+        curl_multi_cleanup(s_multi);
+        s_multi = NULL;
+    }
+}
+
+http_request_t *http_async_submit(CURL *handle, bool buffer_body, http_async_cb_t cb, void *user_data) {
+    if (!handle) return NULL;
+    if (!s_multi && !http_async_init()) {
+        http_pool_release(handle);
+        return NULL;
+    }
+
+    http_request_t *request = calloc(1, sizeof(http_request_t));
+    if (!request) {
+        http_pool_release(handle);
+        return NULL;
+    }
+    request->handle = handle;
+    request->cb = cb;
+    request->user_data = user_data;
+
+    if (buffer_body) {
+        request->body = response_buffer_acquire(0);
+        if (!request->body) {
+            free(request);
+            http_pool_release(handle);
+            return NULL;
+        }
+        response_buffer_attach(request->body, handle);
+    }
+    curl_easy_setopt(handle, CURLOPT_PRIVATE, request);
+
+    if (curl_multi_add_handle(s_multi, handle) != CURLM_OK) {
+        response_buffer_release(request->body);
+        free(request);
+        http_pool_release(handle);
+        return NULL;
+    }
+
+    request->next = s_active;
+    if (s_active) s_active->prev = request;
+    s_active = request;
+    s_active_count++;
+    lv_timer_resume(s_poll_timer);
+    return request;
+}
+
+void http_async_cancel(http_request_t *request) {
+    if (!request) return;
+    finish_request(request, CURLE_ABORTED_BY_CALLBACK, true);
+}
+
+int http_async_active_count(void) {
+    return s_active_count;
+}
+
+static void finish_request(http_request_t *request, CURLcode result, bool cancelled) {
+    curl_multi_remove_handle(s_multi, request->handle);
+
+    if (request->prev) request->prev->next = request->next;
+    else s_active = request->next;
+    if (request->next) request->next->prev = request->prev;
+    s_active_count--;
+
+    http_response_t response = {
+        .result = result,
+        .status = 0,
+        .cancelled = cancelled,
+        .body = NULL,
+        .body_size = 0,
+        .handle = request->handle,
+    };
+    if (!cancelled) {
+        curl_easy_getinfo(request->handle, CURLINFO_RESPONSE_CODE, &response.status);
+    }
+    if (request->body && request->body->size > 0) {
+        response.body = request->body->data;
+        response.body_size = request->body->size;
+    }
+
+    if (request->cb) {
+        request->cb(&response, request->user_data);
+    }
+
+    response_buffer_release(request->body);
+    http_pool_release(request->handle);
+    free(request);
+
+    if (s_active_count == 0 && s_poll_timer) {
+        lv_timer_pause(s_poll_timer);
+    }
+}
+
+static void poll_timer_cb(lv_timer_t *timer) {
+    int running = 0;
+    curl_multi_perform(s_multi, &running);
+
+    CURLMsg *msg;
+    int msgs_left = 0;
+    while ((msg = curl_multi_info_read(s_multi, &msgs_left))) {
+        if (msg->msg != CURLMSG_DONE) continue;
+        http_request_t *request = NULL;
+        curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char **)&request);
+        if (request) {
+            finish_request(request, msg->data.result, false);
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef HTTP_ASYNC_H
+#define HTTP_ASYNC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <curl/curl.h>
+
+typedef struct http_request http_request_t;
+
+// Outcome of an asynchronous request, passed to the completion callback.
+typedef struct {
+    CURLcode result;
+    long status;       // HTTP status code, 0 if no response was received
+    bool cancelled;    // True when the request was cancelled with http_async_cancel()
+    const char *body;  // Buffered response body (NUL terminated), NULL if empty or not buffered
+    size_t body_size;
+    CURL *handle;      // The easy handle, valid only for the duration of the callback (e.g. for curl_easy_getinfo)
+} http_response_t;
+
+typedef void (*http_async_cb_t)(const http_response_t *response, void *user_data);
+
+/**
+ * @brief Creates the curl multi handle and the LVGL timer that drives it.
+ *
+ * Transfers progress from lv_timer_handler(), so completion callbacks always
+ * run on the LVGL thread and the UI keeps rendering while requests are in flight.
+ * Requires lv_init() and http_pool_init() to have been called.
+ *
+ * @return true on success.
+ */
+bool http_async_init(void);
+
+/**
+ * @brief Cancels all outstanding requests and destroys the multi handle and timer.
+ */
+void http_async_deinit(void);
+
+/**
+ * @brief Starts a request on a handle the caller has already configured.
+ *
+ * The handle must come from http_pool_acquire() and must not use CURLOPT_PRIVATE.
+ * Ownership moves to the async layer, which returns it to the pool once the
+ * callback has run.
+ *
+ * @param handle A configured easy handle from http_pool_acquire().
+ * @param buffer_body If true, the body is collected in memory and reported in the
+ *                    response; otherwise the caller's CURLOPT_WRITEFUNCTION is used.
+ * @param cb Called exactly once on the LVGL thread when the request finishes or is cancelled.
+ * @param user_data Passed through to the callback.
+ * @return A request handle, or NULL on failure (the handle is released and the callback is not called).
+ */
+http_request_t *http_async_submit(CURL *handle, bool buffer_body, http_async_cb_t cb, void *user_data);
+
+/**
+ * @brief Aborts a request that has not completed yet.
+ *
+ * The callback runs synchronously with response->cancelled set, so it can free
+ * its user data. The request handle must not be used afterwards, and must not be
+ * cancelled from within its own callback.
+ *
+ * @param request The request to cancel. NULL is ignored.
+ */
+void http_async_cancel(http_request_t *request);
+
+/**
+ * @brief Returns the number of requests currently in flight.
+ */
+int http_async_active_count(void);
+
+#endif // HTTP_ASYNC_H
@@ -0,0 +1,93 @@
+#include "http_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define USER_AGENT "lvgl-badgehub-client/1.0"
+
+// --- STATIC STATE VARIABLES ---
+static CURLSH *s_share = NULL;
+static CURL **s_idle_handles = NULL;
+static int s_idle_count = 0;
+static int s_pool_size = 0;
+static bool s_initialized = false;
+
+static void apply_defaults(CURL *handle) {
+    curl_easy_setopt(handle, CURLOPT_SHARE, s_share);
+    curl_easy_setopt(handle, CURLOPT_USERAGENT, USER_AGENT);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_DNS_CACHE_TIMEOUT, 300L);
+}
+
+bool http_pool_init(int pool_size) {
+    if (s_initialized) return true;
+    if (pool_size < 1) pool_size = 1;
+
+    if (curl_global_init(CURL_GLOBAL_ALL) != CURLE_OK) {
+        fprintf(stderr, "curl_global_init() failed\n");
+        return false;
+    }
+
+    s_share = curl_share_init();
+    if (s_share) {
+        curl_share_setopt(s_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(s_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        curl_share_setopt(s_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    } else {
+        fprintf(stderr, "curl_share_init() failed, continuing without shared caches\n");
+    }
+
+    s_idle_handles = calloc(pool_size, sizeof(CURL *));
+    if (!s_idle_handles) {
+        if (s_share) curl_share_cleanup(s_share);
+        s_share = NULL;
+        curl_global_cleanup();
+        return false;
+    }
+    s_pool_size = pool_size;
+    s_idle_count = 0;
+    s_initialized = true;
+    return true;
+}
+
+void http_pool_cleanup(void) {
+    if (!s_initialized) return;
+    for (int i = 0; i < s_idle_count; i++) {
+        curl_easy_cleanup(s_idle_handles[i]);
+    }
+    free(s_idle_handles);
+    s_idle_handles = NULL;
+    s_idle_count = 0;
+    s_pool_size = 0;
+    if (s_share) {
+        curl_share_cleanup(s_share);
+        s_share = NULL;
+    }
+    curl_global_cleanup();
+    s_initialized = false;
+}
+
+CURL *http_pool_acquire(void) {
+    if (!s_initialized && !http_pool_init(HTTP_POOL_DEFAULT_SIZE)) return NULL;
+
+    CURL *handle = NULL;
+    if (s_idle_count > 0) {
+        handle = s_idle_handles[--s_idle_count];
+    } else {
+        handle = curl_easy_init();
+        if (!handle) return NULL;
+    }
+    apply_defaults(handle);
+    return handle;
+}
+
+void http_pool_release(CURL *handle) {
+    if (!handle) return;
+    if (!s_initialized || s_idle_count >= s_pool_size) {
+        curl_easy_cleanup(handle);
+        return;
+    }
+    // curl_easy_reset() keeps live connections, the DNS cache and TLS sessions.
+    curl_easy_reset(handle);
+    s_idle_handles[s_idle_count++] = handle;
+}
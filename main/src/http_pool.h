@@ -0,0 +1,49 @@
+#ifndef HTTP_POOL_H
+#define HTTP_POOL_H
+
+#include <stdbool.h>
+#include <curl/curl.h>
+
+// Number of idle easy handles kept around for reuse.
+#define HTTP_POOL_DEFAULT_SIZE 8
+
+/**
+ * @brief Initializes libcurl once for the whole process.
+ *
+ * Sets up curl_global_init(), a CURLSH share for the DNS cache, TLS session
+ * cache and connection cache, and a pool of reusable easy handles. All handles
+ * handed out by http_pool_acquire() are attached to the share, so consecutive
+ * requests to the same host reuse warm keep-alive connections instead of
+ * doing a fresh TCP + TLS handshake.
+ *
+ * The pool is not thread safe; it must only be used from the LVGL thread.
+ *
+ * @param pool_size Maximum number of idle handles kept for reuse.
+ * @return true on success, false if libcurl could not be initialized.
+ */
+bool http_pool_init(int pool_size);
+
+/**
+ * @brief Destroys all pooled handles and the share, then calls curl_global_cleanup().
+ */
+void http_pool_cleanup(void);
+
+/**
+ * @brief Takes an easy handle from the pool, creating one if the pool is empty.
+ *
+ * The returned handle has the client defaults applied (share, user agent,
+ * keep-alive) and no URL set.
+ *
+ * @return An easy handle, or NULL on failure. Return it with http_pool_release().
+ */
+CURL *http_pool_acquire(void);
+
+/**
+ * @brief Returns a handle to the pool. Its options are reset, but the connection
+ * it used stays alive in the shared connection cache.
+ *
+ * @param handle A handle obtained from http_pool_acquire(). NULL is ignored.
+ */
+void http_pool_release(CURL *handle);
+
+#endif // HTTP_POOL_H
@@ -0,0 +1,240 @@
+#include "icon_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if LV_COLOR_DEPTH == 16
+#define ICON_CACHE_COLOR_FORMAT LV_COLOR_FORMAT_RGB565A8
+#else
+#define ICON_CACHE_COLOR_FORMAT LV_COLOR_FORMAT_ARGB8888
+#endif
+
+typedef struct icon_entry {
+    char *url;
+    uint32_t url_hash;
+    lv_draw_buf_t *buf;
+    size_t size;
+    int ref_count;
+    bool stale; // Invalidated while pinned; freed once released, never found again
+    struct icon_entry *prev; // Towards the most recently used end
+    struct icon_entry *next; // Towards the least recently used end
+} icon_entry_t;
+
+// --- STATIC STATE VARIABLES ---
+static icon_entry_t *s_mru = NULL; // Most recently used
+static icon_entry_t *s_lru = NULL; // Least recently used
+static size_t s_used_bytes = 0;
+static size_t s_budget = ICON_CACHE_DEFAULT_BUDGET;
+
+// --- IMPLEMENTATIONS ---
+
+static uint32_t hash_url(const char *url) {
+    uint32_t hash = 2166136261u; // FNV-1a
+    for (const unsigned char *p = (const unsigned char *)url; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static void unlink_entry(icon_entry_t *entry) {
+    if (entry->prev) entry->prev->next = entry->next;
+    else s_mru = entry->next;
+    if (entry->next) entry->next->prev = entry->prev;
+    else s_lru = entry->prev;
+    entry->prev = entry->next = NULL;
+}
+
+static void push_mru(icon_entry_t *entry) {
+    entry->prev = NULL;
+    entry->next = s_mru;
+    if (s_mru) s_mru->prev = entry;
+    s_mru = entry;
+    if (!s_lru) s_lru = entry;
+}
+
+static void destroy_entry(icon_entry_t *entry) {
+    s_used_bytes -= entry->size;
+    lv_image_cache_drop(entry->buf);
+    lv_draw_buf_destroy(entry->buf);
+    free(entry->url);
+    free(entry);
+}
+
+// Evicts unpinned icons, least recently used first, until the cache fits its budget.
+static void evict_to_budget(void) {
+    icon_entry_t *entry = s_lru;
+    while (entry && s_used_bytes > s_budget) {
+        icon_entry_t *prev = entry->prev;
+        if (entry->ref_count == 0) {
+            unlink_entry(entry);
+            destroy_entry(entry);
+        }
+        entry = prev;
+    }
+}
+
+static icon_entry_t *find_entry(const char *url) {
+    uint32_t hash = hash_url(url);
+    for (icon_entry_t *entry = s_mru; entry; entry = entry->next) {
+        if (!entry->stale && entry->url_hash == hash && strcmp(entry->url, url) == 0) return entry;
+    }
+    return NULL;
+}
+
+static icon_entry_t *find_entry_by_buf(const lv_draw_buf_t *buf) {
+    for (icon_entry_t *entry = s_mru; entry; entry = entry->next) {
+        if (entry->buf == buf) return entry;
+    }
+    return NULL;
+}
+
+// Copies a decoded 32 bpp image into a new buffer in the cache's color format.
+static lv_draw_buf_t *convert_to_native(const lv_draw_buf_t *src) {
+    uint32_t w = src->header.w;
+    uint32_t h = src->header.h;
+    lv_color_format_t src_cf = src->header.cf;
+    if (src_cf == ICON_CACHE_COLOR_FORMAT) {
+        return lv_draw_buf_dup(src);
+    }
+    if (src_cf != LV_COLOR_FORMAT_ARGB8888 && src_cf != LV_COLOR_FORMAT_XRGB8888) {
+        // Not a format we convert; keep the decoder's output as is.
+        return lv_draw_buf_dup(src);
+    }
+
+    lv_draw_buf_t *dst = lv_draw_buf_create(w, h, ICON_CACHE_COLOR_FORMAT, LV_STRIDE_AUTO);
+    if (!dst) return NULL;
+
+    uint32_t dst_stride = dst->header.stride;
+    for (uint32_t y = 0; y < h; y++) {
+        const uint8_t *src_row = src->data + y * src->header.stride;
+#if LV_COLOR_DEPTH == 16
+        uint16_t *color_row = (uint16_t *)(dst->data + y * dst_stride);
+        uint8_t *alpha_row = dst->data + h * dst_stride + y * (dst_stride / 2);
+        for (uint32_t x = 0; x < w; x++) {
+            const uint8_t *px = src_row + x * 4; // B, G, R, A
+            color_row[x] = (uint16_t)(((px[2] & 0xF8) << 8) | ((px[1] & 0xFC) << 3) | (px[0] >> 3));
+            alpha_row[x] = src_cf == LV_COLOR_FORMAT_XRGB8888 ? 0xFF : px[3];
+        }
+#else
+        uint8_t *dst_row = dst->data + y * dst_stride;
+        memcpy(dst_row, src_row, w * 4);
+        for (uint32_t x = 0; x < w; x++) {
+            dst_row[x * 4 + 3] = 0xFF; // XRGB8888 -> opaque ARGB8888
+        }
+#endif
+    }
+    return dst;
+}
+
+// Runs the registered image decoders once and returns an owned native buffer.
+static lv_draw_buf_t *decode_icon(const uint8_t *data, size_t data_size) {
+    lv_image_dsc_t src_dsc;
+    memset(&src_dsc, 0, sizeof(src_dsc));
+    src_dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    src_dsc.header.cf = LV_COLOR_FORMAT_RAW;
+    src_dsc.data = data;
+    src_dsc.data_size = data_size;
+
+    lv_image_decoder_args_t args;
+    memset(&args, 0, sizeof(args));
+    args.no_cache = true;
+
+    lv_image_decoder_dsc_t decoder_dsc;
+    if (lv_image_decoder_open(&decoder_dsc, &src_dsc, &args) != LV_RESULT_OK) {
+        return NULL;
+    }
+    lv_draw_buf_t *native = NULL;
+    if (decoder_dsc.decoded) {
+        native = convert_to_native(decoder_dsc.decoded);
+    }
+    lv_image_decoder_close(&decoder_dsc);
+    return native;
+}
+
+void icon_cache_init(size_t budget_bytes) {
+    s_budget = budget_bytes;
+    evict_to_budget();
+}
+
+void icon_cache_deinit(void) {
+    while (s_mru) {
+        icon_entry_t *entry = s_mru;
+        unlink_entry(entry);
+        destroy_entry(entry);
+    }
+}
+
+void icon_cache_set_budget(size_t budget_bytes) {
+    s_budget = budget_bytes;
+    evict_to_budget();
+}
+
+const lv_draw_buf_t *icon_cache_acquire(const char *icon_url) {
+    if (!icon_url) return NULL;
+    icon_entry_t *entry = find_entry(icon_url);
+    if (!entry) return NULL;
+    unlink_entry(entry);
+    push_mru(entry);
+    entry->ref_count++;
+    return entry->buf;
+}
+
+const lv_draw_buf_t *icon_cache_insert(const char *icon_url, const uint8_t *data, size_t data_size) {
+    if (!icon_url || !data || data_size == 0) return NULL;
+
+    // Another request for the same URL may have finished first.
+    const lv_draw_buf_t *existing = icon_cache_acquire(icon_url);
+    if (existing) return existing;
+
+    lv_draw_buf_t *buf = decode_icon(data, data_size);
+    if (!buf) {
+        fprintf(stderr, "Failed to decode icon %s\n", icon_url);
+        return NULL;
+    }
+    icon_entry_t *entry = calloc(1, sizeof(icon_entry_t));
+    if (entry) entry->url = strdup(icon_url);
+    if (!entry || !entry->url) {
+        free(entry);
+        lv_draw_buf_destroy(buf);
+        return NULL;
+    }
+    entry->url_hash = hash_url(icon_url);
+    entry->buf = buf;
+    entry->size = buf->data_size;
+    entry->ref_count = 1;
+    push_mru(entry);
+    s_used_bytes += entry->size;
+    evict_to_budget();
+    return buf;
+}
+
+void icon_cache_release(const lv_draw_buf_t *buf) {
+    if (!buf) return;
+    icon_entry_t *entry = find_entry_by_buf(buf);
+    if (!entry || entry->ref_count == 0) return;
+    entry->ref_count--;
+    if (entry->ref_count == 0 && entry->stale) {
+        unlink_entry(entry);
+        destroy_entry(entry);
+    } else if (entry->ref_count == 0) {
+        evict_to_budget();
+    }
+}
+
+void icon_cache_invalidate(const char *icon_url) {
+    if (!icon_url) return;
+    icon_entry_t *entry = find_entry(icon_url);
+    if (!entry) return;
+    if (entry->ref_count > 0) {
+        // Images still show the buffer; it goes when the last of them lets go.
+        entry->stale = true;
+        return;
+    }
+    unlink_entry(entry);
+    destroy_entry(entry);
+}
+
+size_t icon_cache_used_bytes(void) {
+    return s_used_bytes;
+}
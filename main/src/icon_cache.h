@@ -0,0 +1,74 @@
+#ifndef ICON_CACHE_H
+#define ICON_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lvgl/lvgl.h"
+
+// Default byte budget for decoded icons: 16 icons of 64x64 ARGB8888. The buffers
+// are allocated from the LVGL heap, so keep this well below LV_MEM_SIZE.
+#define ICON_CACHE_DEFAULT_BUDGET (256 * 1024)
+
+/**
+ * @brief Initializes the decoded icon cache.
+ *
+ * Icons are decoded once into a draw buffer in the display's native format
+ * (ARGB8888 for LV_COLOR_DEPTH 32, RGB565 with an alpha plane for 16) and
+ * kept, keyed by icon URL, until the byte budget forces LRU eviction. Images
+ * that show a cached buffer are drawn without running the PNG decoder again.
+ *
+ * @param budget_bytes Maximum number of bytes of decoded pixel data to keep.
+ */
+void icon_cache_init(size_t budget_bytes);
+
+/**
+ * @brief Frees every cached icon. Icons still in use are freed as well, so only
+ * call this once no image shows a cached buffer anymore.
+ */
+void icon_cache_deinit(void);
+
+/**
+ * @brief Changes the byte budget, evicting unused icons if needed.
+ */
+void icon_cache_set_budget(size_t budget_bytes);
+
+/**
+ * @brief Looks up a decoded icon and pins it so it cannot be evicted.
+ *
+ * @param icon_url The URL the icon was downloaded from.
+ * @return The decoded buffer (usable as an lv_image source), or NULL on a miss.
+ *         Release it with icon_cache_release().
+ */
+const lv_draw_buf_t *icon_cache_acquire(const char *icon_url);
+
+/**
+ * @brief Decodes an encoded icon (e.g. PNG) and stores it in the cache, pinned.
+ *
+ * @param icon_url The URL the icon was downloaded from.
+ * @param data The encoded image bytes. Not retained.
+ * @param data_size The number of bytes in data.
+ * @return The decoded buffer, or NULL if decoding failed. Release it with icon_cache_release().
+ */
+const lv_draw_buf_t *icon_cache_insert(const char *icon_url, const uint8_t *data, size_t data_size);
+
+/**
+ * @brief Unpins a buffer returned by icon_cache_acquire() or icon_cache_insert().
+ */
+void icon_cache_release(const lv_draw_buf_t *buf);
+
+/**
+ * @brief Drops the decoded icon for a URL, e.g. because a newer one was downloaded,
+ * so the next icon_cache_acquire() misses and the icon is decoded again.
+ *
+ * A pinned buffer stays valid for the images that show it and is freed when the
+ * last of them releases it.
+ */
+void icon_cache_invalidate(const char *icon_url);
+
+/**
+ * @brief Returns the number of bytes of decoded pixel data currently cached.
+ */
+size_t icon_cache_used_bytes(void);
+
+#endif // ICON_CACHE_H
@@ -0,0 +1,197 @@
+#include "icon_disk_cache.h"
+#include "utils.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+
+// An icon on disk, as seen when trimming the cache.
+typedef struct {
+    char name[32]; // <hash>, without suffix
+    int64_t used_ns; // Modification time, refreshed on every hit
+    off_t size;
+} disk_entry_t;
+
+// Contents of a file being stored, for put_bytes().
+typedef struct {
+    const void *data;
+    size_t size;
+} disk_bytes_t;
+
+// --- STATIC STATE VARIABLES ---
+// Bytes of .img files in the cache, -1 until counted by the first store.
+static int64_t s_disk_bytes = -1;
+
+// --- IMPLEMENTATIONS ---
+
+// Builds "<dir>/<hash><suffix>" for an icon URL.
+static void build_path(char *path, size_t path_size, const char *icon_url, const char *suffix) {
+    uint64_t hash = 14695981039346656037ull; // FNV-1a, 64 bit
+    for (const unsigned char *p = (const unsigned char *)icon_url; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ull;
+    }
+    snprintf(path, path_size, "%s/%016llx%s", ICON_DISK_CACHE_DIR, (unsigned long long)hash, suffix);
+}
+
+static void read_line(FILE *fp, char *buf, size_t buf_size) {
+    buf[0] = '\0';
+    if (!fgets(buf, (int)buf_size, fp)) return;
+    buf[strcspn(buf, "\r\n")] = '\0';
+}
+
+static bool put_bytes(FILE *fp, void *context) {
+    const disk_bytes_t *bytes = context;
+    return fwrite(bytes->data, 1, bytes->size, fp) == bytes->size;
+}
+
+uint8_t *icon_disk_cache_load(const char *icon_url, size_t *data_size, icon_validators_t *validators) {
+    if (!icon_url || !data_size) return NULL;
+    char meta_path[512];
+    char img_path[512];
+    build_path(meta_path, sizeof(meta_path), icon_url, ".meta");
+    build_path(img_path, sizeof(img_path), icon_url, ".img");
+
+    // The meta file holds the full URL, which guards against hash collisions.
+    FILE *meta = fopen(meta_path, "r");
+    if (!meta) return NULL;
+    char stored_url[1024];
+    icon_validators_t stored;
+    read_line(meta, stored_url, sizeof(stored_url));
+    read_line(meta, stored.etag, sizeof(stored.etag));
+    read_line(meta, stored.last_modified, sizeof(stored.last_modified));
+    fclose(meta);
+    if (strcmp(stored_url, icon_url) != 0) return NULL;
+
+    FILE *fp = fopen(img_path, "rb");
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    long len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    uint8_t *data = len > 0 ? malloc(len) : NULL;
+    if (data && fread(data, 1, len, fp) != (size_t)len) {
+        free(data);
+        data = NULL;
+    }
+    fclose(fp);
+    if (!data) return NULL;
+
+    utimensat(AT_FDCWD, img_path, NULL, 0); // Recently used, so trimmed last
+    *data_size = (size_t)len;
+    if (validators) *validators = stored;
+    return data;
+}
+
+static int compare_used(const void *a, const void *b) {
+    int64_t x = ((const disk_entry_t *)a)->used_ns, y = ((const disk_entry_t *)b)->used_ns;
+    return (x > y) - (x < y);
+}
+
+// Lists the icons in the cache and counts their bytes; entries may be NULL to only count.
+static int64_t scan_entries(disk_entry_t **entries, int *count) {
+    if (entries) *entries = NULL;
+    if (count) *count = 0;
+    DIR *dir = opendir(ICON_DISK_CACHE_DIR);
+    if (!dir) return 0;
+    int64_t total = 0;
+    int capacity = 0;
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        size_t len = strlen(ent->d_name);
+        if (len < 5 || len - 4 >= sizeof(((disk_entry_t *)0)->name) || strcmp(ent->d_name + len - 4, ".img") != 0) continue;
+        struct stat st;
+        if (fstatat(dirfd(dir), ent->d_name, &st, 0) != 0 || !S_ISREG(st.st_mode)) continue;
+        total += st.st_size;
+        if (!entries) continue;
+        if (*count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            disk_entry_t *grown = realloc(*entries, capacity * sizeof(disk_entry_t));
+            if (!grown) break;
+            *entries = grown;
+        }
+        disk_entry_t *entry = &(*entries)[(*count)++];
+        memcpy(entry->name, ent->d_name, len - 4);
+        entry->name[len - 4] = '\0';
+        entry->used_ns = stat_mtime_ns(&st);
+        entry->size = st.st_size;
+    }
+    closedir(dir);
+    return total;
+}
+
+// Removes the least recently used icons until three quarters of the budget are in use.
+static void trim_cache(void) {
+    disk_entry_t *entries = NULL;
+    int count = 0;
+    s_disk_bytes = scan_entries(&entries, &count);
+    qsort(entries, count, sizeof(disk_entry_t), compare_used);
+    for (int i = 0; i < count && s_disk_bytes > ICON_DISK_CACHE_MAX_BYTES / 4 * 3; i++) {
+        char path[512];
+        // The meta file goes first: an image without its meta file is a miss anyway.
+        snprintf(path, sizeof(path), "%s/%s.meta", ICON_DISK_CACHE_DIR, entries[i].name);
+        remove(path);
+        snprintf(path, sizeof(path), "%s/%s.img", ICON_DISK_CACHE_DIR, entries[i].name);
+        if (remove(path) == 0) s_disk_bytes -= entries[i].size;
+    }
+    free(entries);
+}
+
+bool icon_disk_cache_store(const char *icon_url, const uint8_t *data, size_t data_size, const icon_validators_t *validators) {
+    if (!icon_url || !data || data_size == 0) return false;
+    char meta_path[512];
+    char img_path[512];
+    build_path(meta_path, sizeof(meta_path), icon_url, ".meta");
+    build_path(img_path, sizeof(img_path), icon_url, ".img");
+    ensure_dir_exists(img_path);
+
+    char meta[1024 + sizeof(icon_validators_t) + 4];
+    int meta_len = snprintf(meta, sizeof(meta), "%s\n%s\n%s\n", icon_url,
+                            validators ? validators->etag : "",
+                            validators ? validators->last_modified : "");
+    if (meta_len < 0 || (size_t)meta_len >= sizeof(meta)) return false;
+
+    struct stat old;
+    int64_t replaced = stat(img_path, &old) == 0 ? old.st_size : 0;
+    // Image first: a meta file without its image is treated as a miss.
+    disk_bytes_t img = { data, data_size };
+    disk_bytes_t meta_bytes = { meta, (size_t)meta_len };
+    if (!write_file_atomic(img_path, put_bytes, &img)) {
+        fprintf(stderr, "Failed to write icon cache entry %s\n", img_path);
+        return false;
+    }
+    if (!write_file_atomic(meta_path, put_bytes, &meta_bytes)) {
+        fprintf(stderr, "Failed to write icon cache entry %s\n", meta_path);
+        return false;
+    }
+
+    if (s_disk_bytes < 0) {
+        s_disk_bytes = scan_entries(NULL, NULL);
+    } else {
+        s_disk_bytes += (int64_t)data_size - replaced;
+    }
+    if (s_disk_bytes > ICON_DISK_CACHE_MAX_BYTES) trim_cache();
+    return true;
+}
+
+static void copy_header_value(char *dest, size_t dest_size, const char *value, size_t length) {
+    while (length > 0 && (*value == ' ' || *value == '\t')) { value++; length--; }
+    while (length > 0 && (value[length - 1] == '\r' || value[length - 1] == '\n' || value[length - 1] == ' ')) length--;
+    if (length >= dest_size) return; // Too long to store; skip rather than truncate a validator
+    memcpy(dest, value, length);
+    dest[length] = '\0';
+}
+
+void icon_validators_parse_header(icon_validators_t *validators, const char *line, size_t length) {
+    static const char etag[] = "etag:";
+    static const char last_modified[] = "last-modified:";
+    if (length > sizeof(etag) - 1 && strncasecmp(line, etag, sizeof(etag) - 1) == 0) {
+        copy_header_value(validators->etag, sizeof(validators->etag),
+                          line + sizeof(etag) - 1, length - (sizeof(etag) - 1));
+    } else if (length > sizeof(last_modified) - 1 && strncasecmp(line, last_modified, sizeof(last_modified) - 1) == 0) {
+        copy_header_value(validators->last_modified, sizeof(validators->last_modified),
+                          line + sizeof(last_modified) - 1, length - (sizeof(last_modified) - 1));
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef ICON_DISK_CACHE_H
+#define ICON_DISK_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ICON_DISK_CACHE_DIR "cache/icons"
+// Bytes of icon images kept on disk. Beyond this the least recently used icons are
+// removed until a quarter of the budget is free again, so trims stay rare.
+#define ICON_DISK_CACHE_MAX_BYTES (4 * 1024 * 1024)
+
+// HTTP validators stored next to a cached icon, used for conditional revalidation.
+typedef struct {
+    char etag[128];
+    char last_modified[64];
+} icon_validators_t;
+
+/**
+ * @brief Reads a cached icon from disk.
+ *
+ * Entries live in ICON_DISK_CACHE_DIR, named after a hash of the icon URL:
+ * <hash>.img holds the encoded icon bytes and <hash>.meta the URL and validators.
+ * A hit marks the entry as recently used.
+ *
+ * @param icon_url The URL of the icon.
+ * @param data_size Populated with the number of bytes returned.
+ * @param validators If not NULL, populated with the stored ETag / Last-Modified.
+ * @return A malloc'd buffer with the icon bytes, or NULL on a miss. The caller must free it.
+ */
+uint8_t *icon_disk_cache_load(const char *icon_url, size_t *data_size, icon_validators_t *validators);
+
+/**
+ * @brief Stores (or replaces) an icon and its validators on disk.
+ *
+ * The files are written to temporary names and renamed into place, so a
+ * crash never leaves a truncated entry behind. If the cache then holds more
+ * than ICON_DISK_CACHE_MAX_BYTES, the least recently used entries are removed.
+ *
+ * @return true on success.
+ */
+bool icon_disk_cache_store(const char *icon_url, const uint8_t *data, size_t data_size, const icon_validators_t *validators);
+
+/**
+ * @brief Parses an HTTP response header line and records ETag / Last-Modified values.
+ *
+ * Meant to be called from a CURLOPT_HEADERFUNCTION callback.
+ */
+void icon_validators_parse_header(icon_validators_t *validators, const char *line, size_t length);
+
+#endif // ICON_DISK_CACHE_H
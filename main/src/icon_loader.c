@@ -0,0 +1,210 @@
+#include "icon_loader.h"
+#include "icon_cache.h"
+#include "icon_disk_cache.h"
+#include "http_async.h"
+#include "http_pool.h"
+#include "response_buffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct icon_job {
+    char *url;
+    icon_loader_cb_t cb;
+    void *owner;
+    http_request_t *request; // NULL while queued
+    response_buffer_t *data;          // Pooled body buffer, NULL while queued
+    bool revalidate;                  // Conditional refresh of an icon served from disk
+    icon_validators_t sent;           // Validators sent with a revalidation
+    icon_validators_t received;       // Validators from the response headers
+    struct curl_slist *headers;
+    struct icon_job *next;
+} icon_job_t;
+
+// --- STATIC STATE VARIABLES ---
+static icon_job_t *s_queue_head = NULL;
+static icon_job_t *s_queue_tail = NULL;
+static icon_job_t *s_active[ICON_LOADER_MAX_CONCURRENCY];
+static int s_active_count = 0;
+
+// --- FORWARD DECLARATIONS ---
+static void pump_queue(void);
+static void icon_done_cb(const http_response_t *response, void *user_data);
+
+// --- IMPLEMENTATIONS ---
+
+static void free_job(icon_job_t *job) {
+    free(job->url);
+    response_buffer_release(job->data);
+    curl_slist_free_all(job->headers);
+    free(job);
+}
+
+static size_t header_cb(char *buffer, size_t size, size_t nitems, void *userdata) {
+    icon_job_t *job = userdata;
+    icon_validators_parse_header(&job->received, buffer, size * nitems);
+    return size * nitems;
+}
+
+static struct curl_slist *build_conditional_headers(const icon_validators_t *validators) {
+    char header[256];
+    struct curl_slist *headers = NULL;
+    if (validators->etag[0]) {
+        snprintf(header, sizeof(header), "If-None-Match: %s", validators->etag);
+        headers = curl_slist_append(headers, header);
+    }
+    if (validators->last_modified[0]) {
+        snprintf(header, sizeof(header), "If-Modified-Since: %s", validators->last_modified);
+        headers = curl_slist_append(headers, header);
+    }
+    return headers;
+}
+
+static void remove_active(icon_job_t *job) {
+    for (int i = 0; i < s_active_count; i++) {
+        if (s_active[i] == job) {
+            s_active[i] = s_active[--s_active_count];
+            return;
+        }
+    }
+}
+
+static bool start_job(icon_job_t *job) {
+    job->data = response_buffer_acquire(ICON_LOADER_MAX_ICON_SIZE);
+    if (!job->data) return false;
+    CURL *handle = http_pool_acquire();
+    if (!handle) return false;
+    curl_easy_setopt(handle, CURLOPT_URL, job->url);
+    response_buffer_attach(job->data, handle);
+    // Prefer one multiplexed HTTP/2 connection over opening a connection per icon.
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, header_cb);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, job);
+    if (job->revalidate) {
+        job->headers = build_conditional_headers(&job->sent);
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, job->headers);
+    }
+
+    s_active[s_active_count++] = job;
+    job->request = http_async_submit(handle, false, icon_done_cb, job);
+    if (!job->request) {
+        remove_active(job);
+        return false;
+    }
+    return true;
+}
+
+static void pump_queue(void) {
+    while (s_active_count < ICON_LOADER_MAX_CONCURRENCY && s_queue_head) {
+        icon_job_t *job = s_queue_head;
+        s_queue_head = job->next;
+        if (!s_queue_head) s_queue_tail = NULL;
+        job->next = NULL;
+        if (!start_job(job)) {
+            free_job(job);
+        }
+    }
+}
+
+static void icon_done_cb(const http_response_t *response, void *user_data) {
+    icon_job_t *job = user_data;
+    remove_active(job);
+    if (!response->cancelled) {
+        // A 304 on revalidation means the copy on disk is still current.
+        if (response->result == CURLE_OK && response->status == 200 && job->data->size > 0) {
+            const uint8_t *data = (const uint8_t *)job->data->data;
+            icon_disk_cache_store(job->url, data, job->data->size, &job->received);
+            if (job->revalidate) {
+                // The icon changed; the decoded copy in memory is the old one.
+                icon_cache_invalidate(job->url);
+            } else {
+                job->cb(job->url, data, job->data->size, job->owner);
+            }
+        }
+        free_job(job);
+        pump_queue();
+    } else {
+        free_job(job);
+    }
+}
+
+static icon_job_t *enqueue_job(const char *icon_url, icon_loader_cb_t cb, void *owner) {
+    icon_job_t *job = calloc(1, sizeof(icon_job_t));
+    if (!job) return NULL;
+    job->url = strdup(icon_url);
+    if (!job->url) {
+        free(job);
+        return NULL;
+    }
+    job->cb = cb;
+    job->owner = owner;
+
+    if (s_queue_tail) s_queue_tail->next = job;
+    else s_queue_head = job;
+    s_queue_tail = job;
+    return job;
+}
+
+bool icon_loader_request(const char *icon_url, icon_loader_cb_t cb, void *owner) {
+    if (!icon_url || strlen(icon_url) == 0 || !cb) return false;
+
+    // Serve from disk without touching the network, then revalidate in the background.
+    size_t cached_size = 0;
+    icon_validators_t validators;
+    uint8_t *cached = icon_disk_cache_load(icon_url, &cached_size, &validators);
+    if (cached) {
+        cb(icon_url, cached, cached_size, owner);
+        free(cached);
+        if (validators.etag[0] || validators.last_modified[0]) {
+            // Not tied to the owner: the refresh is worth finishing even if the card goes away.
+            icon_job_t *job = enqueue_job(icon_url, NULL, NULL);
+            if (job) {
+                job->revalidate = true;
+                job->sent = validators;
+            }
+            pump_queue();
+        }
+        return true;
+    }
+
+    if (!enqueue_job(icon_url, cb, owner)) return false;
+    pump_queue();
+    return true;
+}
+
+void icon_loader_cancel(void *owner) {
+    icon_job_t **link = &s_queue_head;
+    s_queue_tail = NULL;
+    while (*link) {
+        icon_job_t *job = *link;
+        if (job->owner == owner) {
+            *link = job->next;
+            free_job(job);
+        } else {
+            s_queue_tail = job;
+            link = &job->next;
+        }
+    }
+
+    bool cancelled_any = false;
+    for (int i = s_active_count - 1; i >= 0; i--) {
+        if (i < s_active_count && s_active[i]->owner == owner) {
+            http_async_cancel(s_active[i]->request);
+            cancelled_any = true;
+        }
+    }
+    if (cancelled_any) pump_queue();
+}
+
+void icon_loader_cancel_all(void) {
+    while (s_queue_head) {
+        icon_job_t *job = s_queue_head;
+        s_queue_head = job->next;
+        free_job(job);
+    }
+    s_queue_tail = NULL;
+    while (s_active_count > 0) {
+        http_async_cancel(s_active[s_active_count - 1]->request);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef ICON_LOADER_H
+#define ICON_LOADER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Maximum number of icon downloads in flight at the same time.
+#define ICON_LOADER_MAX_CONCURRENCY 6
+// Larger downloads are aborted; icons are 64x64 PNGs of a few KiB.
+#define ICON_LOADER_MAX_ICON_SIZE (512 * 1024)
+
+/**
+ * @brief Called on the LVGL thread when an icon download succeeded.
+ *
+ * @param icon_url The URL that was requested.
+ * @param data The raw icon bytes, only valid for the duration of the callback.
+ * @param size The number of bytes in data.
+ * @param owner The owner passed to icon_loader_request().
+ */
+typedef void (*icon_loader_cb_t)(const char *icon_url, const uint8_t *data, size_t size, void *owner);
+
+/**
+ * @brief Schedules an icon download.
+ *
+ * Icons found in the on-disk cache are delivered immediately, before this
+ * function returns, and then revalidated in the background with
+ * If-None-Match / If-Modified-Since; a changed icon replaces the copy on disk,
+ * its decoded copy is dropped from the icon cache, and it is shown the next
+ * time it is loaded. Missing icons are downloaded and
+ * stored on disk.
+ *
+ * Up to ICON_LOADER_MAX_CONCURRENCY downloads run concurrently over the shared
+ * connection cache, multiplexed on a single HTTP/2 connection where the server
+ * supports it; the rest wait in a FIFO queue. Failed downloads are dropped
+ * silently so the placeholder stays visible.
+ *
+ * @param icon_url The URL of the icon.
+ * @param cb Completion callback.
+ * @param owner Identifies the requester (e.g. the card object) for cancellation.
+ * @return true if the request was queued.
+ */
+bool icon_loader_request(const char *icon_url, icon_loader_cb_t cb, void *owner);
+
+/**
+ * @brief Cancels all queued and in-flight downloads for an owner.
+ */
+void icon_loader_cancel(void *owner);
+
+/**
+ * @brief Cancels every queued and in-flight download, e.g. when the page changes.
+ */
+void icon_loader_cancel_all(void);
+
+#endif // ICON_LOADER_H
@@ -0,0 +1,829 @@
+#include "install_manager.h"
+#include "arena.h"
+#include "blob_store.h"
+#include "file_download.h"
+#include "http_async.h"
+#include "http_pool.h"
+#include "install_manifest.h"
+#include "os_client.h"
+#include "sha256.h"
+#include "utils.h"
+#include "lvgl/lvgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// --- CONSTANTS ---
+// Installs are assembled in STAGING_DIR/<slug> and swapped into INSTALLATION_DIR/<slug>
+// with a rename, the old tree being parked in PREVIOUS_DIR/<slug> until the swap is
+// done. Both live inside INSTALLATION_DIR so the renames never cross a filesystem.
+#define STAGING_DIR INSTALLATION_DIR "/.staging"
+#define PREVIOUS_DIR INSTALLATION_DIR "/.previous"
+// How often the LVGL thread picks up the results of the disk thread while it is busy.
+#define DISK_POLL_PERIOD_MS 5
+
+typedef struct install_job install_job_t;
+
+// One file of an install and, while it downloads, its transfer.
+typedef struct {
+    const project_file_t *info;
+    install_job_t *job;
+    http_request_t *request; // NULL unless in flight
+    file_download_t download;
+    int attempts;
+    bool restarted;                  // Whether a stale resumed prefix was already thrown away once
+    char sha256[SHA256_HEX_SIZE];    // Digest of the installed file, set once it is in place
+    char local_path[512];            // Where the file is staged
+} install_transfer_t;
+
+// A queued or running install. The job, its copy of the file list and the
+// transfers all live in one arena, freed when the install ends.
+struct install_job {
+    char *slug;
+    char live_dir[512];
+    char staging_dir[512];
+    char previous_dir[512];
+    int revision;
+    install_status_t status;
+    install_mode_t mode;
+    install_manifest_t *previous; // Manifest of the installed revision, loaded when the job starts
+    dir_cache_t *dirs;            // Directories created in the staging tree, from when the job starts
+    file_writer_stats_t io;
+    project_file_t *files;
+    install_transfer_t *transfers;
+    int file_count;
+    int next_file;        // Index of the next file to start
+    int active;           // Transfers in flight
+    int files_done;
+    uint64_t bytes_done;  // Bytes of completed files
+    int files_skipped;
+    uint64_t bytes_skipped;
+    int files_removed;
+    const char *current_file;
+    const char *failed_file;
+    const char *error;
+    int disk_tasks;       // Tasks queued on the disk thread that have not completed yet
+    bool finished;        // Ended while disk tasks were outstanding; freed by the last one
+    bool committing;      // Being published; too late to cancel
+    install_job_t *next;
+};
+
+// Work an install hands to the disk thread, so the LVGL thread never waits for
+// hashing, copying or flushing files.
+typedef enum {
+    DISK_TASK_REUSE,  // Look for a local copy of a file before downloading it
+    DISK_TASK_STORE,  // Enter a downloaded file into the blob store
+    DISK_TASK_COMMIT, // Record, flush and publish the staged files
+} disk_task_kind_t;
+
+typedef struct disk_task {
+    disk_task_kind_t kind;
+    install_job_t *job;           // NULL for DISK_TASK_STORE, which may outlive its job
+    install_transfer_t *transfer; // The file to look for
+    bool cancelled;               // The job ended before the task started
+    bool ok;
+    uint64_t size;
+    char path[512];               // The file to store, and its digest
+    char sha256[SHA256_HEX_SIZE];
+    install_manifest_t manifest;  // The files a commit published
+    bool replaced;                // Whether the commit parked an installed revision in PREVIOUS_DIR
+    struct disk_task *next;
+} disk_task_t;
+
+// --- STATIC STATE VARIABLES ---
+static install_job_t *s_jobs = NULL; // FIFO queue; only the head runs
+static install_progress_cb_t s_listener = NULL;
+static void *s_listener_data = NULL;
+static lv_timer_t *s_progress_timer = NULL;
+static uint64_t s_reported_bytes = 0; // bytes_done of the running install at its last notification
+
+// The disk thread, started on first use, runs tasks in the order they are queued.
+// LVGL is built without locking (LV_USE_OS is LV_OS_NONE), so rather than calling
+// into it, the thread leaves finished tasks in s_disk_done for a timer to collect.
+static pthread_mutex_t s_disk_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_disk_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t s_disk_thread;
+static bool s_disk_started = false;
+static bool s_disk_stop = false;
+static disk_task_t *s_disk_queue = NULL; // FIFO
+static disk_task_t *s_disk_done = NULL;  // FIFO of tasks whose results the LVGL thread has yet to handle
+static lv_timer_t *s_disk_timer = NULL;
+static int s_disk_pending = 0; // Queued tasks with a result to handle; LVGL thread only
+
+// --- FORWARD DECLARATIONS ---
+static void start_job(install_job_t *job);
+static void fill_slots(install_job_t *job);
+static void finish_job(install_job_t *job, install_status_t status);
+static void transfer_done_cb(const http_response_t *response, void *user_data);
+static void progress_timer_cb(lv_timer_t *timer);
+static void disk_timer_cb(lv_timer_t *timer);
+static bool start_transfer(install_job_t *job, install_transfer_t *transfer);
+
+// --- IMPLEMENTATIONS ---
+
+static install_job_t *find_job(const char *slug) {
+    if (!slug) return NULL;
+    for (install_job_t *job = s_jobs; job; job = job->next) {
+        if (strcmp(job->slug, slug) == 0) return job;
+    }
+    return NULL;
+}
+
+static void fill_progress(const install_job_t *job, install_progress_t *progress) {
+    progress->slug = job->slug;
+    progress->revision = job->revision;
+    progress->status = job->status;
+    progress->files_total = job->file_count;
+    progress->files_done = job->files_done;
+    progress->bytes_done = job->bytes_done;
+    for (int i = 0; i < job->file_count; i++) {
+        if (job->transfers[i].request) progress->bytes_done += job->transfers[i].download.received;
+    }
+    progress->files_skipped = job->files_skipped;
+    progress->bytes_skipped = job->bytes_skipped;
+    progress->files_removed = job->files_removed;
+    progress->current_file = job->current_file;
+    progress->failed_file = job->failed_file;
+    progress->error = job->error;
+    progress->io = job->io;
+}
+
+static void notify(install_job_t *job) {
+    install_progress_t progress;
+    fill_progress(job, &progress);
+    if (job == s_jobs) s_reported_bytes = progress.bytes_done;
+    if (s_listener) s_listener(&progress, s_listener_data);
+}
+
+static void destroy_job(install_job_t *job) {
+    install_manifest_free(job->previous);
+    dir_cache_destroy(job->dirs);
+    arena_destroy_root(job);
+}
+
+// Copies what the install needs out of the caller's details.
+static install_job_t *create_job(const project_detail_t *details, install_mode_t mode) {
+    arena_t *arena = arena_create(0);
+    if (!arena) return NULL;
+    install_job_t *job = arena_alloc_root(arena, sizeof(install_job_t));
+    if (!job) { arena_destroy(arena); return NULL; }
+    job->slug = arena_strdup(arena, details->slug);
+    snprintf(job->live_dir, sizeof(job->live_dir), "%s/%s", INSTALLATION_DIR, details->slug);
+    snprintf(job->staging_dir, sizeof(job->staging_dir), "%s/%s", STAGING_DIR, details->slug);
+    snprintf(job->previous_dir, sizeof(job->previous_dir), "%s/%s", PREVIOUS_DIR, details->slug);
+    job->revision = details->revision;
+    job->status = INSTALL_STATUS_QUEUED;
+    job->mode = mode;
+    job->file_count = details->file_count > 0 ? details->file_count : 0;
+    bool ok = job->slug != NULL;
+    if (ok && job->file_count > 0) {
+        job->files = arena_alloc(arena, job->file_count * sizeof(project_file_t));
+        job->transfers = arena_alloc(arena, job->file_count * sizeof(install_transfer_t));
+        ok = job->files && job->transfers;
+        if (ok) memset(job->transfers, 0, job->file_count * sizeof(install_transfer_t));
+        for (int i = 0; ok && i < job->file_count; i++) {
+            project_file_t *file = &job->files[i];
+            file->full_path = arena_strdup(arena, details->files[i].full_path);
+            file->sha256 = arena_strdup(arena, details->files[i].sha256);
+            file->url = arena_strdup(arena, details->files[i].url);
+            ok = file->full_path && file->sha256 && file->url;
+            job->transfers[i].info = file;
+            job->transfers[i].job = job;
+            if (ok) {
+                snprintf(job->transfers[i].local_path, sizeof(job->transfers[i].local_path), "%s/%s",
+                         job->staging_dir, file->full_path);
+            }
+        }
+    }
+    if (!ok) {
+        destroy_job(job);
+        return NULL;
+    }
+    return job;
+}
+
+// Returns whether the file at path has the expected hash, storing its digest in
+// sha256. A manifest, if given, vouches for files whose size and mtime it
+// recorded; anything else is hashed.
+static bool file_matches(const char *path, const char *expected, const install_manifest_t *manifest,
+                         const char *full_path, char sha256[SHA256_HEX_SIZE], uint64_t *size) {
+    struct stat st;
+    if (!expected[0] || stat(path, &st) != 0 || !S_ISREG(st.st_mode)) return false;
+    *size = (uint64_t)st.st_size;
+    const install_manifest_entry_t *entry = install_manifest_find(manifest, full_path);
+    if (entry && entry->size == (uint64_t)st.st_size && entry->mtime == stat_mtime_ns(&st)) {
+        if (!sha256_hex_equal(entry->sha256, expected)) return false;
+        snprintf(sha256, SHA256_HEX_SIZE, "%s", entry->sha256);
+        return true;
+    }
+    return sha256_file(path, sha256, NULL) && sha256_hex_equal(sha256, expected);
+}
+
+// Places src at dst in the staging tree, dropping any partial download of dst.
+// Runs on the disk thread, so it leaves job->dirs to the downloads.
+static bool stage_file(const char *src, const char *dst) {
+    file_download_discard(dst);
+    ensure_dir_exists(dst);
+    return link_or_copy(src, dst);
+}
+
+// Stages a file without downloading it when an up to date copy exists: one left
+// in the staging directory by an interrupted attempt, the installed one, or one
+// another app or revision brought into the blob store. Runs on the disk thread.
+static bool reuse_local_copy(install_job_t *job, install_transfer_t *transfer, uint64_t *size) {
+    const char *expected = transfer->info->sha256;
+    const char *full_path = transfer->info->full_path;
+    if (!file_download_has_partial(transfer->local_path) &&
+        file_matches(transfer->local_path, expected, NULL, NULL, transfer->sha256, size)) {
+        return true;
+    }
+    char live_path[1024];
+    snprintf(live_path, sizeof(live_path), "%s/%s", job->live_dir, full_path);
+    if (file_matches(live_path, expected, job->previous, full_path, transfer->sha256, size) &&
+        stage_file(live_path, transfer->local_path)) {
+        return true;
+    }
+    // A partial download is kept for resuming unless the store can replace it.
+    char sidecar[520];
+    ensure_dir_exists(transfer->local_path);
+    if (!blob_store_materialize(expected, transfer->local_path, size)) return false;
+    snprintf(sidecar, sizeof(sidecar), "%s%s", transfer->local_path, FILE_DOWNLOAD_PARTIAL_SUFFIX);
+    remove(sidecar);
+    snprintf(transfer->sha256, sizeof(transfer->sha256), "%s", expected);
+    return true;
+}
+
+// Manifest paths come from the server; never let one escape the project directory.
+static bool is_safe_relative_path(const char *path) {
+    if (!path[0] || path[0] == '/') return false;
+    for (const char *p = path; (p = strstr(p, "..")) != NULL; p += 2) {
+        if ((p == path || p[-1] == '/') && (p[2] == '\0' || p[2] == '/')) return false;
+    }
+    return true;
+}
+
+typedef void (*file_visitor_t)(const install_job_t *job, const install_manifest_t *manifest,
+                               const char *path, const char *full_path);
+
+// Calls visit for every regular file below root/relative, with its path relative to root.
+static void for_each_file(const install_job_t *job, const install_manifest_t *manifest, const char *root,
+                          const char *relative, file_visitor_t visit) {
+    char dir_path[1024];
+    snprintf(dir_path, sizeof(dir_path), "%s%s%s", root, relative[0] ? "/" : "", relative);
+    DIR *dir = opendir(dir_path);
+    if (!dir) return;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        char full_path[512];
+        char path[1024];
+        struct stat st;
+        snprintf(full_path, sizeof(full_path), "%s%s%s", relative, relative[0] ? "/" : "", entry->d_name);
+        snprintf(path, sizeof(path), "%s/%s", root, full_path);
+        if (lstat(path, &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            for_each_file(job, manifest, root, full_path, visit);
+        } else if (S_ISREG(st.st_mode) && strcmp(full_path, INSTALL_MANIFEST_NAME) != 0) {
+            visit(job, manifest, path, full_path);
+        }
+    }
+    closedir(dir);
+}
+
+// Drops what earlier attempts left in the staging tree that this revision does not
+// contain: partial downloads, their sidecars and files since removed from the project.
+static void prune_staged_file(const install_job_t *job, const install_manifest_t *manifest,
+                              const char *path, const char *full_path) {
+    if (!install_manifest_find(manifest, full_path)) remove(path);
+}
+
+// Links files the app created itself (listed in neither manifest) from the
+// installed tree into the staged one, so an update does not lose them.
+static void carry_over_app_file(const install_job_t *job, const install_manifest_t *manifest,
+                                const char *path, const char *full_path) {
+    if (install_manifest_find(manifest, full_path) || install_manifest_find(job->previous, full_path)) return;
+    char staged_path[1024];
+    snprintf(staged_path, sizeof(staged_path), "%s/%s", job->staging_dir, full_path);
+    if (!stage_file(path, staged_path)) fprintf(stderr, "Failed to keep %s\n", path);
+}
+
+// Makes a file, or the renames inside a directory, durable.
+static void sync_path(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return;
+    fsync(fd);
+    close(fd);
+}
+
+// Flushes the staged tree, files and directories alike. syncfs() would take one
+// call, but would also flush everything else waiting to be written to the
+// filesystem; this runs on the disk thread, so the number of calls matters less.
+static void sync_tree(const char *path) {
+    struct stat st;
+    if (lstat(path, &st) != 0) return;
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(path);
+        struct dirent *entry;
+        while (dir && (entry = readdir(dir)) != NULL) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+            char child[1024];
+            snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+            sync_tree(child);
+        }
+        if (dir) closedir(dir);
+    } else if (!S_ISREG(st.st_mode)) {
+        return;
+    }
+    sync_path(path);
+}
+
+// Swaps the staged tree into place with a single rename. The installed revision is
+// parked in PREVIOUS_DIR, restored if the swap fails (or, after a crash, by
+// install_manager_init()) and otherwise left there for the caller to discard.
+static bool publish_staging(const install_job_t *job, bool *replaced) {
+    struct stat st;
+    bool had_live = stat(job->live_dir, &st) == 0;
+    *replaced = false;
+    if (had_live) {
+        ensure_dir_exists(job->previous_dir);
+        remove_tree(job->previous_dir);
+        if (rename(job->live_dir, job->previous_dir) != 0) return false;
+    }
+    if (rename(job->staging_dir, job->live_dir) != 0) {
+        if (had_live) rename(job->previous_dir, job->live_dir);
+        return false;
+    }
+    sync_path(INSTALLATION_DIR);
+    *replaced = had_live;
+    return true;
+}
+
+// Records the staged files in a manifest, makes them durable and publishes them.
+// Runs on the disk thread. Files of the previous revision that the new one dropped
+// vanish with the old tree.
+static bool commit_install(install_job_t *job, install_manifest_t *manifest, bool *replaced) {
+    manifest->revision = job->revision;
+    manifest->entries = calloc(job->file_count > 0 ? job->file_count : 1, sizeof(install_manifest_entry_t));
+    if (!manifest->entries) return false;
+    for (int i = 0; i < job->file_count; i++) {
+        struct stat st;
+        if (stat(job->transfers[i].local_path, &st) != 0) continue;
+        install_manifest_entry_t *entry = &manifest->entries[manifest->count++];
+        entry->full_path = job->files[i].full_path;
+        snprintf(entry->sha256, sizeof(entry->sha256), "%s", job->transfers[i].sha256);
+        entry->size = (uint64_t)st.st_size;
+        entry->mtime = stat_mtime_ns(&st);
+    }
+    ensure_dir_exists(job->staging_dir);
+    mkdir(job->staging_dir, 0755); // A project without files still gets a directory
+    bool ok = install_manifest_save(job->staging_dir, manifest);
+    if (ok) {
+        for_each_file(job, manifest, job->staging_dir, "", prune_staged_file);
+        for_each_file(job, manifest, job->live_dir, "", carry_over_app_file);
+        sync_tree(job->staging_dir);
+        ok = publish_staging(job, replaced);
+    }
+    if (!ok) fprintf(stderr, "Failed to publish %s\n", job->staging_dir);
+    return ok;
+}
+
+// Finishes an install once the disk thread has published it, or failed to.
+static void commit_done(install_job_t *job, disk_task_t *task) {
+    if (!task->ok) {
+        job->error = "could not publish the installed files";
+        finish_job(job, INSTALL_STATUS_FAILED);
+        return;
+    }
+    for (int i = 0; job->previous && i < job->previous->count; i++) {
+        if (!install_manifest_find(&task->manifest, job->previous->entries[i].full_path)) job->files_removed++;
+    }
+    os_client_record_install(job->slug, &task->manifest);
+    // The replaced revision is deleted in the background, and the blobs only it used with it.
+    if (task->replaced) os_client_discard(job->previous_dir);
+    finish_job(job, INSTALL_STATUS_COMPLETE);
+}
+
+static void run_disk_task(disk_task_t *task) {
+    switch (task->kind) {
+    case DISK_TASK_REUSE:
+        task->ok = reuse_local_copy(task->job, task->transfer, &task->size);
+        // A no-op unless the file was installed before the store existed
+        if (task->ok) blob_store_insert(task->transfer->local_path, task->transfer->sha256);
+        break;
+    case DISK_TASK_STORE:
+        if (!blob_store_insert(task->path, task->sha256)) {
+            fprintf(stderr, "Failed to add %s to the blob store\n", task->path);
+        }
+        break;
+    case DISK_TASK_COMMIT:
+        task->ok = commit_install(task->job, &task->manifest, &task->replaced);
+        break;
+    }
+}
+
+// Hands a finished task back to the LVGL thread, or frees it if nothing waits for it.
+static void complete_disk_task_locked(disk_task_t *task) {
+    if (!task->job) {
+        free(task);
+        return;
+    }
+    disk_task_t **tail = &s_disk_done;
+    while (*tail) tail = &(*tail)->next;
+    task->next = NULL;
+    *tail = task;
+}
+
+static void *disk_thread_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&s_disk_lock);
+    // What is queued still runs once the thread is asked to stop, so no task is lost.
+    while (s_disk_queue || !s_disk_stop) {
+        if (!s_disk_queue) {
+            pthread_cond_wait(&s_disk_cond, &s_disk_lock);
+            continue;
+        }
+        disk_task_t *task = s_disk_queue;
+        s_disk_queue = task->next;
+        bool cancelled = task->cancelled;
+        pthread_mutex_unlock(&s_disk_lock);
+        if (!cancelled) run_disk_task(task);
+        pthread_mutex_lock(&s_disk_lock);
+        complete_disk_task_locked(task);
+    }
+    pthread_mutex_unlock(&s_disk_lock);
+    return NULL;
+}
+
+// Queues a task on the disk thread, starting the thread if needed. Without a
+// thread, runs the task right away; its result is still handled from the timer,
+// so the caller is never reentered.
+static void submit_disk_task(disk_task_t *task) {
+    install_job_t *job = task->job;
+    task->next = NULL;
+    pthread_mutex_lock(&s_disk_lock);
+    if (!s_disk_started) s_disk_started = pthread_create(&s_disk_thread, NULL, disk_thread_main, NULL) == 0;
+    bool started = s_disk_started;
+    if (started) {
+        disk_task_t **tail = &s_disk_queue;
+        while (*tail) tail = &(*tail)->next;
+        *tail = task;
+        pthread_cond_signal(&s_disk_cond);
+    }
+    pthread_mutex_unlock(&s_disk_lock);
+    if (!started) {
+        run_disk_task(task);
+        pthread_mutex_lock(&s_disk_lock);
+        complete_disk_task_locked(task);
+        pthread_mutex_unlock(&s_disk_lock);
+    }
+    if (!job) return;
+    job->disk_tasks++;
+    s_disk_pending++;
+    if (!s_disk_timer) s_disk_timer = lv_timer_create(disk_timer_cb, DISK_POLL_PERIOD_MS, NULL);
+    if (s_disk_timer) lv_timer_resume(s_disk_timer);
+}
+
+// Has the disk thread enter a downloaded file into the blob store.
+static void store_downloaded_file(const install_transfer_t *transfer) {
+    disk_task_t *task = calloc(1, sizeof(disk_task_t));
+    if (!task) {
+        fprintf(stderr, "Failed to add %s to the blob store\n", transfer->local_path);
+        return;
+    }
+    task->kind = DISK_TASK_STORE;
+    snprintf(task->path, sizeof(task->path), "%s", transfer->local_path);
+    snprintf(task->sha256, sizeof(task->sha256), "%s", transfer->sha256);
+    submit_disk_task(task);
+}
+
+// Keeps the disk thread from starting the tasks of a job that has ended.
+static void cancel_disk_tasks(const install_job_t *job) {
+    pthread_mutex_lock(&s_disk_lock);
+    for (disk_task_t *task = s_disk_queue; task; task = task->next) {
+        if (task->job == job) task->cancelled = true;
+    }
+    pthread_mutex_unlock(&s_disk_lock);
+}
+
+// Runs what is still queued and stops the disk thread.
+static void stop_disk_thread(void) {
+    pthread_mutex_lock(&s_disk_lock);
+    bool started = s_disk_started;
+    s_disk_stop = true;
+    pthread_cond_signal(&s_disk_cond);
+    pthread_mutex_unlock(&s_disk_lock);
+    if (started) pthread_join(s_disk_thread, NULL);
+    s_disk_started = false;
+    s_disk_stop = false;
+}
+
+// A file was looked for on disk: it is done if a copy turned up, and downloaded otherwise.
+static void reuse_done(install_job_t *job, install_transfer_t *transfer, bool found, uint64_t size) {
+    job->active--;
+    if (found) {
+        job->files_done++;
+        job->files_skipped++;
+        job->bytes_skipped += size;
+        notify(job);
+    } else if (!start_transfer(job, transfer)) {
+        job->failed_file = transfer->info->full_path;
+        job->error = "could not start download";
+        finish_job(job, INSTALL_STATUS_FAILED);
+        return;
+    }
+    fill_slots(job);
+}
+
+static void handle_disk_task(disk_task_t *task) {
+    install_job_t *job = task->job;
+    job->disk_tasks--;
+    if (job->finished) {
+        if (job->disk_tasks == 0) destroy_job(job);
+    } else if (task->kind == DISK_TASK_REUSE) {
+        reuse_done(job, task->transfer, task->ok, task->size);
+    } else if (task->kind == DISK_TASK_COMMIT) {
+        commit_done(job, task);
+    }
+    free(task->manifest.entries);
+    free(task);
+}
+
+static void handle_disk_results(void) {
+    pthread_mutex_lock(&s_disk_lock);
+    disk_task_t *done = s_disk_done;
+    s_disk_done = NULL;
+    pthread_mutex_unlock(&s_disk_lock);
+    while (done) {
+        disk_task_t *task = done;
+        done = task->next;
+        s_disk_pending--;
+        handle_disk_task(task);
+    }
+}
+
+static void disk_timer_cb(lv_timer_t *timer) {
+    handle_disk_results();
+    if (s_disk_pending == 0) lv_timer_pause(timer);
+}
+
+// Starts (or, after a failed attempt, resumes) the download of a file into the staging tree.
+static bool start_transfer(install_job_t *job, install_transfer_t *transfer) {
+    CURL *handle = http_pool_acquire();
+    if (!handle) return false;
+    if (!file_download_begin(&transfer->download, handle, transfer->local_path, transfer->info->url,
+                             job->dirs, &job->io)) {
+        http_pool_release(handle);
+        return false;
+    }
+    transfer->attempts++;
+    transfer->request = http_async_submit(handle, false, transfer_done_cb, transfer);
+    if (!transfer->request) {
+        file_download_finish(&transfer->download, CURLE_FAILED_INIT, 0, NULL);
+        return false;
+    }
+    job->active++;
+    job->current_file = transfer->info->full_path;
+    return true;
+}
+
+static void start_job(install_job_t *job) {
+    job->status = INSTALL_STATUS_RUNNING;
+    s_reported_bytes = 0;
+    if (!s_progress_timer) {
+        s_progress_timer = lv_timer_create(progress_timer_cb, INSTALL_MANAGER_PROGRESS_PERIOD_MS, NULL);
+    }
+    if (s_progress_timer) lv_timer_resume(s_progress_timer);
+    job->previous = install_manifest_load(job->live_dir);
+    // Incremental installs pick up files an interrupted attempt already staged.
+    struct stat st;
+    if (job->mode == INSTALL_MODE_FULL && stat(job->staging_dir, &st) == 0) os_client_discard(job->staging_dir);
+    job->dirs = dir_cache_create(&job->io);
+    if (!job->dirs) {
+        job->error = "out of memory";
+        finish_job(job, INSTALL_STATUS_FAILED);
+        return;
+    }
+    notify(job);
+    fill_slots(job);
+}
+
+// Starts downloads until the concurrency limit is reached, or finishes the job
+// once every file is in place. The job may be freed on return.
+static void fill_slots(install_job_t *job) {
+    while (job->active < INSTALL_MANAGER_MAX_CONCURRENCY && job->next_file < job->file_count) {
+        install_transfer_t *transfer = &job->transfers[job->next_file++];
+        if (!is_safe_relative_path(transfer->info->full_path)) {
+            job->failed_file = transfer->info->full_path;
+            job->error = "invalid file path";
+            finish_job(job, INSTALL_STATUS_FAILED);
+            return;
+        }
+        // The disk thread looks for a local copy first; the file takes a slot meanwhile.
+        if (job->mode == INSTALL_MODE_INCREMENTAL && transfer->info->sha256[0]) {
+            disk_task_t *task = calloc(1, sizeof(disk_task_t));
+            if (!task) {
+                job->error = "out of memory";
+                finish_job(job, INSTALL_STATUS_FAILED);
+                return;
+            }
+            task->kind = DISK_TASK_REUSE;
+            task->job = job;
+            task->transfer = transfer;
+            job->active++;
+            submit_disk_task(task);
+            continue;
+        }
+        if (!start_transfer(job, transfer)) {
+            job->failed_file = transfer->info->full_path;
+            job->error = "could not start download";
+            finish_job(job, INSTALL_STATUS_FAILED);
+            return;
+        }
+    }
+    if (job->active == 0 && job->next_file >= job->file_count && !job->committing) {
+        // Queued behind the blob store inserts, which still read the staged files.
+        disk_task_t *task = calloc(1, sizeof(disk_task_t));
+        if (!task || !os_client_begin_change()) {
+            free(task);
+            job->error = "could not publish the installed files";
+            finish_job(job, INSTALL_STATUS_FAILED);
+            return;
+        }
+        task->kind = DISK_TASK_COMMIT;
+        task->job = job;
+        job->committing = true;
+        submit_disk_task(task);
+    }
+}
+
+// Ends an install: aborts its remaining transfers, reports the final state,
+// frees the job and starts the next queued one.
+static void finish_job(install_job_t *job, install_status_t status) {
+    job->status = status;
+    for (int i = 0; i < job->file_count; i++) {
+        if (job->transfers[i].request) http_async_cancel(job->transfers[i].request);
+    }
+    notify(job);
+
+    bool was_running = job == s_jobs;
+    for (install_job_t **link = &s_jobs; *link; link = &(*link)->next) {
+        if (*link == job) {
+            *link = job->next;
+            break;
+        }
+    }
+    if (job->disk_tasks > 0) {
+        job->finished = true; // Freed once the disk thread is done with it
+        cancel_disk_tasks(job);
+    } else {
+        destroy_job(job);
+    }
+
+    if (!s_jobs) {
+        if (s_progress_timer) lv_timer_pause(s_progress_timer);
+    } else if (was_running) {
+        start_job(s_jobs);
+    }
+}
+
+// Network errors and server-side failures are worth another attempt; a 404 is not.
+static bool is_transient_failure(const http_response_t *response) {
+    return response->status == 0 || response->status >= 500 ||
+           (response->result != CURLE_OK && (response->status == 200 || response->status == 206));
+}
+
+static void transfer_done_cb(const http_response_t *response, void *user_data) {
+    install_transfer_t *transfer = user_data;
+    install_job_t *job = transfer->job;
+    transfer->request = NULL;
+    job->active--;
+    // A cancelled or failed transfer keeps what it received, so the next attempt
+    // (or the next install) resumes it.
+    file_download_result_t result = file_download_finish(&transfer->download, response->result, response->status,
+                                                         transfer->info->sha256);
+    bool resumed = transfer->download.offset > 0;
+    // Counted once the file is complete, so bytes of attempts that were thrown away
+    // are not counted twice and a prefix resumed from an earlier run is not missed.
+    uint64_t file_bytes = transfer->download.offset + transfer->download.received;
+    if (response->cancelled) return; // The job is being finished by whoever cancelled it.
+
+    if (result == FILE_DOWNLOAD_FAILED) {
+        fprintf(stderr, "Download failed for %s: %s (HTTP %ld)\n",
+                transfer->info->url, curl_easy_strerror(response->result), response->status);
+        if (is_transient_failure(response) && transfer->attempts < INSTALL_MANAGER_MAX_ATTEMPTS &&
+            start_transfer(job, transfer)) {
+            return;
+        }
+    }
+    // A range the server rejects, or a digest that does not add up, means the part
+    // resumed from disk was stale. It has been discarded; fetch the whole file once more.
+    if (resumed && !transfer->restarted && (response->status == 416 || result == FILE_DOWNLOAD_MISMATCH)) {
+        transfer->restarted = true;
+        if (start_transfer(job, transfer)) return;
+    }
+    if (result != FILE_DOWNLOAD_OK) {
+        job->failed_file = transfer->info->full_path;
+        job->error = result == FILE_DOWNLOAD_MISMATCH ? "checksum mismatch" : "download failed";
+        finish_job(job, INSTALL_STATUS_FAILED);
+        return;
+    }
+    job->bytes_done += file_bytes;
+    memcpy(transfer->sha256, transfer->download.sha256, sizeof(transfer->sha256));
+    store_downloaded_file(transfer);
+    job->files_done++;
+    notify(job);
+    fill_slots(job);
+}
+
+// Reports bytes arriving between file completions, at most once per period.
+static void progress_timer_cb(lv_timer_t *timer) {
+    install_job_t *job = s_jobs;
+    if (!job || job->status != INSTALL_STATUS_RUNNING) {
+        lv_timer_pause(timer);
+        return;
+    }
+    install_progress_t progress;
+    fill_progress(job, &progress);
+    if (progress.bytes_done != s_reported_bytes) notify(job);
+}
+
+void install_manager_init(void) {
+    // A crash between parking the installed tree and publishing the staged one
+    // leaves the project without a live directory: put the old revision back.
+    DIR *dir = opendir(PREVIOUS_DIR);
+    struct dirent *entry;
+    while (dir && (entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        char previous_path[512];
+        char live_path[512];
+        struct stat st;
+        snprintf(previous_path, sizeof(previous_path), "%s/%s", PREVIOUS_DIR, entry->d_name);
+        snprintf(live_path, sizeof(live_path), "%s/%s", INSTALLATION_DIR, entry->d_name);
+        if (stat(live_path, &st) != 0) {
+            fprintf(stderr, "Restoring %s after an interrupted install\n", live_path);
+            rename(previous_path, live_path);
+        } else {
+            os_client_discard(previous_path);
+        }
+    }
+    if (dir) closedir(dir);
+}
+
+bool install_manager_install(const project_detail_t *details, install_mode_t mode) {
+    if (!details || !details->slug || find_job(details->slug)) return false;
+    // The slug names a directory next to the staging areas.
+    if (!details->slug[0] || details->slug[0] == '.' || strchr(details->slug, '/')) return false;
+    install_job_t *job = create_job(details, mode);
+    if (!job) return false;
+
+    install_job_t **tail = &s_jobs;
+    while (*tail) tail = &(*tail)->next;
+    *tail = job;
+    if (job == s_jobs) {
+        start_job(job);
+    } else {
+        notify(job);
+    }
+    return true;
+}
+
+void install_manager_cancel(const char *slug) {
+    install_job_t *job = find_job(slug);
+    if (job && !job->committing) finish_job(job, INSTALL_STATUS_CANCELLED);
+}
+
+bool install_manager_get_progress(const char *slug, install_progress_t *progress) {
+    install_job_t *job = find_job(slug);
+    if (!job) return false;
+    if (progress) fill_progress(job, progress);
+    return true;
+}
+
+void install_manager_set_listener(install_progress_cb_t cb, void *user_data) {
+    s_listener = cb;
+    s_listener_data = user_data;
+}
+
+void install_manager_deinit(void) {
+    s_listener = NULL;
+    s_listener_data = NULL;
+    // Cancel queued installs first so finishing the running one starts nothing.
+    while (s_jobs && s_jobs->next) finish_job(s_jobs->next, INSTALL_STATUS_CANCELLED);
+    if (s_jobs && !s_jobs->committing) finish_job(s_jobs, INSTALL_STATUS_CANCELLED);
+    stop_disk_thread();
+    handle_disk_results(); // Finishes a commit in progress and frees the jobs that waited for the thread
+    if (s_disk_timer) {
+        lv_timer_del(s_disk_timer);
+        s_disk_timer = NULL;
+    }
+    if (s_progress_timer) {
+        lv_timer_del(s_progress_timer);
+        s_progress_timer = NULL;
+    }
+    file_writer_pool_clear();
+}
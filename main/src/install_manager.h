@@ -0,0 +1,114 @@
+#ifndef INSTALL_MANAGER_H
+#define INSTALL_MANAGER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "badgehub_client.h"
+#include "file_writer.h"
+
+// Maximum number of files of an install that are downloaded at the same time.
+#define INSTALL_MANAGER_MAX_CONCURRENCY 4
+// Attempts per file before a transient download error fails the install. Each
+// retry resumes where the previous attempt stopped.
+#define INSTALL_MANAGER_MAX_ATTEMPTS 3
+// Minimum interval between two byte-progress notifications of the same install.
+#define INSTALL_MANAGER_PROGRESS_PERIOD_MS 100
+
+typedef enum {
+    INSTALL_STATUS_QUEUED,
+    INSTALL_STATUS_RUNNING,
+    INSTALL_STATUS_COMPLETE,
+    INSTALL_STATUS_FAILED,
+    INSTALL_STATUS_CANCELLED,
+} install_status_t;
+
+typedef enum {
+    INSTALL_MODE_FULL,         // Download every file
+    INSTALL_MODE_INCREMENTAL,  // Download only files whose sha256 differs from the local copy
+} install_mode_t;
+
+// Snapshot of an install, passed to the progress listener. The strings are only
+// valid for the duration of the callback.
+typedef struct {
+    const char *slug;
+    int revision;
+    install_status_t status;
+    int files_total;
+    int files_done;            // Including skipped files
+    uint64_t bytes_done;       // Bytes written so far, including files still in flight
+    int files_skipped;         // Files already up to date locally
+    uint64_t bytes_skipped;    // Size of the skipped files, i.e. bytes not downloaded
+    int files_removed;         // Stale files of the previous install, removed on completion
+    const char *current_file;  // Most recently started file, NULL before the first one
+    const char *failed_file;   // Set when status is INSTALL_STATUS_FAILED
+    const char *error;         // Why it failed, e.g. "checksum mismatch"
+    file_writer_stats_t io;    // Writes and directories created for the install so far
+} install_progress_t;
+
+typedef void (*install_progress_cb_t)(const install_progress_t *progress, void *user_data);
+
+/**
+ * @brief Finishes or rolls back installs a crash interrupted. Call once at
+ * startup, before anything reads INSTALLATION_DIR.
+ */
+void install_manager_init(void);
+
+/**
+ * @brief Queues the installation of a project.
+ *
+ * Installs run one after another on the LVGL thread through http_async; the files
+ * of the running install are downloaded up to INSTALL_MANAGER_MAX_CONCURRENCY at a
+ * time. Hashing, copying, flushing and publishing files is left to a thread of
+ * the manager's own, so the UI does not wait for the disk. The manager keeps its own copy of the file list, so the caller may free
+ * details right away and the install continues when the view that started it is
+ * deleted.
+ *
+ * Every downloaded file is hashed as it is written and the install fails if the
+ * digest differs from the sha256 the server lists. Interrupted downloads are
+ * resumed with Range requests, both when retried within the install and when the
+ * install is started again later.
+ *
+ * Files are assembled in a staging directory and published together with a
+ * single rename once they are all verified and synced, so INSTALLATION_DIR/<slug>
+ * always holds one complete revision. The replaced revision is deleted in the
+ * background (see os_client_discard()). A failed or cancelled install keeps what
+ * it staged for the next attempt.
+ *
+ * A successful install records the files in an install manifest. Files listed in
+ * the previous manifest but no longer part of the project are dropped; files the
+ * app created itself are kept. In incremental mode, a file whose staged or
+ * installed copy already has the expected sha256 is not downloaded; the manifest
+ * lets unchanged files skip rehashing. Neither is a file some other app or
+ * revision already brought into the blob store (see blob_store.h).
+ *
+ * @return false if the project is already queued or running, or on allocation failure.
+ */
+bool install_manager_install(const project_detail_t *details, install_mode_t mode);
+
+/**
+ * @brief Cancels a queued or running install, leaving the installed revision
+ * untouched. An install whose files are already being published completes.
+ */
+void install_manager_cancel(const char *slug);
+
+/**
+ * @brief Returns whether the project is queued or being installed.
+ *
+ * @param progress If not NULL and the project is found, populated with its
+ *                 current state; the strings stay valid until the next call
+ *                 into the manager or return to the LVGL loop.
+ */
+bool install_manager_get_progress(const char *slug, install_progress_t *progress);
+
+/**
+ * @brief Sets the callback that receives progress of every install. Passing NULL
+ * detaches the listener without affecting running installs.
+ */
+void install_manager_set_listener(install_progress_cb_t cb, void *user_data);
+
+/**
+ * @brief Cancels every install. Call before badgehub_client_cleanup().
+ */
+void install_manager_deinit(void);
+
+#endif // INSTALL_MANAGER_H
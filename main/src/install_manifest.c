@@ -0,0 +1,121 @@
+#include "install_manifest.h"
+#include "arena.h"
+#include "utils.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- CONSTANTS ---
+#define MANIFEST_HEADER "badgehub-manifest 1"
+#define MAX_LINE_LENGTH 1024
+
+// Format, one file per line after the header and revision lines:
+//   <sha256 or -> <size> <mtime> <full_path>
+// The path comes last so it may contain spaces.
+
+// --- IMPLEMENTATIONS ---
+
+static void manifest_path(const char *project_dir, char *path, size_t path_size) {
+    snprintf(path, path_size, "%s/%s", project_dir, INSTALL_MANIFEST_NAME);
+}
+
+static int compare_entries(const void *a, const void *b) {
+    return strcmp(((const install_manifest_entry_t *)a)->full_path, ((const install_manifest_entry_t *)b)->full_path);
+}
+
+// Parses one file line into entry, copying the path into the arena.
+static bool parse_entry(arena_t *arena, char *line, install_manifest_entry_t *entry) {
+    line[strcspn(line, "\r\n")] = '\0';
+    char sha256[SHA256_HEX_SIZE + 1];
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    int path_offset = 0;
+    if (sscanf(line, "%65s %" SCNu64 " %" SCNd64 " %n", sha256, &size, &mtime, &path_offset) != 3 ||
+        path_offset == 0 || line[path_offset] == '\0') {
+        return false;
+    }
+    if (strcmp(sha256, "-") == 0) {
+        entry->sha256[0] = '\0';
+    } else if (strlen(sha256) == SHA256_HEX_SIZE - 1) {
+        memcpy(entry->sha256, sha256, SHA256_HEX_SIZE);
+    } else {
+        return false;
+    }
+    entry->full_path = arena_strdup(arena, line + path_offset);
+    entry->size = size;
+    entry->mtime = mtime;
+    return entry->full_path != NULL;
+}
+
+install_manifest_t *install_manifest_load(const char *project_dir) {
+    if (!project_dir) return NULL;
+    char path[512];
+    manifest_path(project_dir, path, sizeof(path));
+    FILE *fp = fopen(path, "r");
+    if (!fp) return NULL;
+
+    char line[MAX_LINE_LENGTH];
+    int revision = 0;
+    if (!fgets(line, sizeof(line), fp) || strncmp(line, MANIFEST_HEADER, strlen(MANIFEST_HEADER)) != 0 ||
+        !fgets(line, sizeof(line), fp) || sscanf(line, "revision %d", &revision) != 1) {
+        fprintf(stderr, "Ignoring unreadable install manifest %s\n", path);
+        fclose(fp);
+        return NULL;
+    }
+    // Count the file lines first so the entries can be allocated in one go.
+    long files_start = ftell(fp);
+    int capacity = 0;
+    while (fgets(line, sizeof(line), fp)) capacity++;
+    fseek(fp, files_start, SEEK_SET);
+
+    arena_t *arena = arena_create(0);
+    install_manifest_t *manifest = arena ? arena_alloc_root(arena, sizeof(install_manifest_t)) : NULL;
+    if (!manifest) {
+        if (arena) arena_destroy(arena);
+        fclose(fp);
+        return NULL;
+    }
+    manifest->revision = revision;
+    manifest->entries = capacity > 0 ? arena_alloc(arena, capacity * sizeof(install_manifest_entry_t)) : NULL;
+    while (manifest->entries && manifest->count < capacity && fgets(line, sizeof(line), fp)) {
+        if (parse_entry(arena, line, &manifest->entries[manifest->count])) manifest->count++;
+    }
+    fclose(fp);
+    qsort(manifest->entries, manifest->count, sizeof(install_manifest_entry_t), compare_entries);
+    return manifest;
+}
+
+static bool put_manifest(FILE *fp, void *context) {
+    const install_manifest_t *manifest = context;
+    fprintf(fp, "%s\nrevision %d\n", MANIFEST_HEADER, manifest->revision);
+    for (int i = 0; i < manifest->count; i++) {
+        const install_manifest_entry_t *entry = &manifest->entries[i];
+        fprintf(fp, "%s %" PRIu64 " %" PRId64 " %s\n", entry->sha256[0] ? entry->sha256 : "-",
+                entry->size, entry->mtime, entry->full_path);
+    }
+    return true;
+}
+
+bool install_manifest_save(const char *project_dir, install_manifest_t *manifest) {
+    if (!project_dir || !manifest) return false;
+    if (manifest->count > 0) {
+        qsort(manifest->entries, manifest->count, sizeof(install_manifest_entry_t), compare_entries);
+    }
+    char path[512];
+    manifest_path(project_dir, path, sizeof(path));
+    if (write_file_atomic(path, put_manifest, manifest)) return true;
+    fprintf(stderr, "Failed to write install manifest %s\n", path);
+    return false;
+}
+
+const install_manifest_entry_t *install_manifest_find(const install_manifest_t *manifest, const char *full_path) {
+    if (!manifest || !full_path || manifest->count == 0) return NULL;
+    install_manifest_entry_t key;
+    key.full_path = full_path;
+    return bsearch(&key, manifest->entries, manifest->count, sizeof(install_manifest_entry_t), compare_entries);
+}
+
+void install_manifest_free(install_manifest_t *manifest) {
+    arena_destroy_root(manifest);
+}
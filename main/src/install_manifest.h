@@ -0,0 +1,56 @@
+#ifndef INSTALL_MANIFEST_H
+#define INSTALL_MANIFEST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sha256.h"
+
+// Written into a project's directory by every successful install.
+#define INSTALL_MANIFEST_NAME ".badgehub_manifest"
+
+// What was installed for one file. size and mtime identify the file on disk as it
+// was when the manifest was written, so an unchanged file need not be rehashed.
+typedef struct {
+    const char *full_path;
+    char sha256[SHA256_HEX_SIZE]; // Empty if the server did not provide one
+    uint64_t size;
+    int64_t mtime;                // Nanoseconds since the epoch
+} install_manifest_entry_t;
+
+typedef struct {
+    int revision;
+    install_manifest_entry_t *entries;
+    int count;
+} install_manifest_t;
+
+/**
+ * @brief Reads the manifest in a project directory, e.g. INSTALLATION_DIR/<slug>.
+ *
+ * @return The manifest (free with install_manifest_free()), or NULL if the project
+ *         has none or it could not be read.
+ */
+install_manifest_t *install_manifest_load(const char *project_dir);
+
+/**
+ * @brief Writes the manifest into a project directory, replacing the previous one atomically.
+ *
+ * The entries are sorted by path in place, so the manifest can be searched with
+ * install_manifest_find() afterwards.
+ *
+ * @return true on success.
+ */
+bool install_manifest_save(const char *project_dir, install_manifest_t *manifest);
+
+/**
+ * @brief Looks up a file in a loaded or saved manifest.
+ *
+ * @return The entry, or NULL if the manifest does not list the file.
+ */
+const install_manifest_entry_t *install_manifest_find(const install_manifest_t *manifest, const char *full_path);
+
+/**
+ * @brief Frees a manifest returned by install_manifest_load(). NULL is ignored.
+ */
+void install_manifest_free(install_manifest_t *manifest);
+
+#endif // INSTALL_MANIFEST_H
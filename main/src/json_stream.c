@@ -0,0 +1,321 @@
+#include "json_stream.h"
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    ST_VALUE,          // Expecting a value
+    ST_VALUE_OR_END,   // Just after '[': a value or ']'
+    ST_KEY,            // Expecting a member name
+    ST_KEY_OR_END,     // Just after '{': a member name or '}'
+    ST_COLON,          // Expecting ':' after a member name
+    ST_AFTER_VALUE,    // Expecting ',' or the end of the current container
+    ST_STRING,
+    ST_STRING_ESCAPE,
+    ST_STRING_UNICODE,
+    ST_NUMBER,
+    ST_LITERAL,
+    ST_DONE,           // The root value is complete; only whitespace may follow
+};
+
+// --- IMPLEMENTATIONS ---
+
+void json_stream_init(json_stream_t *stream, json_stream_cb_t cb, void *user_data) {
+    memset(stream, 0, sizeof(*stream));
+    stream->cb = cb;
+    stream->user_data = user_data;
+    stream->state = ST_VALUE;
+}
+
+void json_stream_free(json_stream_t *stream) {
+    free(stream->token);
+    stream->token = NULL;
+    stream->token_len = stream->token_cap = 0;
+}
+
+static bool token_append(json_stream_t *stream, const char *bytes, size_t length) {
+    if (stream->token_len + length + 1 > stream->token_cap) {
+        size_t cap = stream->token_cap ? stream->token_cap : 64;
+        while (cap < stream->token_len + length + 1) cap *= 2;
+        char *grown = realloc(stream->token, cap);
+        if (!grown) return false;
+        stream->token = grown;
+        stream->token_cap = cap;
+    }
+    memcpy(stream->token + stream->token_len, bytes, length);
+    stream->token_len += length;
+    stream->token[stream->token_len] = '\0';
+    return true;
+}
+
+static bool token_append_codepoint(json_stream_t *stream, unsigned int cp) {
+    char utf8[4];
+    size_t n;
+    if (cp < 0x80) {
+        utf8[0] = (char)cp; n = 1;
+    } else if (cp < 0x800) {
+        utf8[0] = (char)(0xC0 | (cp >> 6));
+        utf8[1] = (char)(0x80 | (cp & 0x3F)); n = 2;
+    } else if (cp < 0x10000) {
+        utf8[0] = (char)(0xE0 | (cp >> 12));
+        utf8[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[2] = (char)(0x80 | (cp & 0x3F)); n = 3;
+    } else {
+        utf8[0] = (char)(0xF0 | (cp >> 18));
+        utf8[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        utf8[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[3] = (char)(0x80 | (cp & 0x3F)); n = 4;
+    }
+    return token_append(stream, utf8, n);
+}
+
+static void emit(json_stream_t *stream, json_event_type_t type, const char *value, size_t length) {
+    json_stream_event_t event;
+    event.type = type;
+    event.depth = stream->depth;
+    bool in_object = stream->depth > 0 && stream->containers[stream->depth - 1] == '{';
+    event.key = in_object && !stream->key_too_long[stream->depth] ? stream->keys[stream->depth] : NULL;
+    event.value = value;
+    event.length = length;
+    if (stream->cb) stream->cb(&event, stream->user_data);
+}
+
+// Moves to the state that follows a completed value.
+static void value_done(json_stream_t *stream) {
+    stream->state = stream->depth == 0 ? ST_DONE : ST_AFTER_VALUE;
+}
+
+static bool open_container(json_stream_t *stream, char type) {
+    if (stream->depth >= JSON_STREAM_MAX_DEPTH) return false;
+    emit(stream, type == '{' ? JSON_EVENT_OBJECT_START : JSON_EVENT_ARRAY_START, NULL, 0);
+    stream->containers[stream->depth++] = type;
+    stream->keys[stream->depth][0] = '\0';
+    stream->key_too_long[stream->depth] = false;
+    stream->state = type == '{' ? ST_KEY_OR_END : ST_VALUE_OR_END;
+    return true;
+}
+
+static bool close_container(json_stream_t *stream, char type) {
+    if (stream->depth == 0 || stream->containers[stream->depth - 1] != (type == '}' ? '{' : '[')) return false;
+    stream->depth--;
+    emit(stream, type == '}' ? JSON_EVENT_OBJECT_END : JSON_EVENT_ARRAY_END, NULL, 0);
+    value_done(stream);
+    return true;
+}
+
+static void finish_string(json_stream_t *stream) {
+    const char *text = stream->token ? stream->token : "";
+    if (stream->string_is_key) {
+        stream->key_too_long[stream->depth] = stream->token_len > JSON_STREAM_MAX_KEY;
+        if (!stream->key_too_long[stream->depth]) {
+            memcpy(stream->keys[stream->depth], text, stream->token_len);
+            stream->keys[stream->depth][stream->token_len] = '\0';
+        }
+        stream->state = ST_COLON;
+    } else {
+        emit(stream, JSON_EVENT_STRING, text, stream->token_len);
+        value_done(stream);
+    }
+}
+
+static bool finish_number(json_stream_t *stream) {
+    char *end = NULL;
+    strtod(stream->token, &end);
+    if (!end || *end != '\0') return false;
+    emit(stream, JSON_EVENT_NUMBER, stream->token, stream->token_len);
+    value_done(stream);
+    return true;
+}
+
+static bool finish_literal(json_stream_t *stream) {
+    if (strcmp(stream->token, "true") == 0) emit(stream, JSON_EVENT_TRUE, NULL, 0);
+    else if (strcmp(stream->token, "false") == 0) emit(stream, JSON_EVENT_FALSE, NULL, 0);
+    else if (strcmp(stream->token, "null") == 0) emit(stream, JSON_EVENT_NULL, NULL, 0);
+    else return false;
+    value_done(stream);
+    return true;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Handles one character in one of the structural (non-token) states.
+static bool handle_structural(json_stream_t *stream, char c) {
+    if (is_space(c)) return true;
+    switch (stream->state) {
+    case ST_VALUE_OR_END:
+        if (c == ']') return close_container(stream, ']');
+        /* fall through */
+    case ST_VALUE:
+        if (c == '{' || c == '[') return open_container(stream, c);
+        stream->token_len = 0;
+        if (c == '"') {
+            stream->string_is_key = false;
+            stream->state = ST_STRING;
+            return token_append(stream, "", 0);
+        }
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            stream->state = ST_NUMBER;
+            return token_append(stream, &c, 1);
+        }
+        if (c >= 'a' && c <= 'z') {
+            stream->state = ST_LITERAL;
+            return token_append(stream, &c, 1);
+        }
+        return false;
+    case ST_KEY_OR_END:
+        if (c == '}') return close_container(stream, '}');
+        /* fall through */
+    case ST_KEY:
+        if (c != '"') return false;
+        stream->token_len = 0;
+        stream->string_is_key = true;
+        stream->state = ST_STRING;
+        return token_append(stream, "", 0);
+    case ST_COLON:
+        if (c != ':') return false;
+        stream->state = ST_VALUE;
+        return true;
+    case ST_AFTER_VALUE:
+        if (c == ',') {
+            stream->state = stream->containers[stream->depth - 1] == '{' ? ST_KEY : ST_VALUE;
+            return true;
+        }
+        if (c == '}' || c == ']') return close_container(stream, c);
+        return false;
+    case ST_DONE:
+    default:
+        return false;
+    }
+}
+
+bool json_stream_feed(json_stream_t *stream, const char *data, size_t length) {
+    if (stream->error) return false;
+    size_t i = 0;
+    while (i < length) {
+        char c = data[i];
+        bool ok = true;
+        switch (stream->state) {
+        case ST_STRING: {
+            // Copy the run of plain characters in one go.
+            size_t start = i;
+            while (i < length && data[i] != '"' && data[i] != '\\' && (unsigned char)data[i] >= 0x20) i++;
+            if (i > start) {
+                if (stream->high_surrogate) {
+                    ok = token_append_codepoint(stream, 0xFFFD);
+                    stream->high_surrogate = 0;
+                }
+                ok = ok && token_append(stream, data + start, i - start);
+            }
+            if (!ok) break;
+            if (i == length) continue;
+            c = data[i];
+            if (c == '"') {
+                if (stream->high_surrogate) {
+                    ok = token_append_codepoint(stream, 0xFFFD);
+                    stream->high_surrogate = 0;
+                }
+                finish_string(stream);
+            } else if (c == '\\') {
+                stream->state = ST_STRING_ESCAPE;
+            } else {
+                ok = false; // Unescaped control character
+            }
+            break;
+        }
+        case ST_STRING_ESCAPE: {
+            const char *escapes = "\"\"\\\\//b\bf\fn\nr\rt\t";
+            stream->state = ST_STRING;
+            if (c == 'u') {
+                stream->unicode = 0;
+                stream->unicode_digits = 0;
+                stream->state = ST_STRING_UNICODE;
+                break;
+            }
+            if (stream->high_surrogate) {
+                ok = token_append_codepoint(stream, 0xFFFD);
+                stream->high_surrogate = 0;
+            }
+            const char *match = NULL;
+            for (const char *e = escapes; *e; e += 2) {
+                if (*e == c) { match = e + 1; break; }
+            }
+            ok = ok && match && token_append(stream, match, 1);
+            break;
+        }
+        case ST_STRING_UNICODE: {
+            int digit = hex_value(c);
+            if (digit < 0) { ok = false; break; }
+            stream->unicode = (stream->unicode << 4) | (unsigned int)digit;
+            if (++stream->unicode_digits < 4) break;
+            stream->state = ST_STRING;
+            unsigned int cp = stream->unicode;
+            if (cp >= 0xD800 && cp <= 0xDBFF) {
+                if (stream->high_surrogate) ok = token_append_codepoint(stream, 0xFFFD);
+                stream->high_surrogate = cp;
+            } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                if (stream->high_surrogate) {
+                    cp = 0x10000 + ((stream->high_surrogate - 0xD800) << 10) + (cp - 0xDC00);
+                } else {
+                    cp = 0xFFFD;
+                }
+                stream->high_surrogate = 0;
+                ok = token_append_codepoint(stream, cp);
+            } else {
+                if (stream->high_surrogate) ok = token_append_codepoint(stream, 0xFFFD);
+                stream->high_surrogate = 0;
+                ok = ok && token_append_codepoint(stream, cp);
+            }
+            break;
+        }
+        case ST_NUMBER:
+            if ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+                ok = token_append(stream, &c, 1);
+                break;
+            }
+            if (!finish_number(stream)) {
+                stream->error = true;
+                return false;
+            }
+            continue; // Reprocess this character in the new state
+        case ST_LITERAL:
+            if (c >= 'a' && c <= 'z') {
+                ok = token_append(stream, &c, 1);
+                break;
+            }
+            if (!finish_literal(stream)) {
+                stream->error = true;
+                return false;
+            }
+            continue;
+        default:
+            ok = handle_structural(stream, c);
+            break;
+        }
+        if (!ok) {
+            stream->error = true;
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+bool json_stream_finish(json_stream_t *stream) {
+    if (stream->error) return false;
+    // A bare number or literal at the root has no terminating character.
+    if (stream->state == ST_NUMBER && stream->depth == 0) {
+        if (!finish_number(stream)) stream->error = true;
+    } else if (stream->state == ST_LITERAL && stream->depth == 0) {
+        if (!finish_literal(stream)) stream->error = true;
+    }
+    stream->done = !stream->error && stream->state == ST_DONE;
+    return stream->done;
+}
@@ -0,0 +1,84 @@
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Deepest nesting the parser accepts.
+#define JSON_STREAM_MAX_DEPTH 32
+// Values under longer member names are reported without a key (key is NULL), so a
+// name is never cut short into one that matches something else.
+#define JSON_STREAM_MAX_KEY 63
+
+typedef enum {
+    JSON_EVENT_OBJECT_START,
+    JSON_EVENT_OBJECT_END,
+    JSON_EVENT_ARRAY_START,
+    JSON_EVENT_ARRAY_END,
+    JSON_EVENT_STRING,
+    JSON_EVENT_NUMBER,
+    JSON_EVENT_TRUE,
+    JSON_EVENT_FALSE,
+    JSON_EVENT_NULL,
+} json_event_type_t;
+
+typedef struct {
+    json_event_type_t type;
+    int depth;         // Nesting level of the value: 0 for the root, 1 for its members, ...
+    const char *key;   // Member name if the value sits in an object, NULL in arrays, at the root
+                       // and for names longer than JSON_STREAM_MAX_KEY
+    const char *value; // Decoded, NUL terminated text of strings and numbers, NULL otherwise
+    size_t length;     // Length of value in bytes
+} json_stream_event_t;
+
+typedef void (*json_stream_cb_t)(const json_stream_event_t *event, void *user_data);
+
+// Parser state. Treat as opaque; it is public only so it can live on the stack or inside other structs.
+typedef struct {
+    json_stream_cb_t cb;
+    void *user_data;
+    int state;
+    int depth;
+    char containers[JSON_STREAM_MAX_DEPTH];                   // '{' or '[' per open container
+    char keys[JSON_STREAM_MAX_DEPTH + 1][JSON_STREAM_MAX_KEY + 1]; // Current member name per level
+    bool key_too_long[JSON_STREAM_MAX_DEPTH + 1];
+    bool string_is_key;
+    char *token;
+    size_t token_len;
+    size_t token_cap;
+    unsigned int unicode;       // Code point being read from a \uXXXX escape
+    int unicode_digits;
+    unsigned int high_surrogate;
+    bool error;
+    bool done;
+} json_stream_t;
+
+/**
+ * @brief Prepares a SAX-style JSON parser that can be fed input in arbitrary chunks.
+ *
+ * Events are delivered as soon as each value is complete, so callers can build
+ * their own structures while the document is still arriving, without ever
+ * holding the whole text or a DOM in memory.
+ */
+void json_stream_init(json_stream_t *stream, json_stream_cb_t cb, void *user_data);
+
+/**
+ * @brief Feeds the next chunk of input.
+ *
+ * @return false once the input is known to be malformed; further input is ignored.
+ */
+bool json_stream_feed(json_stream_t *stream, const char *data, size_t length);
+
+/**
+ * @brief Signals the end of input.
+ *
+ * @return true if a complete, well-formed JSON document was parsed.
+ */
+bool json_stream_finish(json_stream_t *stream);
+
+/**
+ * @brief Releases the parser's internal buffers.
+ */
+void json_stream_free(json_stream_t *stream);
+
+#endif // JSON_STREAM_H
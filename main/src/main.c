@@ -6,23 +6,56 @@
 #include <unistd.h>
 #endif
 #include "lvgl/lvgl.h"
+#if BADGEHUB_HEADLESS
+#include "headless_display.h"
+#else
 #include <SDL.h>
+#endif
 #include "app_home.h"
+#include "badgehub_client.h"
+#include "catalog_snapshot.h"
+#include "icon_cache.h"
+#include "install_manager.h"
+#include "os_client.h"
+#include "update_checker.h"
 
 static lv_display_t *hal_init(int32_t w, int32_t h);
 
 int main(int argc, char **argv)
 {
+    lv_init();
+    if (!hal_init(720, 720)) {
+        fprintf(stderr, "Failed to create the display\n");
+        return 1;
+    }
+#if BADGEHUB_HEADLESS
+    // The input script comes from the command line or the environment; without one
+    // the app runs without input until it is killed.
+    const char *script = argc > 1 ? argv[1] : getenv("BADGEHUB_INPUT_SCRIPT");
+    if (script && !headless_input_load_script(script)) return 1;
+#else
     (void)argc;
     (void)argv;
+#endif
+    icon_cache_init(ICON_CACHE_DEFAULT_BUDGET);
 
-    lv_init();
-    hal_init(720, 720);
+    if (!badgehub_client_init()) {
+        fprintf(stderr, "Failed to initialize the BadgeHub client\n");
+        return 1;
+    }
+    install_manager_init();
+    if (!os_client_init()) fprintf(stderr, "Failed to load the installed apps index\n");
 
+    // The home view renders from the last synced catalog, if any, without waiting for the network.
+    catalog_snapshot_load();
     // Create the main application UI using the new home screen
     create_app_home_view();
 
+#if BADGEHUB_HEADLESS
+    while (!headless_input_finished())
+#else
     while (1)
+#endif
     {
         lv_timer_handler();
 #ifdef _MSC_VER
@@ -32,9 +65,28 @@ int main(int argc, char **argv)
 #endif
     }
 
+    update_checker_deinit();
+    catalog_snapshot_deinit();
+    install_manager_deinit();
+    os_client_deinit();
+    badgehub_client_cleanup();
+    icon_cache_deinit();
+#if BADGEHUB_HEADLESS
+    headless_display_deinit();
+#endif
     return 0;
 }
 
+#if BADGEHUB_HEADLESS
+static lv_display_t *hal_init(int32_t w, int32_t h)
+{
+    lv_group_set_default(lv_group_create());
+    lv_display_t *disp = headless_display_create(w, h);
+    if (!disp) return NULL;
+    headless_input_create(lv_group_get_default());
+    return disp;
+}
+#else
 static lv_display_t *hal_init(int32_t w, int32_t h)
 {
     lv_group_set_default(lv_group_create());
@@ -51,3 +103,4 @@ static lv_display_t *hal_init(int32_t w, int32_t h)
     lv_indev_set_group(kb, lv_group_get_default());
     return disp;
 }
+#endif
@@ -1,7 +1,431 @@
-// TODO
-// App installation should be moved here
+#include "os_client.h"
+#include "badgehub_client.h"
+#include "blob_store.h"
+#include "utils.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-// This should also implement something to get a list of apps
-// This should also implement getting the app metadata of an installed app
-// This should also implement deleting apps
-// This should also implement display setup
\ No newline at end of file
+// --- CONSTANTS ---
+#define INDEX_DIR INSTALLATION_DIR "/.index"
+#define INDEX_PATH INDEX_DIR "/apps"
+#define INDEX_HEADER "badgehub-index 2"
+// Holds the generation of the last change to INSTALLATION_DIR. It is bumped before
+// an install is published or an app is trashed, and the index records the
+// generation it reflects, so an index that missed a change is known to be stale.
+#define GENERATION_PATH INDEX_DIR "/generation"
+// Uninstalled apps are renamed into here and deleted from there, so an app is
+// either fully installed or gone even if the deletion is interrupted.
+#define TRASH_DIR INSTALLATION_DIR "/.trash"
+// Synchronous uninstalls are renamed into here instead. The purge thread does not
+// look here, so it never deletes the tree the caller is deleting.
+#define DELETING_DIR INSTALLATION_DIR "/.deleting"
+#define MAX_LINE_LENGTH 512
+#define MIN_TABLE_SIZE 16
+
+// Format: "<header> <generation>", then one app per line:
+//   <revision> <file_count> <total_bytes> <slug>
+
+// --- STATIC STATE VARIABLES ---
+static installed_app_t *s_apps = NULL;
+static int s_count = 0;
+static int s_capacity = 0;
+// Open-addressing hash table of indices into s_apps, -1 for empty slots. Its size
+// is a power of two at least twice the number of apps.
+static int *s_table = NULL;
+static size_t s_table_size = 0;
+static uint64_t s_generation = 0; // Generation of INSTALLATION_DIR the index reflects
+
+static unsigned s_trash_serial = 0;
+// Background purge of TRASH_DIR and garbage collection of the blob store,
+// started on first use.
+static pthread_mutex_t s_purge_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_purge_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t s_purge_thread;
+static bool s_purge_started = false;
+static bool s_purge_requested = false;
+static bool s_gc_requested = false;
+static bool s_purge_stop = false;
+
+// --- IMPLEMENTATIONS ---
+
+// FNV-1a
+static uint64_t hash_slug(const char *slug) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const unsigned char *p = (const unsigned char *)slug; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Returns the table slot holding slug, or the empty slot where it would go.
+static size_t find_slot(const char *slug) {
+    size_t mask = s_table_size - 1;
+    size_t slot = (size_t)hash_slug(slug) & mask;
+    while (s_table[slot] >= 0 && strcmp(s_apps[s_table[slot]].slug, slug) != 0) slot = (slot + 1) & mask;
+    return slot;
+}
+
+static bool rebuild_table(void) {
+    size_t size = MIN_TABLE_SIZE;
+    while (size < (size_t)s_capacity * 2) size *= 2;
+    int *table = malloc(size * sizeof(int));
+    if (!table) return false;
+    free(s_table);
+    s_table = table;
+    s_table_size = size;
+    memset(s_table, 0xff, size * sizeof(int)); // All -1
+    for (int i = 0; i < s_count; i++) s_table[find_slot(s_apps[i].slug)] = i;
+    return true;
+}
+
+static void clear_apps(void) {
+    for (int i = 0; i < s_count; i++) free(s_apps[i].slug);
+    free(s_apps);
+    free(s_table);
+    s_apps = NULL;
+    s_table = NULL;
+    s_count = s_capacity = 0;
+    s_table_size = 0;
+}
+
+// Inserts or updates an app.
+static bool put_app(const char *slug, int revision, int file_count, uint64_t total_bytes) {
+    if (!s_table && !rebuild_table()) return false;
+    size_t slot = find_slot(slug);
+    installed_app_t *app;
+    if (s_table[slot] >= 0) {
+        app = &s_apps[s_table[slot]];
+    } else {
+        if (s_count == s_capacity) {
+            int capacity = s_capacity > 0 ? s_capacity * 2 : MIN_TABLE_SIZE;
+            installed_app_t *apps = realloc(s_apps, capacity * sizeof(installed_app_t));
+            if (!apps) return false;
+            s_apps = apps;
+            s_capacity = capacity;
+            if (!rebuild_table()) return false;
+            slot = find_slot(slug);
+        }
+        app = &s_apps[s_count];
+        app->slug = strdup(slug);
+        if (!app->slug) return false;
+        s_table[slot] = s_count++;
+    }
+    app->revision = revision;
+    app->file_count = file_count;
+    app->total_bytes = total_bytes;
+    return true;
+}
+
+// Uninstalls are rare, so the table is simply rebuilt after moving the last app into the gap.
+static void remove_app(const char *slug) {
+    if (!s_table) return;
+    int index = s_table[find_slot(slug)];
+    if (index < 0) return;
+    free(s_apps[index].slug);
+    s_apps[index] = s_apps[--s_count];
+    rebuild_table();
+}
+
+static void summarize_manifest(const install_manifest_t *manifest, int *file_count, uint64_t *total_bytes) {
+    *file_count = manifest ? manifest->count : 0;
+    *total_bytes = 0;
+    for (int i = 0; manifest && i < manifest->count; i++) *total_bytes += manifest->entries[i].size;
+}
+
+static bool is_valid_slug(const char *slug) {
+    return slug && slug[0] && slug[0] != '.' && !strchr(slug, '/');
+}
+
+static bool read_generation(uint64_t *generation) {
+    FILE *fp = fopen(GENERATION_PATH, "r");
+    if (!fp) return false;
+    bool ok = fscanf(fp, "%" SCNu64, generation) == 1;
+    fclose(fp);
+    return ok;
+}
+
+static bool put_generation(FILE *fp, void *context) {
+    return fprintf(fp, "%" PRIu64 "\n", *(const uint64_t *)context) > 0;
+}
+
+// Must be on disk before the change it announces.
+static bool write_generation(uint64_t generation) {
+    if (write_file_atomic(GENERATION_PATH, put_generation, &generation)) return true;
+    fprintf(stderr, "Failed to write %s\n", GENERATION_PATH);
+    return false;
+}
+
+static bool put_index(FILE *fp, void *context) {
+    (void)context;
+    fprintf(fp, "%s %" PRIu64 "\n", INDEX_HEADER, s_generation);
+    for (int i = 0; i < s_count; i++) {
+        fprintf(fp, "%d %d %" PRIu64 " %s\n", s_apps[i].revision, s_apps[i].file_count, s_apps[i].total_bytes,
+                s_apps[i].slug);
+    }
+    return true;
+}
+
+static bool save_index(void) {
+    if (write_file_atomic(INDEX_PATH, put_index, NULL)) return true;
+    fprintf(stderr, "Failed to write the installed apps index %s\n", INDEX_PATH);
+    return false;
+}
+
+static bool load_index(void) {
+    FILE *fp = fopen(INDEX_PATH, "r");
+    if (!fp) return false;
+    char line[MAX_LINE_LENGTH];
+    bool ok = fgets(line, sizeof(line), fp) && strncmp(line, INDEX_HEADER " ", strlen(INDEX_HEADER " ")) == 0 &&
+              sscanf(line + strlen(INDEX_HEADER " "), "%" SCNu64, &s_generation) == 1;
+    while (ok && fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        int revision = 0;
+        int file_count = 0;
+        uint64_t total_bytes = 0;
+        int slug_offset = 0;
+        ok = sscanf(line, "%d %d %" SCNu64 " %n", &revision, &file_count, &total_bytes, &slug_offset) == 3 &&
+             is_valid_slug(line + slug_offset) && put_app(line + slug_offset, revision, file_count, total_bytes);
+    }
+    fclose(fp);
+    if (!ok) {
+        fprintf(stderr, "Ignoring unreadable installed apps index %s\n", INDEX_PATH);
+        clear_apps();
+    }
+    return ok;
+}
+
+// The slow path: reads the manifest of every app directory.
+static bool rebuild_index(void) {
+    DIR *dir = opendir(INSTALLATION_DIR);
+    if (!dir) return true; // Nothing installed yet
+    bool ok = true;
+    struct dirent *entry;
+    while (ok && (entry = readdir(dir)) != NULL) {
+        if (!is_valid_slug(entry->d_name)) continue; // Also skips the staging areas and the blob store
+        char app_dir[512];
+        struct stat st;
+        snprintf(app_dir, sizeof(app_dir), "%s/%s", INSTALLATION_DIR, entry->d_name);
+        if (stat(app_dir, &st) != 0 || !S_ISDIR(st.st_mode)) continue;
+        install_manifest_t *manifest = install_manifest_load(app_dir);
+        int file_count;
+        uint64_t total_bytes;
+        summarize_manifest(manifest, &file_count, &total_bytes);
+        ok = put_app(entry->d_name, manifest ? manifest->revision : 0, file_count, total_bytes);
+        install_manifest_free(manifest);
+    }
+    closedir(dir);
+    return ok;
+}
+
+// Renames path to a unique name in dir, from where it can be deleted at leisure.
+static bool move_to(const char *path, const char *dir, const char *name, char *moved, size_t moved_size) {
+    snprintf(moved, moved_size, "%s/%s.%ld.%u", dir, name, (long)time(NULL), s_trash_serial++);
+    ensure_dir_exists(moved);
+    if (rename(path, moved) == 0) return true;
+    fprintf(stderr, "Failed to move %s to the trash\n", path);
+    return false;
+}
+
+// Deletes a trashed app. Runs on the purge thread as well as the caller's; the
+// blobs only the app used are collected afterwards.
+static bool purge_trashed_app(const char *path) {
+    bool ok = remove_tree(path);
+    if (!ok) fprintf(stderr, "Failed to delete %s\n", path);
+    return ok;
+}
+
+static void purge_trash(void) {
+    DIR *trash = opendir(TRASH_DIR);
+    if (!trash) return;
+    struct dirent *entry;
+    while ((entry = readdir(trash)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", TRASH_DIR, entry->d_name);
+        purge_trashed_app(path);
+    }
+    closedir(trash);
+}
+
+// Hands deletions a crash interrupted in DELETING_DIR over to the purge thread.
+static void trash_interrupted_deletions(void) {
+    DIR *deleting = opendir(DELETING_DIR);
+    if (!deleting) return;
+    struct dirent *entry;
+    while ((entry = readdir(deleting)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        char path[512];
+        char trash_path[512];
+        snprintf(path, sizeof(path), "%s/%s", DELETING_DIR, entry->d_name);
+        snprintf(trash_path, sizeof(trash_path), "%s/%s", TRASH_DIR, entry->d_name);
+        ensure_dir_exists(trash_path);
+        if (rename(path, trash_path) != 0) fprintf(stderr, "Failed to move %s to the trash\n", path);
+    }
+    closedir(deleting);
+}
+
+static bool trash_is_empty(void) {
+    DIR *trash = opendir(TRASH_DIR);
+    if (!trash) return true;
+    struct dirent *entry;
+    bool empty = true;
+    while (empty && (entry = readdir(trash)) != NULL) {
+        empty = strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0;
+    }
+    closedir(trash);
+    return empty;
+}
+
+static void *purge_thread_main(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&s_purge_lock);
+    while (!s_purge_stop) {
+        if (!s_purge_requested && !s_gc_requested) {
+            pthread_cond_wait(&s_purge_cond, &s_purge_lock);
+            continue;
+        }
+        bool purge = s_purge_requested;
+        bool gc = s_gc_requested;
+        s_purge_requested = s_gc_requested = false;
+        pthread_mutex_unlock(&s_purge_lock);
+        if (purge) purge_trash();
+        if (gc) blob_store_gc();
+        pthread_mutex_lock(&s_purge_lock);
+    }
+    pthread_mutex_unlock(&s_purge_lock);
+    return NULL;
+}
+
+// Wakes the purge thread, starting it if needed, to purge the trash and/or collect
+// the blob store's garbage. Without a thread, does the work right away.
+static void wake_purge_thread(bool purge, bool gc) {
+    pthread_mutex_lock(&s_purge_lock);
+    if (!s_purge_started) s_purge_started = pthread_create(&s_purge_thread, NULL, purge_thread_main, NULL) == 0;
+    bool started = s_purge_started;
+    if (started) {
+        s_purge_requested = s_purge_requested || purge;
+        s_gc_requested = s_gc_requested || gc;
+        pthread_cond_signal(&s_purge_cond);
+    }
+    pthread_mutex_unlock(&s_purge_lock);
+    if (started) return;
+    if (purge) purge_trash();
+    if (gc) blob_store_gc();
+}
+
+static void stop_purge_thread(void) {
+    pthread_mutex_lock(&s_purge_lock);
+    bool started = s_purge_started;
+    s_purge_stop = true;
+    pthread_cond_signal(&s_purge_cond);
+    pthread_mutex_unlock(&s_purge_lock);
+    if (started) pthread_join(s_purge_thread, NULL);
+    s_purge_started = false;
+    s_purge_requested = false;
+    s_gc_requested = false;
+    s_purge_stop = false;
+}
+
+bool os_client_init(void) {
+    clear_apps();
+    uint64_t generation = 0;
+    bool have_generation = read_generation(&generation);
+    // Finish deletions a previous run did not get to, and drop blobs a crash kept
+    // from being released, off the startup path.
+    trash_interrupted_deletions();
+    wake_purge_thread(!trash_is_empty(), true);
+    if (load_index() && have_generation && s_generation == generation) return true;
+
+    printf("Rebuilding the installed apps index\n");
+    clear_apps();
+    if (!rebuild_index()) {
+        clear_apps();
+        return false;
+    }
+    // A generation of its own, so neither file can match a stale copy of the other.
+    s_generation = (generation > s_generation ? generation : s_generation) + 1;
+    if (write_generation(s_generation)) save_index();
+    return true;
+}
+
+bool os_client_discard(const char *path) {
+    char trash_path[512];
+    const char *name = strrchr(path, '/');
+    if (!move_to(path, TRASH_DIR, name ? name + 1 : path, trash_path, sizeof(trash_path))) return false;
+    wake_purge_thread(true, true);
+    return true;
+}
+
+bool os_client_begin_change(void) {
+    return write_generation(++s_generation);
+}
+
+void os_client_deinit(void) {
+    stop_purge_thread();
+    clear_apps();
+}
+
+const installed_app_t *os_client_find(const char *slug) {
+    if (!slug || !s_table) return NULL;
+    int index = s_table[find_slot(slug)];
+    return index >= 0 ? &s_apps[index] : NULL;
+}
+
+int os_client_count(void) {
+    return s_count;
+}
+
+const installed_app_t *os_client_get(int index) {
+    return index >= 0 && index < s_count ? &s_apps[index] : NULL;
+}
+
+install_manifest_t *os_client_load_files(const char *slug) {
+    if (!is_valid_slug(slug)) return NULL;
+    char app_dir[512];
+    snprintf(app_dir, sizeof(app_dir), "%s/%s", INSTALLATION_DIR, slug);
+    return install_manifest_load(app_dir);
+}
+
+bool os_client_record_install(const char *slug, const install_manifest_t *manifest) {
+    if (!is_valid_slug(slug) || !manifest) return false;
+    int file_count;
+    uint64_t total_bytes;
+    summarize_manifest(manifest, &file_count, &total_bytes);
+    if (!put_app(slug, manifest->revision, file_count, total_bytes)) return false;
+    return save_index();
+}
+
+bool os_client_delete_app(const char *slug, bool in_background) {
+    if (!is_valid_slug(slug)) return false;
+    char app_dir[512];
+    char trash_path[512];
+    struct stat st;
+    snprintf(app_dir, sizeof(app_dir), "%s/%s", INSTALLATION_DIR, slug);
+    if (stat(app_dir, &st) != 0) {
+        // Already gone, e.g. deleted by hand: only the index needs fixing.
+        remove_app(slug);
+        save_index();
+        return false;
+    }
+    if (!os_client_begin_change() ||
+        !move_to(app_dir, in_background ? TRASH_DIR : DELETING_DIR, slug, trash_path, sizeof(trash_path))) {
+        return false;
+    }
+    remove_app(slug);
+    save_index();
+    if (in_background) {
+        wake_purge_thread(true, true);
+        return true;
+    }
+    bool ok = purge_trashed_app(trash_path);
+    wake_purge_thread(false, true);
+    return ok;
+}
@@ -0,0 +1,112 @@
+#ifndef OS_CLIENT_H
+#define OS_CLIENT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "install_manifest.h"
+
+// An installed app as recorded in the index. The file list itself stays in the
+// app's install manifest; see os_client_load_files().
+typedef struct {
+    char *slug;
+    int revision;          // 0 if the app has no install manifest
+    int file_count;
+    uint64_t total_bytes;
+} installed_app_t;
+
+/**
+ * @brief Loads the index of installed apps. Call once at startup, after
+ * install_manager_init().
+ *
+ * The index is a small file next to the apps, rewritten atomically whenever an
+ * install or uninstall completes. It records a generation counter that
+ * os_client_begin_change() bumps before each change to INSTALLATION_DIR; if the
+ * two disagree (a crash mid-change), or the index cannot be read, it is rebuilt
+ * from the apps' install manifests. Apps copied in by hand are picked up once
+ * INSTALLATION_DIR/.index is deleted.
+ *
+ * Leftovers of interrupted uninstalls are deleted, and the blob store's garbage
+ * collected, on a background thread, so neither delays startup.
+ *
+ * @return false if the index could neither be loaded nor rebuilt.
+ */
+bool os_client_init(void);
+
+/**
+ * @brief Looks up an installed app in constant time.
+ *
+ * @return The app, or NULL if it is not installed. Valid until the next call
+ *         that changes the index.
+ */
+const installed_app_t *os_client_find(const char *slug);
+
+/**
+ * @brief Returns the number of installed apps, for enumeration with os_client_get().
+ */
+int os_client_count(void);
+
+/**
+ * @brief Returns the installed app at index, 0 <= index < os_client_count(), in no
+ * particular order. Valid until the next call that changes the index.
+ */
+const installed_app_t *os_client_get(int index);
+
+/**
+ * @brief Reads the list of files, with sizes and hashes, of an installed app.
+ *
+ * @return The app's install manifest (free with install_manifest_free()), or NULL.
+ */
+install_manifest_t *os_client_load_files(const char *slug);
+
+/**
+ * @brief Announces a change to INSTALLATION_DIR that the index does not reflect
+ * yet. Called right before an install is published; uninstalls call it themselves.
+ *
+ * Until the next os_client_record_install() or os_client_delete_app() rewrites
+ * the index, a restart rebuilds it.
+ *
+ * @return false if the change could not be recorded; it must not be made then.
+ */
+bool os_client_begin_change(void);
+
+/**
+ * @brief Moves a directory inside INSTALLATION_DIR, such as the tree an update
+ * replaced, into the trash and has the background thread delete it and collect
+ * the blobs only it used.
+ *
+ * @return false if the directory could not be moved; it is left in place then.
+ */
+bool os_client_discard(const char *path);
+
+/**
+ * @brief Records a completed install. Called by the install manager once the
+ * app's files are published.
+ *
+ * @return false if the index could not be written; the in-memory index is
+ *         updated regardless and the next os_client_init() rebuilds the file.
+ */
+bool os_client_record_install(const char *slug, const install_manifest_t *manifest);
+
+/**
+ * @brief Uninstalls an app and removes it from the index.
+ *
+ * The app's directory is first renamed into a trash directory, so it vanishes
+ * at once and a deletion cut short by a crash is finished by the next
+ * os_client_init() instead of leaving half an app behind. The tree is then
+ * deleted through directory file descriptors (see remove_tree_at()), and the
+ * blobs only the app used are collected. Must not be called while
+ * the app is being installed.
+ *
+ * @param in_background Return right after the rename and leave the deletion to a
+ *                      background thread, so the UI does not wait for it.
+ * @return false if the app is not installed or could not be removed completely.
+ */
+bool os_client_delete_app(const char *slug, bool in_background);
+
+/**
+ * @brief Stops the background deletion thread, after it finishes the app it is
+ * deleting, and frees the in-memory index.
+ */
+void os_client_deinit(void);
+
+#endif // OS_CLIENT_H
@@ -0,0 +1,125 @@
+#include "page_cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+// --- STATIC STATE VARIABLES ---
+static page_cache_entry_t *s_mru = NULL; // Most recently used
+static page_cache_entry_t *s_lru = NULL; // Least recently used
+static int s_count = 0;
+
+// --- IMPLEMENTATIONS ---
+
+static void unlink_entry(page_cache_entry_t *entry) {
+    if (entry->prev) entry->prev->next = entry->next;
+    else s_mru = entry->next;
+    if (entry->next) entry->next->prev = entry->prev;
+    else s_lru = entry->prev;
+    entry->prev = entry->next = NULL;
+    s_count--;
+}
+
+static void push_mru(page_cache_entry_t *entry) {
+    entry->prev = NULL;
+    entry->next = s_mru;
+    if (s_mru) s_mru->prev = entry;
+    s_mru = entry;
+    if (!s_lru) s_lru = entry;
+    s_count++;
+}
+
+static void destroy_entry(page_cache_entry_t *entry) {
+    free_applications(entry->projects, entry->project_count);
+    free(entry->query);
+    free(entry);
+}
+
+// Pinned pages stay alive after being unlinked; page_cache_release() frees them.
+static void drop_entry(page_cache_entry_t *entry) {
+    unlink_entry(entry);
+    if (entry->ref_count == 0) {
+        destroy_entry(entry);
+    }
+}
+
+static bool is_expired(const page_cache_entry_t *entry) {
+    return time(NULL) - entry->fetched_at > PAGE_CACHE_TTL_SECONDS;
+}
+
+static page_cache_entry_t *find_entry(const char *query, int offset, int limit) {
+    if (!query) query = "";
+    for (page_cache_entry_t *entry = s_mru; entry; entry = entry->next) {
+        if (entry->offset == offset && entry->limit == limit && strcmp(entry->query, query) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+page_cache_entry_t *page_cache_acquire(const char *query, int offset, int limit) {
+    page_cache_entry_t *entry = find_entry(query, offset, limit);
+    if (!entry) return NULL;
+    if (is_expired(entry)) {
+        drop_entry(entry);
+        return NULL;
+    }
+    unlink_entry(entry);
+    push_mru(entry);
+    entry->ref_count++;
+    return entry;
+}
+
+bool page_cache_contains(const char *query, int offset, int limit) {
+    page_cache_entry_t *entry = find_entry(query, offset, limit);
+    return entry && !is_expired(entry);
+}
+
+page_cache_entry_t *page_cache_insert(const char *query, int offset, int limit, project_t *projects, int project_count) {
+    if (!query) query = "";
+    page_cache_entry_t *entry = calloc(1, sizeof(page_cache_entry_t));
+    if (entry) entry->query = strdup(query);
+    if (!entry || !entry->query) {
+        free(entry);
+        free_applications(projects, project_count);
+        return NULL;
+    }
+    entry->offset = offset;
+    entry->limit = limit;
+    entry->projects = projects;
+    entry->project_count = project_count;
+    entry->fetched_at = time(NULL);
+    entry->ref_count = 1;
+
+    page_cache_entry_t *old = find_entry(query, offset, limit);
+    if (old) drop_entry(old);
+
+    page_cache_entry_t *victim = s_lru;
+    while (victim && s_count >= PAGE_CACHE_CAPACITY) {
+        page_cache_entry_t *prev = victim->prev;
+        if (victim->ref_count == 0) drop_entry(victim);
+        victim = prev;
+    }
+    push_mru(entry);
+    return entry;
+}
+
+void page_cache_release(page_cache_entry_t *entry) {
+    if (!entry || entry->ref_count == 0) return;
+    entry->ref_count--;
+    if (entry->ref_count > 0) return;
+
+    // Entries replaced or expired while pinned are no longer linked in the list.
+    bool linked = false;
+    for (page_cache_entry_t *e = s_mru; e; e = e->next) {
+        if (e == entry) { linked = true; break; }
+    }
+    if (!linked) destroy_entry(entry);
+}
+
+void page_cache_clear(void) {
+    page_cache_entry_t *entry = s_mru;
+    while (entry) {
+        page_cache_entry_t *next = entry->next;
+        if (entry->ref_count == 0) drop_entry(entry);
+        entry = next;
+    }
+}
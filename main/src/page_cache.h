@@ -0,0 +1,59 @@
+#ifndef PAGE_CACHE_H
+#define PAGE_CACHE_H
+
+#include <stdbool.h>
+#include <time.h>
+#include "badgehub_client.h"
+
+// Maximum number of pages kept in memory.
+#define PAGE_CACHE_CAPACITY 8
+// Pages older than this are refetched instead of being served from memory.
+#define PAGE_CACHE_TTL_SECONDS 300
+
+// A page of /project-summaries results. Fields are read-only for users of the cache.
+typedef struct page_cache_entry {
+    char *query;
+    int offset;
+    int limit;
+    project_t *projects;
+    int project_count;
+    time_t fetched_at;
+    int ref_count;
+    struct page_cache_entry *prev; // Towards the most recently used end
+    struct page_cache_entry *next; // Towards the least recently used end
+} page_cache_entry_t;
+
+/**
+ * @brief Looks up a page by (search query, offset, page length) and pins it.
+ *
+ * @return The cached page, or NULL on a miss or if the page expired.
+ *         Release it with page_cache_release().
+ */
+page_cache_entry_t *page_cache_acquire(const char *query, int offset, int limit);
+
+/**
+ * @brief Returns true if a fresh copy of the page is cached, without pinning it.
+ */
+bool page_cache_contains(const char *query, int offset, int limit);
+
+/**
+ * @brief Stores a fetched page, replacing any older copy, and pins it.
+ *
+ * Takes ownership of the projects array. The least recently used unpinned
+ * page is evicted when the cache is full.
+ *
+ * @return The new entry, or NULL on allocation failure (the projects are freed).
+ */
+page_cache_entry_t *page_cache_insert(const char *query, int offset, int limit, project_t *projects, int project_count);
+
+/**
+ * @brief Unpins a page returned by page_cache_acquire() or page_cache_insert().
+ */
+void page_cache_release(page_cache_entry_t *entry);
+
+/**
+ * @brief Drops every unpinned page.
+ */
+void page_cache_clear(void);
+
+#endif // PAGE_CACHE_H
@@ -0,0 +1,290 @@
+#include "project_parser.h"
+#include "json_stream.h"
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct project_list_parser {
+    json_stream_t stream;
+    arena_t *arena;     // Holds every string of the page and, once finished, the project array
+    char *empty;        // Shared "" for missing fields
+    project_t *projects; // Grows while parsing; copied into the arena by finish
+    int count;
+    int capacity;
+    bool root_is_array;
+    bool in_icon_map;   // Inside the current project's "icon_map" object
+    bool in_icon_64;    // Inside icon_map's "64x64" object
+    bool saw_icon_64;
+    bool failed;        // Out of memory while building
+};
+
+struct project_details_parser {
+    json_stream_t stream;
+    arena_t *arena;
+    char *empty;
+    project_detail_t *details; // Allocated from the arena as its root
+    project_file_t *files;     // Grows while parsing; copied into the arena by finish
+    int file_capacity;
+    bool saw_version;
+    bool in_version;
+    bool in_metadata;
+    bool saw_metadata;
+    bool in_files;
+    bool failed;
+};
+
+// --- IMPLEMENTATIONS ---
+
+// Keeps the first occurrence of a field, like cJSON_GetObjectItemCaseSensitive() did.
+static bool set_field(arena_t *arena, char **field, const json_stream_event_t *event) {
+    if (*field || event->type != JSON_EVENT_STRING) return true;
+    *field = arena_strdup(arena, event->value);
+    return *field != NULL;
+}
+
+// Fields that were absent or not strings read as "", matching get_json_string().
+static void default_field(char **field, char *empty) {
+    if (!*field) *field = empty;
+}
+
+static bool is_start(const json_stream_event_t *event) {
+    return event->type == JSON_EVENT_OBJECT_START || event->type == JSON_EVENT_ARRAY_START;
+}
+
+static bool is_end(const json_stream_event_t *event) {
+    return event->type == JSON_EVENT_OBJECT_END || event->type == JSON_EVENT_ARRAY_END;
+}
+
+static void finish_project(project_list_parser_t *parser) {
+    project_t *project = &parser->projects[parser->count - 1];
+    default_field(&project->name, parser->empty);
+    default_field(&project->slug, parser->empty);
+    default_field(&project->description, parser->empty);
+    default_field(&project->project_url, parser->empty);
+    // Without a 64x64 entry in icon_map there is no icon URL at all.
+    if (parser->saw_icon_64) default_field(&project->icon_url, parser->empty);
+}
+
+static bool handle_project_event(project_list_parser_t *parser, const json_stream_event_t *event) {
+    if (event->depth == 0) {
+        if (event->type == JSON_EVENT_ARRAY_START) parser->root_is_array = true;
+        return true;
+    }
+    if (event->depth == 1) {
+        if (is_end(event)) {
+            finish_project(parser);
+            return true;
+        }
+        // Every element of the root array is a project, whatever its type.
+        if (parser->count == parser->capacity) {
+            int capacity = parser->capacity ? parser->capacity * 2 : 8;
+            project_t *grown = realloc(parser->projects, capacity * sizeof(project_t));
+            if (!grown) return false;
+            parser->projects = grown;
+            parser->capacity = capacity;
+        }
+        memset(&parser->projects[parser->count++], 0, sizeof(project_t));
+        parser->in_icon_map = parser->in_icon_64 = parser->saw_icon_64 = false;
+        if (!is_start(event)) finish_project(parser);
+        return true;
+    }
+
+    project_t *project = &parser->projects[parser->count - 1];
+    if (event->depth == 2 && event->key) {
+        if (strcmp(event->key, "icon_map") == 0) {
+            parser->in_icon_map = event->type == JSON_EVENT_OBJECT_START;
+            return true;
+        }
+        if (strcmp(event->key, "name") == 0) return set_field(parser->arena, &project->name, event);
+        if (strcmp(event->key, "slug") == 0) return set_field(parser->arena, &project->slug, event);
+        if (strcmp(event->key, "description") == 0) return set_field(parser->arena, &project->description, event);
+        if (strcmp(event->key, "project_url") == 0) return set_field(parser->arena, &project->project_url, event);
+        if (strcmp(event->key, "revision") == 0 && event->type == JSON_EVENT_NUMBER) {
+            project->revision = (int)strtod(event->value, NULL);
+        }
+        return true;
+    }
+    if (event->depth == 3 && parser->in_icon_map && event->key && strcmp(event->key, "64x64") == 0) {
+        if (!is_end(event)) parser->saw_icon_64 = true;
+        parser->in_icon_64 = event->type == JSON_EVENT_OBJECT_START;
+        return true;
+    }
+    if (event->depth == 4 && parser->in_icon_64 && event->key && strcmp(event->key, "url") == 0) {
+        return set_field(parser->arena, &project->icon_url, event);
+    }
+    return true;
+}
+
+static void project_event_cb(const json_stream_event_t *event, void *user_data) {
+    project_list_parser_t *parser = user_data;
+    if (parser->failed) return;
+    if (!handle_project_event(parser, event)) parser->failed = true;
+}
+
+project_list_parser_t *project_list_parser_create(void) {
+    project_list_parser_t *parser = calloc(1, sizeof(project_list_parser_t));
+    if (!parser) return NULL;
+    parser->arena = arena_create(ARENA_DEFAULT_BLOCK_SIZE);
+    parser->empty = arena_strdup(parser->arena, "");
+    if (!parser->empty) {
+        arena_destroy(parser->arena);
+        free(parser);
+        return NULL;
+    }
+    json_stream_init(&parser->stream, project_event_cb, parser);
+    return parser;
+}
+
+bool project_list_parser_feed(project_list_parser_t *parser, const char *data, size_t length) {
+    return json_stream_feed(&parser->stream, data, length) && !parser->failed;
+}
+
+size_t project_list_parser_write_cb(void *contents, size_t size, size_t nmemb, void *userp) {
+    size_t realsize = size * nmemb;
+    return project_list_parser_feed(userp, contents, realsize) ? realsize : 0;
+}
+
+project_t *project_list_parser_finish(project_list_parser_t *parser, int *project_count) {
+    *project_count = 0;
+    if (!parser) return NULL;
+    project_t *projects = NULL;
+    if (json_stream_finish(&parser->stream) && !parser->failed && parser->root_is_array) {
+        // The array becomes the arena's root: free_applications() releases the whole page through it.
+        projects = arena_alloc_root(parser->arena, parser->count * sizeof(project_t));
+        if (projects) {
+            if (parser->count > 0) memcpy(projects, parser->projects, parser->count * sizeof(project_t));
+            *project_count = parser->count;
+            parser->arena = NULL;
+        }
+    }
+    project_list_parser_abort(parser);
+    return projects;
+}
+
+void project_list_parser_abort(project_list_parser_t *parser) {
+    if (!parser) return;
+    arena_destroy(parser->arena);
+    free(parser->projects);
+    json_stream_free(&parser->stream);
+    free(parser);
+}
+
+// --- PROJECT DETAILS ---
+
+static bool handle_details_event(project_details_parser_t *parser, const json_stream_event_t *event) {
+    project_detail_t *details = parser->details;
+    if (event->depth == 1 && event->key && strcmp(event->key, "version") == 0) {
+        if (!is_end(event)) parser->saw_version = true;
+        parser->in_version = event->type == JSON_EVENT_OBJECT_START;
+        return true;
+    }
+    if (!parser->in_version) return true;
+
+    if (event->depth == 2 && event->key) {
+        if (strcmp(event->key, "app_metadata") == 0) {
+            if (!is_end(event)) parser->saw_metadata = true;
+            parser->in_metadata = event->type == JSON_EVENT_OBJECT_START;
+        } else if (strcmp(event->key, "files") == 0) {
+            parser->in_files = event->type == JSON_EVENT_ARRAY_START;
+        } else if (strcmp(event->key, "published_at") == 0) {
+            return set_field(parser->arena, &details->published_at, event);
+        }
+        return true;
+    }
+    if (event->depth == 3 && parser->in_metadata && event->key) {
+        if (strcmp(event->key, "name") == 0) return set_field(parser->arena, &details->name, event);
+        if (strcmp(event->key, "description") == 0) return set_field(parser->arena, &details->description, event);
+        if (strcmp(event->key, "author") == 0) return set_field(parser->arena, &details->author, event);
+        if (strcmp(event->key, "version") == 0) return set_field(parser->arena, &details->version, event);
+        return true;
+    }
+    if (event->depth == 3 && parser->in_files) {
+        if (!is_end(event)) {
+            if (details->file_count == parser->file_capacity) {
+                int capacity = parser->file_capacity ? parser->file_capacity * 2 : 8;
+                project_file_t *grown = realloc(parser->files, capacity * sizeof(project_file_t));
+                if (!grown) return false;
+                parser->files = grown;
+                parser->file_capacity = capacity;
+            }
+            memset(&parser->files[details->file_count++], 0, sizeof(project_file_t));
+            if (is_start(event)) return true;
+        }
+        project_file_t *file = &parser->files[details->file_count - 1];
+        default_field(&file->full_path, parser->empty);
+        default_field(&file->sha256, parser->empty);
+        default_field(&file->url, parser->empty);
+        return true;
+    }
+    if (event->depth == 4 && parser->in_files && event->key) {
+        project_file_t *file = &parser->files[details->file_count - 1];
+        if (strcmp(event->key, "full_path") == 0) return set_field(parser->arena, &file->full_path, event);
+        if (strcmp(event->key, "sha256") == 0) return set_field(parser->arena, &file->sha256, event);
+        if (strcmp(event->key, "url") == 0) return set_field(parser->arena, &file->url, event);
+    }
+    return true;
+}
+
+static void details_event_cb(const json_stream_event_t *event, void *user_data) {
+    project_details_parser_t *parser = user_data;
+    if (parser->failed) return;
+    if (!handle_details_event(parser, event)) parser->failed = true;
+}
+
+project_details_parser_t *project_details_parser_create(const char *slug, int revision) {
+    if (!slug) return NULL;
+    project_details_parser_t *parser = calloc(1, sizeof(project_details_parser_t));
+    if (!parser) return NULL;
+    parser->arena = arena_create(ARENA_DEFAULT_BLOCK_SIZE);
+    parser->empty = arena_strdup(parser->arena, "");
+    parser->details = arena_alloc_root(parser->arena, sizeof(project_detail_t));
+    if (parser->details) parser->details->slug = arena_strdup(parser->arena, slug);
+    if (!parser->empty || !parser->details || !parser->details->slug) {
+        arena_destroy(parser->arena);
+        free(parser);
+        return NULL;
+    }
+    parser->details->revision = revision;
+    json_stream_init(&parser->stream, details_event_cb, parser);
+    return parser;
+}
+
+bool project_details_parser_feed(project_details_parser_t *parser, const char *data, size_t length) {
+    return json_stream_feed(&parser->stream, data, length) && !parser->failed;
+}
+
+size_t project_details_parser_write_cb(void *contents, size_t size, size_t nmemb, void *userp) {
+    size_t realsize = size * nmemb;
+    return project_details_parser_feed(userp, contents, realsize) ? realsize : 0;
+}
+
+project_detail_t *project_details_parser_finish(project_details_parser_t *parser) {
+    if (!parser) return NULL;
+    project_detail_t *details = NULL;
+    if (json_stream_finish(&parser->stream) && !parser->failed) {
+        details = parser->details;
+        if (parser->saw_version) default_field(&details->published_at, parser->empty);
+        if (parser->saw_metadata) {
+            default_field(&details->name, parser->empty);
+            default_field(&details->description, parser->empty);
+            default_field(&details->author, parser->empty);
+            default_field(&details->version, parser->empty);
+        }
+        if (details->file_count > 0) {
+            details->files = arena_alloc(parser->arena, details->file_count * sizeof(project_file_t));
+            if (details->files) memcpy(details->files, parser->files, details->file_count * sizeof(project_file_t));
+        }
+        if (details->file_count == 0 || details->files) parser->arena = NULL;
+        else details = NULL;
+    }
+    project_details_parser_abort(parser);
+    return details;
+}
+
+void project_details_parser_abort(project_details_parser_t *parser) {
+    if (!parser) return;
+    arena_destroy(parser->arena);
+    free(parser->files);
+    json_stream_free(&parser->stream);
+    free(parser);
+}
@@ -0,0 +1,82 @@
+#ifndef PROJECT_PARSER_H
+#define PROJECT_PARSER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "badgehub_client.h"
+
+typedef struct project_list_parser project_list_parser_t;
+typedef struct project_details_parser project_details_parser_t;
+
+/**
+ * @brief Creates a parser that builds project_t entries from a /project-summaries
+ * response while it is being received.
+ *
+ * Feed it with project_list_parser_feed(), or hand it to curl directly as the
+ * CURLOPT_WRITEDATA of project_list_parser_write_cb().
+ *
+ * @return The parser, or NULL on allocation failure.
+ */
+project_list_parser_t *project_list_parser_create(void);
+
+/**
+ * @brief Feeds the next chunk of the response body.
+ *
+ * @return false once the body is known to be malformed.
+ */
+bool project_list_parser_feed(project_list_parser_t *parser, const char *data, size_t length);
+
+/**
+ * @brief libcurl write callback feeding a project_list_parser_t. Aborts the
+ * transfer as soon as the body turns out to be malformed.
+ */
+size_t project_list_parser_write_cb(void *contents, size_t size, size_t nmemb, void *userp);
+
+/**
+ * @brief Completes parsing and destroys the parser.
+ *
+ * @param project_count Populated with the number of projects returned.
+ * @return The projects (free with free_applications()), or NULL if the body was
+ *         not a complete JSON array.
+ */
+project_t *project_list_parser_finish(project_list_parser_t *parser, int *project_count);
+
+/**
+ * @brief Destroys the parser and everything it has built so far.
+ */
+void project_list_parser_abort(project_list_parser_t *parser);
+
+/**
+ * @brief Creates a parser that builds a project_detail_t from a /projects/<slug>/rev<n>
+ * response while it is being received.
+ *
+ * @return The parser, or NULL on allocation failure.
+ */
+project_details_parser_t *project_details_parser_create(const char *slug, int revision);
+
+/**
+ * @brief Feeds the next chunk of the response body.
+ *
+ * @return false once the body is known to be malformed.
+ */
+bool project_details_parser_feed(project_details_parser_t *parser, const char *data, size_t length);
+
+/**
+ * @brief libcurl write callback feeding a project_details_parser_t.
+ */
+size_t project_details_parser_write_cb(void *contents, size_t size, size_t nmemb, void *userp);
+
+/**
+ * @brief Completes parsing and destroys the parser.
+ *
+ * @return The details (free with free_project_details()), or NULL if the body
+ *         was not a complete JSON document.
+ */
+project_detail_t *project_details_parser_finish(project_details_parser_t *parser);
+
+/**
+ * @brief Destroys the parser and everything it has built so far.
+ */
+void project_details_parser_abort(project_details_parser_t *parser);
+
+#endif // PROJECT_PARSER_H
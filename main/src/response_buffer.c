@@ -0,0 +1,114 @@
+#include "response_buffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- STATIC STATE VARIABLES ---
+static response_buffer_t *s_pool[RESPONSE_BUFFER_POOL_SIZE];
+static int s_pool_count = 0;
+
+// --- IMPLEMENTATIONS ---
+
+response_buffer_t *response_buffer_acquire(size_t max_size) {
+    response_buffer_t *buffer = s_pool_count > 0 ? s_pool[--s_pool_count] : calloc(1, sizeof(response_buffer_t));
+    if (!buffer) return NULL;
+    buffer->max_size = max_size;
+    return buffer;
+}
+
+void response_buffer_release(response_buffer_t *buffer) {
+    if (!buffer) return;
+    if (buffer->capacity > RESPONSE_BUFFER_RETAIN_LIMIT) {
+        free(buffer->data);
+        buffer->data = NULL;
+        buffer->capacity = 0;
+    }
+    buffer->size = 0;
+    buffer->handle = NULL;
+    buffer->presized = false;
+    if (buffer->data) buffer->data[0] = '\0';
+
+    if (s_pool_count < RESPONSE_BUFFER_POOL_SIZE) {
+        s_pool[s_pool_count++] = buffer;
+    } else {
+        free(buffer->data);
+        free(buffer);
+    }
+}
+
+void response_buffer_pool_clear(void) {
+    while (s_pool_count > 0) {
+        response_buffer_t *buffer = s_pool[--s_pool_count];
+        free(buffer->data);
+        free(buffer);
+    }
+}
+
+void response_buffer_attach(response_buffer_t *buffer, CURL *handle) {
+    buffer->handle = handle;
+    buffer->presized = false;
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, response_buffer_write_cb);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, (void *)buffer);
+}
+
+bool response_buffer_reserve(response_buffer_t *buffer, size_t capacity) {
+    if (buffer->max_size && capacity > buffer->max_size) return false;
+    capacity++; // Room for the terminating NUL
+    if (capacity <= buffer->capacity) return true;
+    char *grown = realloc(buffer->data, capacity);
+    if (!grown) return false;
+    if (!buffer->data) grown[0] = '\0';
+    buffer->data = grown;
+    buffer->capacity = capacity;
+    return true;
+}
+
+bool response_buffer_append(response_buffer_t *buffer, const void *data, size_t length) {
+    size_t needed = buffer->size + length;
+    if (buffer->max_size && needed > buffer->max_size) return false;
+    if (needed + 1 > buffer->capacity) {
+        // Double, so a body of unknown length costs O(log n) reallocations.
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : RESPONSE_BUFFER_INITIAL_CAPACITY;
+        while (capacity < needed + 1) capacity *= 2;
+        if (buffer->max_size && capacity > buffer->max_size + 1) capacity = buffer->max_size + 1;
+        if (!response_buffer_reserve(buffer, capacity - 1)) return false;
+    }
+    memcpy(buffer->data + buffer->size, data, length);
+    buffer->size = needed;
+    buffer->data[needed] = '\0';
+    return true;
+}
+
+size_t response_buffer_write_cb(void *contents, size_t size, size_t nmemb, void *userp) {
+    size_t realsize = size * nmemb;
+    response_buffer_t *buffer = (response_buffer_t *)userp;
+    if (!buffer->presized && buffer->handle) {
+        buffer->presized = true;
+        curl_off_t content_length = -1;
+        if (curl_easy_getinfo(buffer->handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length) == CURLE_OK &&
+            content_length > 0) {
+            if (buffer->max_size && (curl_off_t)buffer->max_size < content_length) {
+                fprintf(stderr, "Response of %ld bytes exceeds the limit of %zu\n", (long)content_length, buffer->max_size);
+                return 0;
+            }
+            // A failed presize is not fatal; the buffer still grows on demand.
+            response_buffer_reserve(buffer, (size_t)content_length);
+        }
+    }
+    if (!response_buffer_append(buffer, contents, realsize)) {
+        fprintf(stderr, "Failed to buffer response (%zu bytes so far)\n", buffer->size);
+        return 0;
+    }
+    return realsize;
+}
+
+char *response_buffer_detach(response_buffer_t *buffer, size_t *size) {
+    char *data = buffer->size > 0 ? buffer->data : NULL;
+    if (size) *size = data ? buffer->size : 0;
+    if (data) {
+        buffer->data = NULL;
+        buffer->capacity = 0;
+        buffer->size = 0;
+    }
+    return data;
+}
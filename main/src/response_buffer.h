@@ -0,0 +1,80 @@
+#ifndef RESPONSE_BUFFER_H
+#define RESPONSE_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <curl/curl.h>
+
+// Number of released buffers kept around for reuse.
+#define RESPONSE_BUFFER_POOL_SIZE 4
+// Capacity of a buffer's first allocation when the size is not known up front.
+#define RESPONSE_BUFFER_INITIAL_CAPACITY 4096
+// Buffers that grew beyond this are freed on release rather than pooled.
+#define RESPONSE_BUFFER_RETAIN_LIMIT (256 * 1024)
+
+// A growable, NUL terminated buffer for a response body.
+typedef struct {
+    char *data;       // NULL until the first byte arrives
+    size_t size;
+    size_t capacity;
+    size_t max_size;  // Hard limit on size; 0 for none
+    CURL *handle;     // Set by response_buffer_attach() to presize from Content-Length
+    bool presized;
+} response_buffer_t;
+
+/**
+ * @brief Takes an empty buffer from the pool, or allocates one.
+ *
+ * @param max_size Largest body the buffer accepts; bigger responses abort the
+ *                 transfer. 0 means no limit.
+ * @return The buffer, or NULL on allocation failure.
+ */
+response_buffer_t *response_buffer_acquire(size_t max_size);
+
+/**
+ * @brief Empties the buffer and returns it to the pool, keeping its memory for
+ * the next response unless it grew beyond RESPONSE_BUFFER_RETAIN_LIMIT.
+ */
+void response_buffer_release(response_buffer_t *buffer);
+
+/**
+ * @brief Frees every pooled buffer.
+ */
+void response_buffer_pool_clear(void);
+
+/**
+ * @brief Makes the buffer the write target of an easy handle.
+ *
+ * On the first write the buffer is sized from the response's Content-Length,
+ * so a body of known length is received without ever being reallocated.
+ */
+void response_buffer_attach(response_buffer_t *buffer, CURL *handle);
+
+/**
+ * @brief Ensures the buffer can hold at least capacity bytes without growing.
+ *
+ * @return false if memory ran out or capacity exceeds the buffer's maximum.
+ */
+bool response_buffer_reserve(response_buffer_t *buffer, size_t capacity);
+
+/**
+ * @brief Appends bytes, growing the buffer geometrically.
+ *
+ * @return false if memory ran out or the buffer's maximum would be exceeded.
+ */
+bool response_buffer_append(response_buffer_t *buffer, const void *data, size_t length);
+
+/**
+ * @brief libcurl write callback appending to a response_buffer_t.
+ */
+size_t response_buffer_write_cb(void *contents, size_t size, size_t nmemb, void *userp);
+
+/**
+ * @brief Takes ownership of the buffer's contents, leaving it empty.
+ *
+ * @param size Populated with the number of bytes returned.
+ * @return The NUL terminated contents (free with free()), or NULL if empty.
+ */
+char *response_buffer_detach(response_buffer_t *buffer, size_t *size);
+
+#endif // RESPONSE_BUFFER_H
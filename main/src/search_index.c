@@ -0,0 +1,328 @@
+#include "search_index.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- CONSTANTS ---
+// Symbols of a trigram: a word separator, a-z, 0-9 and any byte of a UTF-8 sequence.
+#define ALPHABET_SIZE 38
+#define TRIGRAM_COUNT (ALPHABET_SIZE * ALPHABET_SIZE * ALPHABET_SIZE)
+#define SEPARATOR 0
+#define MAX_WORD_LENGTH 64
+// Per query word, by where it matched; the name counts most, the description least.
+#define SCORE_NAME_START 8 // The name starts with the word
+#define SCORE_NAME_WORD 6
+#define SCORE_NAME 4
+#define SCORE_SLUG_WORD 3
+#define SCORE_SLUG 2
+#define SCORE_DESCRIPTION_WORD 2
+#define SCORE_DESCRIPTION 1
+#define MAX_SCORE (SCORE_NAME_START * SEARCH_INDEX_MAX_WORDS)
+
+typedef enum {
+    MATCH_NONE,
+    MATCH_INSIDE,     // Within a word
+    MATCH_WORD_START,
+    MATCH_TEXT_START,
+} match_t;
+
+struct search_index {
+    const project_t *projects;
+    int count;
+    // The projects containing trigram t are postings[offsets[t]] .. postings[offsets[t + 1] - 1],
+    // in ascending order.
+    uint32_t *offsets;
+    uint16_t *postings;
+    // Scratch space of the queries, one entry per project.
+    uint16_t *candidates;
+    uint8_t *scores;
+};
+
+// Collects the trigrams of the text of one project, word separators collapsed.
+typedef struct {
+    search_index_t *index;
+    uint32_t *cursors; // Counts in the first pass, write positions in the second
+    int32_t *last_project; // Keeps a trigram from being counted twice for one project
+    int project;
+    bool fill;
+    int prev2;
+    int prev1;
+    int seen;
+} trigram_writer_t;
+
+typedef struct {
+    unsigned char text[MAX_WORD_LENGTH];
+    int length;
+} query_word_t;
+
+// --- IMPLEMENTATIONS ---
+
+static int symbol(unsigned char c) {
+    if (c >= 'a' && c <= 'z') return 1 + (c - 'a');
+    if (c >= 'A' && c <= 'Z') return 1 + (c - 'A');
+    if (c >= '0' && c <= '9') return 27 + (c - '0');
+    if (c >= 0x80) return 37;
+    return SEPARATOR;
+}
+
+static unsigned char fold(unsigned char c) {
+    return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+static int trigram(int a, int b, int c) {
+    return (a * ALPHABET_SIZE + b) * ALPHABET_SIZE + c;
+}
+
+static void writer_push(trigram_writer_t *writer, int s) {
+    if (s == SEPARATOR && writer->prev1 == SEPARATOR) return;
+    if (writer->seen >= 2) {
+        int t = trigram(writer->prev2, writer->prev1, s);
+        if (writer->last_project[t] != writer->project) {
+            writer->last_project[t] = writer->project;
+            if (writer->fill) {
+                writer->index->postings[writer->cursors[t]++] = (uint16_t)writer->project;
+            } else {
+                writer->cursors[t]++;
+            }
+        }
+    }
+    writer->prev2 = writer->prev1;
+    writer->prev1 = s;
+    writer->seen++;
+}
+
+static void writer_add_project(trigram_writer_t *writer, int project) {
+    const project_t *p = &writer->index->projects[project];
+    const char *fields[] = {p->name, p->slug, p->description};
+    writer->project = project;
+    writer->prev1 = SEPARATOR; // As if preceded by a separator, so the first word has a start too
+    writer->seen = 1;
+    for (size_t f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+        if (!fields[f]) continue;
+        for (const unsigned char *c = (const unsigned char *)fields[f]; *c; c++) writer_push(writer, symbol(*c));
+        writer_push(writer, SEPARATOR);
+    }
+}
+
+static void writer_pass(trigram_writer_t *writer, bool fill) {
+    writer->fill = fill;
+    memset(writer->last_project, 0xff, TRIGRAM_COUNT * sizeof(int32_t));
+    for (int i = 0; i < writer->index->count; i++) writer_add_project(writer, i);
+}
+
+search_index_t *search_index_build(const project_t *projects, int count) {
+    if (count < 0 || count > SEARCH_INDEX_MAX_PROJECTS || (count > 0 && !projects)) return NULL;
+    search_index_t *index = calloc(1, sizeof(search_index_t));
+    trigram_writer_t writer = {0};
+    writer.index = index;
+    writer.cursors = calloc(TRIGRAM_COUNT, sizeof(uint32_t));
+    writer.last_project = malloc(TRIGRAM_COUNT * sizeof(int32_t));
+    if (!index || !writer.cursors || !writer.last_project) goto fail;
+    index->projects = projects;
+    index->count = count;
+    index->offsets = malloc((TRIGRAM_COUNT + 1) * sizeof(uint32_t));
+    index->candidates = malloc((count > 0 ? count : 1) * sizeof(uint16_t));
+    index->scores = malloc(count > 0 ? count : 1);
+    if (!index->offsets || !index->candidates || !index->scores) goto fail;
+
+    // Count the projects per trigram, then lay the lists out back to back and fill them.
+    writer_pass(&writer, false);
+    uint32_t total = 0;
+    for (int t = 0; t < TRIGRAM_COUNT; t++) {
+        index->offsets[t] = total;
+        total += writer.cursors[t];
+        writer.cursors[t] = index->offsets[t];
+    }
+    index->offsets[TRIGRAM_COUNT] = total;
+    index->postings = malloc((total > 0 ? total : 1) * sizeof(uint16_t));
+    if (!index->postings) goto fail;
+    writer_pass(&writer, true);
+
+    free(writer.cursors);
+    free(writer.last_project);
+    return index;
+
+fail:
+    free(writer.cursors);
+    free(writer.last_project);
+    search_index_free(index);
+    return NULL;
+}
+
+// Splits a query into folded words.
+static int parse_query(const char *query, query_word_t *words) {
+    int count = 0;
+    const unsigned char *c = (const unsigned char *)query;
+    while (*c && count < SEARCH_INDEX_MAX_WORDS) {
+        while (*c && symbol(*c) == SEPARATOR) c++;
+        if (!*c) break;
+        query_word_t *word = &words[count++];
+        word->length = 0;
+        for (; *c && symbol(*c) != SEPARATOR; c++) {
+            if (word->length < MAX_WORD_LENGTH) word->text[word->length++] = fold(*c);
+        }
+    }
+    return count;
+}
+
+// Finds where a folded word occurs in a text, preferring the start of the text or of a word.
+static match_t match_text(const char *text, const query_word_t *word) {
+    if (!text) return MATCH_NONE;
+    const unsigned char *t = (const unsigned char *)text;
+    match_t best = MATCH_NONE;
+    for (size_t i = 0; t[i]; i++) {
+        if (fold(t[i]) != word->text[0]) continue;
+        bool word_start = i == 0 || symbol(t[i - 1]) == SEPARATOR;
+        if (best != MATCH_NONE && !word_start) continue;
+        int k = 1;
+        while (k < word->length && t[i + k] && fold(t[i + k]) == word->text[k]) k++;
+        if (k < word->length) continue;
+        if (i == 0) return MATCH_TEXT_START;
+        if (word_start) return MATCH_WORD_START; // Nothing better can follow
+        best = MATCH_INSIDE;
+    }
+    return best;
+}
+
+// Scores a project for one word, 0 if it does not contain it.
+static int score_word(const project_t *project, const query_word_t *word) {
+    // Short words only count at the start of a word; anywhere, they match nearly everything.
+    match_t min_match = word->length >= 3 ? MATCH_INSIDE : MATCH_WORD_START;
+    match_t match = match_text(project->name, word);
+    if (match >= min_match) {
+        return match == MATCH_TEXT_START ? SCORE_NAME_START : match == MATCH_WORD_START ? SCORE_NAME_WORD : SCORE_NAME;
+    }
+    match = match_text(project->slug, word);
+    if (match >= min_match) return match >= MATCH_WORD_START ? SCORE_SLUG_WORD : SCORE_SLUG;
+    match = match_text(project->description, word);
+    if (match >= min_match) return match >= MATCH_WORD_START ? SCORE_DESCRIPTION_WORD : SCORE_DESCRIPTION;
+    return 0;
+}
+
+// Keeps the candidates that appear in a posting list.
+static int intersect(uint16_t *candidates, int count, const uint16_t *list, uint32_t length) {
+    int kept = 0;
+    uint32_t j = 0;
+    for (int i = 0; i < count && j < length; i++) {
+        uint16_t project = candidates[i];
+        if (list[j] < project) {
+            // Gallop over the part of the list before the candidate, then search it.
+            uint32_t step = 1, lo = j;
+            while (lo + step < length && list[lo + step] < project) {
+                lo += step;
+                step *= 2;
+            }
+            uint32_t hi = lo + step < length ? lo + step : length;
+            while (lo < hi) {
+                uint32_t mid = lo + (hi - lo) / 2;
+                if (list[mid] < project) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            j = lo;
+        }
+        if (j < length && list[j] == project) candidates[kept++] = project;
+    }
+    return kept;
+}
+
+int search_index_query(search_index_t *index, const char *query, int *results, int max_results) {
+    if (!index || !query) return 0;
+    query_word_t words[SEARCH_INDEX_MAX_WORDS];
+    int word_count = parse_query(query, words);
+    if (word_count == 0) return 0;
+
+    // The trigrams every match must contain. A two-letter word is looked up as the
+    // start of a word; single letters are only verified, unless there is nothing else.
+    int trigrams[SEARCH_INDEX_MAX_WORDS * (MAX_WORD_LENGTH - 2)];
+    int trigram_count = 0;
+    for (int w = 0; w < word_count; w++) {
+        int s[MAX_WORD_LENGTH];
+        for (int i = 0; i < words[w].length; i++) s[i] = symbol(words[w].text[i]);
+        if (words[w].length == 2) trigrams[trigram_count++] = trigram(SEPARATOR, s[0], s[1]);
+        for (int i = 0; i + 2 < words[w].length; i++) trigrams[trigram_count++] = trigram(s[i], s[i + 1], s[i + 2]);
+    }
+
+    // Start from the shortest list, so the intersection only ever shrinks a small set.
+    int candidate_count = 0;
+    if (trigram_count == 0) {
+        // The projects with a word starting with the letter: those of every trigram
+        // made of a separator, the letter and whatever follows it.
+        int first = symbol(words[0].text[0]);
+        memset(index->scores, 0, index->count);
+        for (int s = 0; s < ALPHABET_SIZE; s++) {
+            int t = trigram(SEPARATOR, first, s);
+            for (uint32_t i = index->offsets[t]; i < index->offsets[t + 1]; i++) index->scores[index->postings[i]] = 1;
+        }
+        for (int i = 0; i < index->count; i++) {
+            if (index->scores[i]) index->candidates[candidate_count++] = (uint16_t)i;
+        }
+    } else {
+        int shortest = 0;
+        for (int i = 1; i < trigram_count; i++) {
+            int t = trigrams[i], u = trigrams[shortest];
+            if (index->offsets[t + 1] - index->offsets[t] < index->offsets[u + 1] - index->offsets[u]) shortest = i;
+        }
+        int t = trigrams[shortest];
+        candidate_count = (int)(index->offsets[t + 1] - index->offsets[t]);
+        memcpy(index->candidates, &index->postings[index->offsets[t]], candidate_count * sizeof(uint16_t));
+        for (int i = 0; i < trigram_count && candidate_count > 0; i++) {
+            if (i == shortest) continue;
+            t = trigrams[i];
+            candidate_count = intersect(index->candidates, candidate_count, &index->postings[index->offsets[t]],
+                                        index->offsets[t + 1] - index->offsets[t]);
+        }
+    }
+
+    // The trigrams may come from different words or fields; check the words themselves.
+    int match_count = 0;
+    int per_score[MAX_SCORE + 1] = {0};
+    for (int i = 0; i < candidate_count; i++) {
+        const project_t *project = &index->projects[index->candidates[i]];
+        int score = 0;
+        for (int w = 0; w < word_count; w++) {
+            int word_score = score_word(project, &words[w]);
+            if (word_score == 0) {
+                score = 0;
+                break;
+            }
+            score += word_score;
+        }
+        if (score == 0) continue;
+        index->candidates[match_count] = index->candidates[i];
+        index->scores[match_count] = (uint8_t)score;
+        per_score[score]++;
+        match_count++;
+    }
+
+    // Order by score with a counting sort; the candidates are already in project order.
+    int next[MAX_SCORE + 1];
+    int position = 0;
+    for (int score = MAX_SCORE; score >= 0; score--) {
+        next[score] = position;
+        position += per_score[score];
+    }
+    for (int i = 0; i < match_count; i++) {
+        int slot = next[index->scores[i]]++;
+        if (slot < max_results) results[slot] = index->candidates[i];
+    }
+    return match_count;
+}
+
+size_t search_index_memory(const search_index_t *index) {
+    if (!index) return 0;
+    return sizeof(search_index_t) + (TRIGRAM_COUNT + 1) * sizeof(uint32_t) +
+           index->offsets[TRIGRAM_COUNT] * sizeof(uint16_t) + index->count * (sizeof(uint16_t) + sizeof(uint8_t));
+}
+
+void search_index_free(search_index_t *index) {
+    if (!index) return;
+    free(index->offsets);
+    free(index->postings);
+    free(index->candidates);
+    free(index->scores);
+    free(index);
+}
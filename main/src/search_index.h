@@ -0,0 +1,51 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include <stddef.h>
+#include "badgehub_client.h"
+
+// Projects are numbered with 16 bits in the posting lists.
+#define SEARCH_INDEX_MAX_PROJECTS 65535
+// Words of a query beyond this are ignored.
+#define SEARCH_INDEX_MAX_WORDS 8
+
+typedef struct search_index search_index_t;
+
+/**
+ * @brief Builds a trigram index over the names, slugs and descriptions of projects.
+ *
+ * Text is matched case-insensitively (ASCII); anything but letters and digits
+ * separates words. The index keeps, per trigram, the sorted list of projects that
+ * contain it, and refers to the projects rather than copying their text.
+ *
+ * @param projects The projects to index; they must outlive the index.
+ * @param count At most SEARCH_INDEX_MAX_PROJECTS.
+ * @return The index (free with search_index_free()), or NULL on allocation failure.
+ */
+search_index_t *search_index_build(const project_t *projects, int count);
+
+/**
+ * @brief Finds the projects that contain every word of a query, best first.
+ *
+ * Words of three or more characters match anywhere, like the server's search;
+ * shorter ones only at the start of a word, as while typing. Matches in the name
+ * rank above matches in the slug, which rank above matches in the description;
+ * equal scores keep the order of the projects.
+ *
+ * @param results Receives the positions of up to max_results projects.
+ * @return The number of matching projects, which may exceed max_results. A query
+ *         without words matches nothing.
+ */
+int search_index_query(search_index_t *index, const char *query, int *results, int max_results);
+
+/**
+ * @brief Returns the bytes the index allocated, including its scratch space.
+ */
+size_t search_index_memory(const search_index_t *index);
+
+/**
+ * @brief Frees the index. NULL is ignored.
+ */
+void search_index_free(search_index_t *index);
+
+#endif // SEARCH_INDEX_H
@@ -0,0 +1,309 @@
+#include "sha256.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SHA256_HAVE_SHA_NI 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__) && defined(__aarch64__)
+#define SHA256_HAVE_ARMV8 1
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+// --- CONSTANTS ---
+#define FILE_READ_CHUNK 16384
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+typedef void (*compress_fn_t)(uint32_t state[8], const uint8_t *data, size_t blocks);
+
+// --- STATIC STATE VARIABLES ---
+static compress_fn_t s_compress = NULL;
+static sha256_backend_t s_backend = SHA256_BACKEND_PORTABLE;
+
+// --- IMPLEMENTATIONS ---
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void compress_block_portable(uint32_t state[8], const uint8_t *block) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 |
+               (uint32_t)block[i * 4 + 2] << 8 | (uint32_t)block[i * 4 + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+        uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+static void compress_portable(uint32_t state[8], const uint8_t *data, size_t blocks) {
+    for (; blocks > 0; blocks--, data += 64) compress_block_portable(state, data);
+}
+
+#ifdef SHA256_HAVE_SHA_NI
+// The SHA-NI round instructions keep the state as ABEF / CDGH and do two rounds
+// each; sha256msg1/2 compute the message schedule four words at a time.
+__attribute__((target("sha,sse4.1")))
+static void compress_sha_ni(uint32_t state[8], const uint8_t *data, size_t blocks) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xB1); // CDAB
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1B); // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);      // CDGH
+
+    for (; blocks > 0; blocks--, data += 64) {
+        __m128i abef = state0;
+        __m128i cdgh = state1;
+        __m128i w[4];
+        // Fully unrolled, the ring of message words stays in registers.
+#pragma GCC unroll 16
+        for (int i = 0; i < 16; i++) {
+            if (i < 4) {
+                w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + i * 16)), byte_swap);
+            } else {
+                // w[i % 4] holds W[4i-16..4i-13]; the others the three groups after it.
+                __m128i x = _mm_sha256msg1_epu32(w[i % 4], w[(i + 1) % 4]);
+                x = _mm_add_epi32(x, _mm_alignr_epi8(w[(i + 3) % 4], w[(i + 2) % 4], 4));
+                w[i % 4] = _mm_sha256msg2_epu32(x, w[(i + 3) % 4]);
+            }
+            __m128i msg = _mm_add_epi32(w[i % 4], _mm_loadu_si128((const __m128i *)&K[i * 4]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0E));
+        }
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);       // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);    // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0); // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);    // HGFE
+    _mm_storeu_si128((__m128i *)&state[0], state0);
+    _mm_storeu_si128((__m128i *)&state[4], state1);
+}
+
+static bool cpu_has_sha_ni(void) {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1) || !(ecx & bit_SSSE3)) return false;
+    if (__get_cpuid_max(0, NULL) < 7) return false;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & (1u << 29)) != 0;
+}
+#endif
+
+#ifdef SHA256_HAVE_ARMV8
+#ifdef __clang__
+#define ARMV8_CRYPTO_TARGET __attribute__((target("crypto")))
+#else
+#define ARMV8_CRYPTO_TARGET __attribute__((target("+crypto")))
+#endif
+
+ARMV8_CRYPTO_TARGET
+static void compress_armv8(uint32_t state[8], const uint8_t *data, size_t blocks) {
+    uint32x4_t state0 = vld1q_u32(&state[0]);
+    uint32x4_t state1 = vld1q_u32(&state[4]);
+
+    for (; blocks > 0; blocks--, data += 64) {
+        uint32x4_t abcd = state0;
+        uint32x4_t efgh = state1;
+        uint32x4_t w[4];
+        for (int i = 0; i < 4; i++) w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + i * 16)));
+#pragma GCC unroll 16
+        for (int i = 0; i < 16; i++) {
+            uint32x4_t msg = vaddq_u32(w[i % 4], vld1q_u32(&K[i * 4]));
+            uint32x4_t previous = state0;
+            state0 = vsha256hq_u32(state0, state1, msg);
+            state1 = vsha256h2q_u32(state1, previous, msg);
+            if (i < 12) {
+                w[i % 4] = vsha256su1q_u32(vsha256su0q_u32(w[i % 4], w[(i + 1) % 4]), w[(i + 2) % 4], w[(i + 3) % 4]);
+            }
+        }
+        state0 = vaddq_u32(state0, abcd);
+        state1 = vaddq_u32(state1, efgh);
+    }
+
+    vst1q_u32(&state[0], state0);
+    vst1q_u32(&state[4], state1);
+}
+
+static bool cpu_has_armv8_sha2(void) {
+#if defined(__APPLE__)
+    return true; // Every Apple arm64 CPU has the cryptography extensions.
+#elif defined(__linux__) && defined(HWCAP_SHA2)
+    return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#else
+    return false;
+#endif
+}
+#endif
+
+static compress_fn_t backend_function(sha256_backend_t backend) {
+    switch (backend) {
+    case SHA256_BACKEND_PORTABLE:
+        return compress_portable;
+#ifdef SHA256_HAVE_SHA_NI
+    case SHA256_BACKEND_SHA_NI:
+        return cpu_has_sha_ni() ? compress_sha_ni : NULL;
+#endif
+#ifdef SHA256_HAVE_ARMV8
+    case SHA256_BACKEND_ARMV8:
+        return cpu_has_armv8_sha2() ? compress_armv8 : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+// Picks the fastest available backend the first time anything is hashed.
+static void select_backend(void) {
+    static const sha256_backend_t preferred[] = { SHA256_BACKEND_SHA_NI, SHA256_BACKEND_ARMV8, SHA256_BACKEND_PORTABLE };
+    for (size_t i = 0; i < sizeof(preferred) / sizeof(preferred[0]); i++) {
+        compress_fn_t fn = backend_function(preferred[i]);
+        if (fn) {
+            s_backend = preferred[i];
+            s_compress = fn;
+            return;
+        }
+    }
+}
+
+sha256_backend_t sha256_get_backend(void) {
+    if (!s_compress) select_backend();
+    return s_backend;
+}
+
+bool sha256_backend_available(sha256_backend_t backend) {
+    return backend_function(backend) != NULL;
+}
+
+bool sha256_set_backend(sha256_backend_t backend) {
+    compress_fn_t fn = backend_function(backend);
+    if (!fn) return false;
+    s_backend = backend;
+    s_compress = fn;
+    return true;
+}
+
+const char *sha256_backend_name(sha256_backend_t backend) {
+    switch (backend) {
+    case SHA256_BACKEND_PORTABLE: return "portable";
+    case SHA256_BACKEND_SHA_NI: return "sha-ni";
+    case SHA256_BACKEND_ARMV8: return "armv8";
+    default: return "unknown";
+    }
+}
+
+void sha256_init(sha256_ctx_t *ctx) {
+    static const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+    if (!s_compress) select_backend();
+    memcpy(ctx->state, initial, sizeof(initial));
+    ctx->length = 0;
+    ctx->block_used = 0;
+}
+
+void sha256_update(sha256_ctx_t *ctx, const void *data, size_t length) {
+    const uint8_t *p = data;
+    ctx->length += length;
+    if (ctx->block_used > 0) {
+        size_t n = 64 - ctx->block_used < length ? 64 - ctx->block_used : length;
+        memcpy(ctx->block + ctx->block_used, p, n);
+        ctx->block_used += n;
+        p += n;
+        length -= n;
+        if (ctx->block_used < 64) return;
+        s_compress(ctx->state, ctx->block, 1);
+        ctx->block_used = 0;
+    }
+    if (length >= 64) {
+        s_compress(ctx->state, p, length / 64);
+        p += length & ~(size_t)63;
+        length &= 63;
+    }
+    memcpy(ctx->block, p, length);
+    ctx->block_used = length;
+}
+
+void sha256_final(sha256_ctx_t *ctx, uint8_t digest[SHA256_DIGEST_SIZE]) {
+    uint64_t bits = ctx->length * 8;
+    ctx->block[ctx->block_used++] = 0x80;
+    if (ctx->block_used > 56) {
+        memset(ctx->block + ctx->block_used, 0, 64 - ctx->block_used);
+        s_compress(ctx->state, ctx->block, 1);
+        ctx->block_used = 0;
+    }
+    memset(ctx->block + ctx->block_used, 0, 56 - ctx->block_used);
+    for (int i = 0; i < 8; i++) ctx->block[56 + i] = (uint8_t)(bits >> (56 - i * 8));
+    s_compress(ctx->state, ctx->block, 1);
+    for (int i = 0; i < 8; i++) {
+        digest[i * 4] = (uint8_t)(ctx->state[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t)(ctx->state[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t)(ctx->state[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t)ctx->state[i];
+    }
+}
+
+void sha256_to_hex(const uint8_t digest[SHA256_DIGEST_SIZE], char hex[SHA256_HEX_SIZE]) {
+    static const char digits[] = "0123456789abcdef";
+    for (int i = 0; i < SHA256_DIGEST_SIZE; i++) {
+        hex[i * 2] = digits[digest[i] >> 4];
+        hex[i * 2 + 1] = digits[digest[i] & 0xf];
+    }
+    hex[SHA256_HEX_SIZE - 1] = '\0';
+}
+
+bool sha256_file(const char *path, char hex[SHA256_HEX_SIZE], uint64_t *size) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return false;
+    sha256_ctx_t ctx;
+    sha256_init(&ctx);
+    uint8_t buffer[FILE_READ_CHUNK];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0) sha256_update(&ctx, buffer, n);
+    bool ok = !ferror(fp);
+    fclose(fp);
+    if (!ok) return false;
+    if (size) *size = ctx.length;
+    uint8_t digest[SHA256_DIGEST_SIZE];
+    sha256_final(&ctx, digest);
+    sha256_to_hex(digest, hex);
+    return true;
+}
+
+bool sha256_hex_equal(const char *a, const char *b) {
+    if (!a || !b || !*a || !*b) return false;
+    for (; *a && *b; a++, b++) {
+        if (tolower((unsigned char)*a) != tolower((unsigned char)*b)) return false;
+    }
+    return *a == *b;
+}
@@ -0,0 +1,77 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_DIGEST_SIZE 32
+// Lowercase hex digest plus the terminating NUL.
+#define SHA256_HEX_SIZE (SHA256_DIGEST_SIZE * 2 + 1)
+
+// Block functions sha256_update() can use. The fastest one the CPU supports is
+// picked on first use.
+typedef enum {
+    SHA256_BACKEND_PORTABLE,
+    SHA256_BACKEND_SHA_NI,   // x86 SHA extensions
+    SHA256_BACKEND_ARMV8,    // ARMv8 cryptography extensions
+    SHA256_BACKEND_COUNT,
+} sha256_backend_t;
+
+// Incremental SHA-256 state, so data can be hashed as it streams in.
+typedef struct {
+    uint32_t state[8];
+    uint64_t length;     // Total bytes hashed
+    uint8_t block[64];   // Pending partial block
+    size_t block_used;
+} sha256_ctx_t;
+
+void sha256_init(sha256_ctx_t *ctx);
+void sha256_update(sha256_ctx_t *ctx, const void *data, size_t length);
+void sha256_final(sha256_ctx_t *ctx, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+/**
+ * @brief Returns the backend sha256_update() uses.
+ */
+sha256_backend_t sha256_get_backend(void);
+
+/**
+ * @brief Returns whether a backend was compiled in and the CPU supports it.
+ */
+bool sha256_backend_available(sha256_backend_t backend);
+
+/**
+ * @brief Forces a backend, e.g. to compare them. Not meant to be called while
+ * another thread is hashing.
+ *
+ * @return false if the backend is not available; the current one is kept.
+ */
+bool sha256_set_backend(sha256_backend_t backend);
+
+/**
+ * @brief Returns a short human-readable name for a backend.
+ */
+const char *sha256_backend_name(sha256_backend_t backend);
+
+/**
+ * @brief Formats a digest as lowercase hex.
+ */
+void sha256_to_hex(const uint8_t digest[SHA256_DIGEST_SIZE], char hex[SHA256_HEX_SIZE]);
+
+/**
+ * @brief Hashes a whole file.
+ *
+ * @param hex Populated with the lowercase hex digest.
+ * @param size If not NULL, populated with the number of bytes read.
+ * @return false if the file could not be read.
+ */
+bool sha256_file(const char *path, char hex[SHA256_HEX_SIZE], uint64_t *size);
+
+/**
+ * @brief Compares a hex digest with an expected one, ignoring case.
+ *
+ * @return false if either is empty or they differ.
+ */
+bool sha256_hex_equal(const char *a, const char *b);
+
+#endif // SHA256_H
@@ -0,0 +1,273 @@
+#include "update_checker.h"
+#include "badgehub_client.h"
+#include "catalog_snapshot.h"
+#include "install_manager.h"
+#include "os_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// A queued "update all" entry.
+typedef struct {
+    char *slug;
+    int revision;
+} scheduled_update_t;
+
+// --- STATIC STATE VARIABLES ---
+static app_update_t *s_updates = NULL; // Result of the last completed check
+static int s_update_count = 0;
+static bool s_have_result = false;
+static time_t s_checked_at = 0;
+
+static http_request_t *s_page_request = NULL; // In-flight catalog page of the running check
+static app_update_t *s_found = NULL;          // Updates collected by the running check
+static int s_found_count = 0;
+static int s_found_capacity = 0;
+static int s_offset = 0;
+static int s_pages = 0;   // Pages requested by the running check
+static int s_matched = 0; // Installed apps seen so far
+
+static scheduled_update_t *s_queue = NULL; // "Update all" entries whose details are still to be fetched
+static int s_queue_count = 0;
+static int s_queue_next = 0;
+static http_request_t *s_details_request = NULL;
+
+static update_checker_cb_t s_listener = NULL;
+static void *s_listener_data = NULL;
+
+// --- FORWARD DECLARATIONS ---
+static void page_fetched_cb(project_t *projects, int project_count, bool success, void *user_data);
+static void details_fetched_cb(project_detail_t *details, void *user_data);
+
+// --- IMPLEMENTATIONS ---
+
+static void notify(bool success) {
+    if (s_listener) s_listener(success, s_listener_data);
+}
+
+static void free_updates(app_update_t *updates, int count) {
+    for (int i = 0; i < count; i++) {
+        free(updates[i].slug);
+        free(updates[i].name);
+    }
+    free(updates);
+}
+
+static void discard_found(void) {
+    free_updates(s_found, s_found_count);
+    s_found = NULL;
+    s_found_count = s_found_capacity = 0;
+}
+
+static void clear_queue(void) {
+    for (int i = 0; i < s_queue_count; i++) free(s_queue[i].slug);
+    free(s_queue);
+    s_queue = NULL;
+    s_queue_count = s_queue_next = 0;
+}
+
+static bool add_found(const project_t *project, int installed_revision) {
+    if (s_found_count == s_found_capacity) {
+        int capacity = s_found_capacity > 0 ? s_found_capacity * 2 : 8;
+        app_update_t *found = realloc(s_found, capacity * sizeof(app_update_t));
+        if (!found) return false;
+        s_found = found;
+        s_found_capacity = capacity;
+    }
+    app_update_t *update = &s_found[s_found_count];
+    update->slug = strdup(project->slug);
+    update->name = strdup(project->name ? project->name : project->slug);
+    update->installed_revision = installed_revision;
+    update->latest_revision = project->revision;
+    if (!update->slug || !update->name) {
+        free(update->slug);
+        free(update->name);
+        return false;
+    }
+    s_found_count++;
+    return true;
+}
+
+static void finish_check(bool success) {
+    if (success) {
+        free_updates(s_updates, s_update_count);
+        s_updates = s_found;
+        s_update_count = s_found_count;
+        s_found = NULL;
+        s_found_count = s_found_capacity = 0;
+        s_have_result = true;
+        s_checked_at = time(NULL);
+    } else {
+        discard_found();
+    }
+    notify(success);
+}
+
+static void page_fetched_cb(project_t *projects, int project_count, bool success, void *user_data) {
+    s_page_request = NULL;
+    for (int i = 0; success && i < project_count; i++) {
+        if (!projects[i].slug) continue;
+        const installed_app_t *app = os_client_find(projects[i].slug);
+        if (!app) continue;
+        s_matched++;
+        if (projects[i].revision > app->revision) success = add_found(&projects[i], app->revision);
+    }
+    free_applications(projects, project_count);
+    if (!success) {
+        finish_check(false);
+        return;
+    }
+    // A project that moved between pages while paging may be counted twice; the
+    // worst case is one page fewer than needed, caught by the next check.
+    if (project_count < UPDATE_CHECKER_PAGE_SIZE || s_matched >= os_client_count() ||
+        s_pages >= UPDATE_CHECKER_MAX_PAGES) {
+        finish_check(true);
+        return;
+    }
+    s_offset += project_count;
+    s_pages++;
+    s_page_request = get_applications_async("", UPDATE_CHECKER_PAGE_SIZE, s_offset, page_fetched_cb, NULL);
+    if (!s_page_request) finish_check(false);
+}
+
+static bool snapshot_is_recent(void) {
+    return catalog_snapshot_count() > 0 && time(NULL) - catalog_snapshot_synced_at() < UPDATE_CHECKER_TTL_SECONDS;
+}
+
+// Matches the installed apps against the whole catalog as of the last sync.
+static void check_snapshot(void) {
+    bool success = true;
+    for (int i = 0; success && i < catalog_snapshot_count(); i++) {
+        const project_t *project = catalog_snapshot_get(i);
+        const installed_app_t *app = project->slug ? os_client_find(project->slug) : NULL;
+        if (app && project->revision > app->revision) success = add_found(project, app->revision);
+    }
+    finish_check(success);
+}
+
+bool update_checker_refresh(bool force) {
+    bool use_snapshot = snapshot_is_recent();
+    if (s_page_request && !use_snapshot) return true;
+    if (!force && s_have_result && time(NULL) - s_checked_at < UPDATE_CHECKER_TTL_SECONDS) return false;
+    if (s_page_request) {
+        // Overtaken by a synced snapshot, which covers the whole catalog.
+        http_async_cancel(s_page_request);
+        s_page_request = NULL;
+    }
+    discard_found();
+    s_offset = 0;
+    s_pages = 1;
+    s_matched = 0;
+    if (os_client_count() == 0) {
+        finish_check(true); // Nothing installed, nothing to ask
+        return false;
+    }
+    if (use_snapshot) {
+        check_snapshot();
+        return false;
+    }
+    s_page_request = get_applications_async("", UPDATE_CHECKER_PAGE_SIZE, 0, page_fetched_cb, NULL);
+    return s_page_request != NULL;
+}
+
+bool update_checker_is_checking(void) {
+    return s_page_request != NULL;
+}
+
+// Drops updates that were installed (or apps that were removed) since the check.
+static void prune_applied(void) {
+    int kept = 0;
+    for (int i = 0; i < s_update_count; i++) {
+        const installed_app_t *app = os_client_find(s_updates[i].slug);
+        if (app && app->revision < s_updates[i].latest_revision) {
+            s_updates[kept++] = s_updates[i];
+        } else {
+            free(s_updates[i].slug);
+            free(s_updates[i].name);
+        }
+    }
+    s_update_count = kept;
+}
+
+int update_checker_count(void) {
+    prune_applied();
+    return s_update_count;
+}
+
+const app_update_t *update_checker_get(int index) {
+    prune_applied();
+    return index >= 0 && index < s_update_count ? &s_updates[index] : NULL;
+}
+
+// Fetches the file list of the next queued app.
+static void schedule_next(void) {
+    while (!s_details_request && s_queue_next < s_queue_count) {
+        scheduled_update_t *next = &s_queue[s_queue_next++];
+        s_details_request = get_project_details_async(next->slug, next->revision, details_fetched_cb, NULL);
+        if (!s_details_request) fprintf(stderr, "Could not request details of %s\n", next->slug);
+    }
+    if (s_queue_next >= s_queue_count && !s_details_request) clear_queue();
+}
+
+static void details_fetched_cb(project_detail_t *details, void *user_data) {
+    s_details_request = NULL;
+    if (details) {
+        if (!install_manager_install(details, INSTALL_MODE_INCREMENTAL)) {
+            fprintf(stderr, "Could not schedule the update of %s\n", details->slug);
+        }
+        free_project_details(details);
+    }
+    schedule_next();
+    notify(true);
+}
+
+int update_checker_update_all(void) {
+    int count = update_checker_count();
+    if (count == 0) return 0;
+    scheduled_update_t *queue = realloc(s_queue, (s_queue_count + count) * sizeof(scheduled_update_t));
+    if (!queue) return 0;
+    s_queue = queue;
+    int scheduled = 0;
+    for (int i = 0; i < count; i++) {
+        const app_update_t *update = &s_updates[i];
+        bool queued = install_manager_get_progress(update->slug, NULL);
+        for (int j = s_queue_next; !queued && j < s_queue_count; j++) queued = strcmp(s_queue[j].slug, update->slug) == 0;
+        if (queued) continue;
+        char *slug = strdup(update->slug);
+        if (!slug) break;
+        s_queue[s_queue_count].slug = slug;
+        s_queue[s_queue_count].revision = update->latest_revision;
+        s_queue_count++;
+        scheduled++;
+    }
+    schedule_next();
+    return scheduled;
+}
+
+bool update_checker_is_updating(void) {
+    return s_details_request != NULL || s_queue_next < s_queue_count;
+}
+
+void update_checker_set_listener(update_checker_cb_t cb, void *user_data) {
+    s_listener = cb;
+    s_listener_data = user_data;
+}
+
+void update_checker_deinit(void) {
+    if (s_page_request) {
+        http_async_cancel(s_page_request);
+        s_page_request = NULL;
+    }
+    if (s_details_request) {
+        http_async_cancel(s_details_request);
+        s_details_request = NULL;
+    }
+    clear_queue();
+    discard_found();
+    free_updates(s_updates, s_update_count);
+    s_updates = NULL;
+    s_update_count = 0;
+    s_have_result = false;
+    s_listener = NULL;
+}
@@ -0,0 +1,89 @@
+#ifndef UPDATE_CHECKER_H
+#define UPDATE_CHECKER_H
+
+#include <stdbool.h>
+
+// Projects requested per /project-summaries page while checking for updates.
+#define UPDATE_CHECKER_PAGE_SIZE 100
+// Pages a check requests at most when there is no recent catalog snapshot.
+#define UPDATE_CHECKER_MAX_PAGES 5
+// How long a completed check is reused before update_checker_refresh() asks the server again.
+#define UPDATE_CHECKER_TTL_SECONDS 900
+
+// An installed app whose catalog revision is newer than the installed one.
+typedef struct {
+    char *slug;
+    char *name;
+    int installed_revision;
+    int latest_revision;
+} app_update_t;
+
+// Called on the LVGL thread when a check finishes (success tells whether it
+// completed) and whenever "update all" schedules another install.
+typedef void (*update_checker_cb_t)(bool success, void *user_data);
+
+/**
+ * @brief Checks the installed apps (see os_client.h) for newer revisions.
+ *
+ * The installed apps are matched against the catalog snapshot (see
+ * catalog_snapshot.h) when it was synced less than UPDATE_CHECKER_TTL_SECONDS
+ * ago, which takes no request at all. Without such a snapshot the catalog is
+ * read from the server in pages of UPDATE_CHECKER_PAGE_SIZE projects, stopping
+ * once every installed app has been seen or after UPDATE_CHECKER_MAX_PAGES
+ * pages; apps further down the catalog are then checked once a snapshot is
+ * synced. The previous result stays available until the new one is complete.
+ *
+ * @param force Check even if the last result is younger than UPDATE_CHECKER_TTL_SECONDS.
+ *              Call with true after a snapshot sync to pick up the new catalog.
+ * @return true if a check is running (the listener will be called), false if the
+ *         check completed right away (the listener has been called), the cached
+ *         result is still fresh or the request could not be started.
+ */
+bool update_checker_refresh(bool force);
+
+/**
+ * @brief Returns whether a check is in flight.
+ */
+bool update_checker_is_checking(void);
+
+/**
+ * @brief Returns the number of apps with an update, from the last completed check.
+ * Apps updated or removed since then are no longer counted.
+ */
+int update_checker_count(void);
+
+/**
+ * @brief Returns an update, 0 <= index < update_checker_count(). Valid until the
+ * next call into the update checker or return to the LVGL loop.
+ */
+const app_update_t *update_checker_get(int index);
+
+/**
+ * @brief Installs the latest revision of every app with an update.
+ *
+ * Fetches the file list of each outdated app, one at a time, and queues it with
+ * the install manager in incremental mode, so only changed files are downloaded.
+ * Apps that are already being installed are skipped.
+ *
+ * @return The number of apps scheduled.
+ */
+int update_checker_update_all(void);
+
+/**
+ * @brief Returns whether "update all" is still fetching file lists to schedule.
+ */
+bool update_checker_is_updating(void);
+
+/**
+ * @brief Sets the callback for check results and update scheduling. Passing NULL
+ * detaches it without stopping the work in progress.
+ */
+void update_checker_set_listener(update_checker_cb_t cb, void *user_data);
+
+/**
+ * @brief Cancels the check and scheduling in progress and frees the cached result.
+ * Call before install_manager_deinit().
+ */
+void update_checker_deinit(void);
+
+#endif // UPDATE_CHECKER_H
@@ -3,27 +3,13 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <errno.h>
-
-// libcurl callback function to write received data into our MemoryStruct
-size_t WriteMemoryCallback(void *contents, size_t size, size_t nmemb, void *userp) {
-    size_t realsize = size * nmemb;
-    struct MemoryStruct *mem = (struct MemoryStruct *)userp;
-    char *ptr = realloc(mem->memory, mem->size + realsize + 1);
-    if (!ptr) {
-        printf("not enough memory (realloc returned NULL)\n");
-        return 0;
-    }
-    mem->memory = ptr;
-    memcpy(&(mem->memory[mem->size]), contents, realsize);
-    mem->size += realsize;
-    mem->memory[mem->size] = 0;
-    return realsize;
-}
-
-// libcurl callback to write downloaded file data to a FILE* handle
-size_t WriteFileCallback(void *ptr, size_t size, size_t nmemb, FILE *stream) {
-    return fwrite(ptr, size, nmemb, stream);
-}
+#include <dirent.h>
+#include <unistd.h>
+#include <fcntl.h>
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <linux/fs.h> // FICLONE
+#endif
 
 // Helper function to safely extract a string from a cJSON object.
 char* get_json_string(cJSON *json, const char *key) {
@@ -63,3 +49,106 @@ void ensure_dir_exists(const char *path) {
     }
     free(path_copy);
 }
+
+static bool remove_subdir_at(int dir_fd, const char *name);
+
+// Empties the directory open as fd, then closes it. Entries are addressed relative
+// to fd, so no path is rebuilt or resolved again at any depth.
+static bool remove_dir_contents(int fd) {
+    DIR *dir = fdopendir(fd);
+    if (!dir) {
+        close(fd);
+        return false;
+    }
+    bool ok = true;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        const char *name = entry->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) continue;
+        // d_type spares a failing unlinkat() per subdirectory where the filesystem reports it.
+        ok = (entry->d_type == DT_DIR ? remove_subdir_at(dirfd(dir), name) : remove_tree_at(dirfd(dir), name)) && ok;
+    }
+    closedir(dir);
+    return ok;
+}
+
+static bool remove_subdir_at(int dir_fd, const char *name) {
+    int fd = openat(dir_fd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+    if (fd < 0) return errno == ENOENT;
+    bool ok = remove_dir_contents(fd);
+    return (unlinkat(dir_fd, name, AT_REMOVEDIR) == 0 || errno == ENOENT) && ok;
+}
+
+bool remove_tree_at(int dir_fd, const char *name) {
+    // Most entries are files, removed with a single call.
+    if (unlinkat(dir_fd, name, 0) == 0 || errno == ENOENT) return true;
+    if (errno != EISDIR && errno != EPERM) return false; // EPERM is POSIX for directories
+    return remove_subdir_at(dir_fd, name);
+}
+
+bool remove_tree(const char *path) {
+    return remove_tree_at(AT_FDCWD, path);
+}
+
+// Shares src's extents with a new dst instead of copying them; fails where the
+// filesystem does not support it.
+static bool clone_file(const char *src, const char *dst) {
+#ifdef FICLONE
+    int in = open(src, O_RDONLY);
+    if (in < 0) return false;
+    int out = open(dst, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = out >= 0 && ioctl(out, FICLONE, in) == 0;
+    if (out >= 0 && close(out) != 0) ok = false;
+    close(in);
+    if (!ok && out >= 0) remove(dst);
+    return ok;
+#else
+    (void)src;
+    (void)dst;
+    return false;
+#endif
+}
+
+bool link_or_copy(const char *src, const char *dst) {
+    remove(dst);
+    return link(src, dst) == 0 || clone_or_copy(src, dst);
+}
+
+bool clone_or_copy(const char *src, const char *dst) {
+    remove(dst);
+    if (clone_file(src, dst)) return true;
+    FILE *in = fopen(src, "rb");
+    FILE *out = in ? fopen(dst, "wb") : NULL;
+    bool ok = out != NULL;
+    char buffer[16384];
+    size_t n;
+    while (ok && (n = fread(buffer, 1, sizeof(buffer), in)) > 0) ok = fwrite(buffer, 1, n, out) == n;
+    ok = ok && !ferror(in);
+    if (in) fclose(in);
+    if (out && fclose(out) != 0) ok = false;
+    if (!ok) remove(dst);
+    return ok;
+}
+
+bool write_file_atomic(const char *path, write_file_cb_t write, void *context) {
+    char tmp_path[1024];
+    if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)) return false;
+    ensure_dir_exists(path);
+    FILE *fp = fopen(tmp_path, "wb");
+    if (!fp) return false;
+    bool ok = write(fp, context) && !ferror(fp) && fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+    ok = fclose(fp) == 0 && ok;
+    if (!ok || rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return false;
+    }
+    return true;
+}
+
+int64_t stat_mtime_ns(const struct stat *st) {
+#ifdef __APPLE__
+    return (int64_t)st->st_mtimespec.tv_sec * 1000000000 + st->st_mtimespec.tv_nsec;
+#else
+    return (int64_t)st->st_mtim.tv_sec * 1000000000 + st->st_mtim.tv_nsec;
+#endif
+}
@@ -2,21 +2,12 @@
 #define UTILS_H
 
 #include <stdio.h>  // For FILE
+#include <stdbool.h>
 #include <stddef.h> // For size_t
+#include <stdint.h>
+#include <sys/stat.h>
 #include "cjson/cJSON.h" // For cJSON
 
-// Struct to help curl write data into a dynamically growing memory buffer
-struct MemoryStruct {
-    char *memory;
-    size_t size;
-};
-
-// libcurl callback function to write received data into our MemoryStruct
-size_t WriteMemoryCallback(void *contents, size_t size, size_t nmemb, void *userp);
-
-// libcurl callback to write downloaded file data to a FILE* handle
-size_t WriteFileCallback(void *ptr, size_t size, size_t nmemb, FILE *stream);
-
 // Helper function to safely extract a string from a cJSON object.
 char* get_json_string(cJSON *json, const char *key);
 
@@ -27,4 +18,57 @@ char* get_json_string(cJSON *json, const char *key);
  */
 void ensure_dir_exists(const char *path);
 
+/**
+ * @brief Recursively deletes a file or directory. Symbolic links are removed, not followed.
+ *
+ * @param path The file or directory to delete. A missing path counts as success.
+ * @return true if nothing is left at path.
+ */
+bool remove_tree(const char *path);
+
+/**
+ * @brief Like remove_tree(), for name relative to the directory open as dir_fd
+ * (or AT_FDCWD). The tree is walked with openat()/fdopendir()/unlinkat(), so
+ * each entry costs one system call on its name alone, however deep it is.
+ *
+ * @return true if nothing is left at name. Entries that vanish concurrently count as removed.
+ */
+bool remove_tree_at(int dir_fd, const char *name);
+
+/**
+ * @brief Gives dst the contents of src, replacing whatever is at dst.
+ *
+ * Tries a hard link first, then a reflink (on filesystems that share extents,
+ * such as btrfs and XFS), then falls back to copying the bytes. The parent
+ * directory of dst must exist.
+ *
+ * @return true if dst now holds the contents of src.
+ */
+bool link_or_copy(const char *src, const char *dst);
+
+/**
+ * @brief Like link_or_copy() without the hard link, so writes to dst never reach src.
+ */
+bool clone_or_copy(const char *src, const char *dst);
+
+// Writes the contents of a file for write_file_atomic(); returns false on failure.
+typedef bool (*write_file_cb_t)(FILE *fp, void *context);
+
+/**
+ * @brief Replaces the file at path with the contents write produces.
+ *
+ * The contents go to path.tmp, are flushed to disk and then renamed over path,
+ * so a crash leaves either the old file or the new one, never a mix. Missing
+ * parent directories are created.
+ *
+ * @return true if path now holds the new contents; on failure path is untouched.
+ */
+bool write_file_atomic(const char *path, write_file_cb_t write, void *context);
+
+/**
+ * @brief Returns a file's modification time in nanoseconds since the epoch, so a
+ * change within the same second as an earlier observation is still noticed.
+ */
+int64_t stat_mtime_ns(const struct stat *st);
+
 #endif // UTILS_H
@@ -0,0 +1,3 @@
+def main():
+    import leds
+    leds.set_all((255, 255, 255))
@@ -0,0 +1 @@
+from .snake import main
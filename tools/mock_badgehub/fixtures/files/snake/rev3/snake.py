@@ -0,0 +1,22 @@
+import random
+
+GRID = 24
+
+
+def step(body, direction, food):
+    head = ((body[0][0] + direction[0]) % GRID, (body[0][1] + direction[1]) % GRID)
+    if head in body:
+        return None, food
+    body.insert(0, head)
+    if head == food:
+        food = (random.randrange(GRID), random.randrange(GRID))
+    else:
+        body.pop()
+    return body, food
+
+
+def main():
+    body = [(GRID // 2, GRID // 2)]
+    food = (3, 3)
+    while body:
+        body, food = step(body, (1, 0), food)
@@ -0,0 +1 @@
+from .weather import main
@@ -0,0 +1,12 @@
+import json
+
+API = 'https://api.example.com/forecast'
+
+
+def parse(text):
+    data = json.loads(text)
+    return [(day['date'], day['min'], day['max']) for day in data['days'][:3]]
+
+
+def main():
+    print('Weather')
@@ -0,0 +1,335 @@
+#!/usr/bin/env python3
+"""Local stand-in for the BadgeHub API, for offline and reproducible testing.
+
+Serves the endpoints the client uses from recorded fixtures (see fixtures/README.md):
+
+    /api/v3/project-summaries?search=&pageLength=&pageStart=
+    /api/v3/projects/<slug>/rev<N>
+    /files/<slug>/rev<N>/<path>
+    /icons/<slug>.png
+
+File and icon URLs in the responses are rewritten to point at this server, and
+file hashes are taken from the fixture files themselves, so responses recorded
+from the real service can be dropped in unchanged. Files and icons support
+ETag, Range and If-Range, like the real service.
+
+Network conditions are simulated per response: a fixed latency plus jitter
+before the headers, a bandwidth limit on the body, a share of requests answered
+with 503 and a share cut off halfway through the body. Draws come from a seeded
+generator, so a run with the same seed and request order fails the same requests.
+
+    BADGEHUB_BASE_URL=http://127.0.0.1:8080/api/v3 ./badgehub_client
+
+The knobs can be changed while running, and request counters read, through
+/_mock/config (GET, or POST a JSON object with the fields to change) and
+/_mock/stats.
+"""
+import argparse
+import hashlib
+import json
+import os
+import random
+import struct
+import sys
+import threading
+import time
+import zlib
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, quote, unquote, urlsplit
+
+API_PREFIX = "/api/v3"
+CHUNK_SIZE = 16384
+
+
+class Config:
+    """Simulated network conditions, shared by all connections."""
+
+    FIELDS = ("latency_ms", "jitter_ms", "bandwidth_kib", "error_rate", "drop_rate")
+
+    def __init__(self, args):
+        self.latency_ms = args.latency_ms
+        self.jitter_ms = args.jitter_ms
+        self.bandwidth_kib = args.bandwidth_kib  # 0: unlimited
+        self.error_rate = args.error_rate
+        self.drop_rate = args.drop_rate
+        self.random = random.Random(args.seed)
+        self.lock = threading.Lock()
+        self.stats = {"requests": 0, "errors": 0, "drops": 0, "not_found": 0, "bytes_sent": 0}
+
+    def as_dict(self):
+        return {field: getattr(self, field) for field in self.FIELDS}
+
+    def update(self, values):
+        with self.lock:
+            for field in self.FIELDS:
+                if field in values:
+                    setattr(self, field, type(getattr(self, field))(values[field]))
+            if "seed" in values:
+                self.random.seed(values["seed"])
+
+    def draw(self):
+        """Returns (delay in seconds, fail with 503, drop halfway) for one response."""
+        with self.lock:
+            jitter = self.random.uniform(-self.jitter_ms, self.jitter_ms) if self.jitter_ms else 0
+            error = self.random.random() < self.error_rate
+            drop = self.random.random() < self.drop_rate
+        return max(0.0, self.latency_ms + jitter) / 1000.0, error, drop
+
+    def count(self, key, amount=1):
+        with self.lock:
+            self.stats[key] += amount
+
+
+class Catalog:
+    """Projects, their revisions, files and icons, held in memory."""
+
+    def __init__(self):
+        self.summaries = []  # /project-summaries entries, with "{origin}" placeholders
+        self.details = {}    # (slug, revision) -> details response
+        self.files = {}      # "/files/..." or "/icons/..." path -> bytes
+
+    def add_file(self, path, data):
+        self.files[path] = data
+
+    def finish(self):
+        """Points icon and file URLs at the server and fills in hashes and sizes."""
+        for summary in self.summaries:
+            icon = "/icons/%s.png" % summary["slug"]
+            if icon in self.files:
+                summary.setdefault("icon_map", {})["64x64"] = {"url": "{origin}" + icon, "size": len(self.files[icon])}
+        for (slug, revision), details in self.details.items():
+            for entry in details.get("version", {}).get("files", []):
+                path = "/files/%s/rev%d/%s" % (slug, revision, entry["full_path"])
+                if path in self.files:
+                    data = self.files[path]
+                    entry["url"] = "{origin}" + quote(path)
+                    entry["sha256"] = hashlib.sha256(data).hexdigest()
+                    entry["size_of_content"] = len(data)
+
+
+def load_fixtures(directory):
+    catalog = Catalog()
+    with open(os.path.join(directory, "project-summaries.json"), encoding="utf-8") as fp:
+        catalog.summaries = json.load(fp)
+    projects_dir = os.path.join(directory, "projects")
+    for slug in sorted(os.listdir(projects_dir)) if os.path.isdir(projects_dir) else []:
+        for name in os.listdir(os.path.join(projects_dir, slug)):
+            if name.startswith("rev") and name.endswith(".json"):
+                with open(os.path.join(projects_dir, slug, name), encoding="utf-8") as fp:
+                    catalog.details[(slug, int(name[3:-5]))] = json.load(fp)
+    for kind in ("files", "icons"):
+        root = os.path.join(directory, kind)
+        for parent, _, names in os.walk(root):
+            for name in names:
+                full = os.path.join(parent, name)
+                with open(full, "rb") as fp:
+                    catalog.add_file("/%s/%s" % (kind, os.path.relpath(full, root).replace(os.sep, "/")), fp.read())
+    catalog.finish()
+    return catalog
+
+
+def make_png(seed, size=64):
+    """A small solid-color RGBA PNG, different per seed."""
+    rng = random.Random(seed)
+    pixel = bytes([rng.randrange(256), rng.randrange(256), rng.randrange(256), 255])
+    raw = b"".join(b"\0" + pixel * size for _ in range(size))
+
+    def chunk(kind, data):
+        return struct.pack(">I", len(data)) + kind + data + struct.pack(">I", zlib.crc32(kind + data) & 0xFFFFFFFF)
+
+    header = struct.pack(">IIBBBBB", size, size, 8, 6, 0, 0, 0)
+    return b"\x89PNG\r\n\x1a\n" + chunk(b"IHDR", header) + chunk(b"IDAT", zlib.compress(raw)) + chunk(b"IEND", b"")
+
+
+def synthesize(count, files_per_project, file_size, seed):
+    """A catalog of count generated projects, for tests at a scale no recording has."""
+    catalog = Catalog()
+    rng = random.Random(seed)
+    for i in range(count):
+        slug = "project_%d" % i
+        revision = i % 17 + 1
+        name = "Project %d" % i
+        description = "A synthetic project number %d for testing the client offline" % i
+        catalog.summaries.append({
+            "name": name, "slug": slug, "description": description,
+            "project_url": "https://example.com/%s" % slug, "revision": revision,
+            "categories": ["Games" if i % 2 else "Utility"], "badges": ["why2025"],
+            "published_at": "2025-07-%02dT12:00:00.000Z" % (i % 28 + 1), "installs": i * 3,
+        })
+        files = []
+        for f in range(files_per_project):
+            full_path = "__init__.py" if f == 0 else "lib/module_%02d.py" % f
+            size = max(1, int(file_size * rng.uniform(0.5, 1.5)))
+            data = (("# %s %s\n" % (slug, full_path)).encode() * (size // 16 + 1))[:size]
+            catalog.add_file("/files/%s/rev%d/%s" % (slug, revision, full_path), data)
+            files.append({"full_path": full_path})
+        catalog.details[(slug, revision)] = {
+            "version": {
+                "app_metadata": {"name": name, "description": description, "author": "Mock Author", "version": "1.%d" % revision},
+                "files": files,
+                "published_at": "2025-07-%02dT12:00:00.000Z" % (i % 28 + 1),
+            }
+        }
+        catalog.add_file("/icons/%s.png" % slug, make_png(i))
+    catalog.finish()
+    return catalog
+
+
+def with_origin(value, origin):
+    return json.dumps(value, separators=(",", ":")).replace("{origin}", origin).encode()
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    server_version = "MockBadgeHub/1"
+
+    def log_message(self, fmt, *args):
+        if self.server.verbose:
+            sys.stderr.write("%s - %s\n" % (self.address_string(), fmt % args))
+
+    @property
+    def origin(self):
+        return "http://%s" % (self.headers.get("Host") or "%s:%d" % self.server.server_address[:2])
+
+    def do_GET(self):
+        url = urlsplit(self.path)
+        path = unquote(url.path)
+        config = self.server.config
+        if path == "/_mock/config":
+            return self.send_body(200, json.dumps(config.as_dict()).encode(), "application/json")
+        if path == "/_mock/stats":
+            return self.send_body(200, json.dumps(config.stats).encode(), "application/json")
+
+        config.count("requests")
+        delay, error, drop = config.draw()
+        if delay:
+            time.sleep(delay)
+        if error:
+            config.count("errors")
+            return self.send_body(503, b'{"error":"injected failure"}', "application/json")
+
+        catalog = self.server.catalog
+        if path == API_PREFIX + "/project-summaries":
+            return self.send_summaries(parse_qs(url.query), drop)
+        if path.startswith(API_PREFIX + "/projects/"):
+            parts = path[len(API_PREFIX + "/projects/"):].split("/")
+            details = None
+            if len(parts) == 2 and parts[1].startswith("rev") and parts[1][3:].isdigit():
+                details = catalog.details.get((parts[0], int(parts[1][3:])))
+            if details is not None:
+                return self.send_body(200, with_origin(details, self.origin), "application/json", drop=drop)
+        elif path in catalog.files:
+            return self.send_file(catalog.files[path], drop)
+        config.count("not_found")
+        self.send_body(404, b'{"error":"not found"}', "application/json")
+
+    def do_POST(self):
+        if urlsplit(self.path).path != "/_mock/config":
+            return self.send_body(404, b"", "text/plain")
+        length = int(self.headers.get("Content-Length") or 0)
+        try:
+            self.server.config.update(json.loads(self.rfile.read(length) or b"{}"))
+        except (ValueError, TypeError) as error:
+            return self.send_body(400, str(error).encode(), "text/plain")
+        self.send_body(200, json.dumps(self.server.config.as_dict()).encode(), "application/json")
+
+    def send_summaries(self, query, drop):
+        summaries = self.server.catalog.summaries
+        search = (query.get("search") or [""])[0].lower()
+        if search:
+            summaries = [s for s in summaries
+                         if search in s.get("name", "").lower() or search in s.get("slug", "").lower()
+                         or search in (s.get("description") or "").lower()]
+        start = int((query.get("pageStart") or ["0"])[0])
+        length = int((query.get("pageLength") or [str(len(summaries))])[0])
+        self.send_body(200, with_origin(summaries[start:start + length], self.origin), "application/json", drop=drop)
+
+    def send_file(self, data, drop):
+        etag = '"%s"' % hashlib.sha256(data).hexdigest()[:32]
+        content_type = "image/png" if self.path.endswith(".png") else "application/octet-stream"
+        if self.headers.get("If-None-Match") == etag:
+            return self.send_body(304, b"", content_type, headers={"ETag": etag})
+        start = 0
+        range_header = self.headers.get("Range", "")
+        if_range = self.headers.get("If-Range")
+        if range_header.startswith("bytes=") and (if_range is None or if_range == etag):
+            first = range_header[6:].split("-")[0]
+            start = int(first) if first.isdigit() else 0
+            if start >= len(data):
+                return self.send_body(416, b"", content_type, headers={"Content-Range": "bytes */%d" % len(data)})
+        headers = {"ETag": etag, "Accept-Ranges": "bytes"}
+        if start:
+            headers["Content-Range"] = "bytes %d-%d/%d" % (start, len(data) - 1, len(data))
+        self.send_body(206 if start else 200, data[start:], content_type, headers=headers, drop=drop)
+
+    def send_body(self, status, body, content_type, headers=None, drop=False):
+        self.send_response(status)
+        self.send_header("Content-Type", content_type)
+        self.send_header("Content-Length", str(len(body)))
+        for name, value in (headers or {}).items():
+            self.send_header(name, value)
+        self.end_headers()
+        if drop and len(body) > 1:
+            self.server.config.count("drops")
+            body = body[:len(body) // 2]
+            self.close_connection = True
+        config = self.server.config
+        rate = config.bandwidth_kib * 1024.0
+        # Throttled bodies go out in slices of about 50 ms each, every slice no
+        # earlier than the limit allows.
+        chunk_size = min(CHUNK_SIZE, max(256, int(rate / 20))) if rate > 0 else CHUNK_SIZE
+        started = time.monotonic()
+        sent = 0
+        try:
+            for offset in range(0, len(body), chunk_size):
+                chunk = body[offset:offset + chunk_size]
+                if rate > 0:
+                    due = (sent + len(chunk)) / rate - (time.monotonic() - started)
+                    if due > 0:
+                        time.sleep(due)
+                self.wfile.write(chunk)
+                self.wfile.flush()
+                sent += len(chunk)
+        except (BrokenPipeError, ConnectionResetError):
+            self.close_connection = True
+        config.count("bytes_sent", sent)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--fixtures", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "fixtures"),
+                        help="directory of recorded responses (default: the bundled set)")
+    parser.add_argument("--synthetic", type=int, metavar="N", default=0,
+                        help="serve N generated projects instead of the fixtures")
+    parser.add_argument("--synthetic-files", type=int, default=5, help="files per generated project")
+    parser.add_argument("--synthetic-file-size", type=int, default=4096, help="average generated file size in bytes")
+    parser.add_argument("--latency-ms", type=float, default=0.0, help="delay before each response")
+    parser.add_argument("--jitter-ms", type=float, default=0.0, help="random +/- variation of the delay")
+    parser.add_argument("--bandwidth-kib", type=float, default=0.0, help="per-connection KiB/s, 0 for unlimited")
+    parser.add_argument("--error-rate", type=float, default=0.0, help="share of requests answered with 503")
+    parser.add_argument("--drop-rate", type=float, default=0.0, help="share of responses cut off halfway")
+    parser.add_argument("--seed", type=int, default=1, help="seed for jitter, errors and drops")
+    parser.add_argument("--verbose", action="store_true", help="log every request")
+    args = parser.parse_args()
+
+    if args.synthetic > 0:
+        catalog = synthesize(args.synthetic, args.synthetic_files, args.synthetic_file_size, args.seed)
+    else:
+        catalog = load_fixtures(args.fixtures)
+    server = ThreadingHTTPServer((args.host, args.port), Handler)
+    server.daemon_threads = True
+    server.catalog = catalog
+    server.config = Config(args)
+    server.verbose = args.verbose
+    print("Serving %d projects at http://%s:%d%s" % (len(catalog.summaries), args.host, server.server_address[1], API_PREFIX),
+          flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()